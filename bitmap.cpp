@@ -0,0 +1,363 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include "bitmap.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define QBM_REDIS_BITMAP_AVX2 1
+#endif
+
+namespace {
+
+using qb::redis::BitOp;
+
+/*
+ * Scalar kernels
+ */
+
+inline std::uint64_t
+load64(const std::uint8_t *p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void
+store64(std::uint8_t *p, std::uint64_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline unsigned
+popcount64(std::uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(v));
+#else
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<unsigned>((v * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+std::uint64_t
+popcount_scalar(const std::uint8_t *p, std::size_t n) {
+    std::uint64_t total = 0;
+    std::size_t   i     = 0;
+    for (; i + 8 <= n; i += 8)
+        total += popcount64(load64(p + i));
+    for (; i < n; ++i)
+        total += popcount64(p[i]);
+    return total;
+}
+
+void
+combine_scalar(BitOp op, std::uint8_t *dst, const std::uint8_t *src, std::size_t n) {
+    std::size_t i = 0;
+    switch (op) {
+        case BitOp::AND:
+            for (; i + 8 <= n; i += 8)
+                store64(dst + i, load64(dst + i) & load64(src + i));
+            for (; i < n; ++i)
+                dst[i] &= src[i];
+            break;
+        case BitOp::OR:
+            for (; i + 8 <= n; i += 8)
+                store64(dst + i, load64(dst + i) | load64(src + i));
+            for (; i < n; ++i)
+                dst[i] |= src[i];
+            break;
+        case BitOp::XOR:
+            for (; i + 8 <= n; i += 8)
+                store64(dst + i, load64(dst + i) ^ load64(src + i));
+            for (; i < n; ++i)
+                dst[i] ^= src[i];
+            break;
+        case BitOp::NOT:
+            for (; i + 8 <= n; i += 8)
+                store64(dst + i, ~load64(src + i));
+            for (; i < n; ++i)
+                dst[i] = static_cast<std::uint8_t>(~src[i]);
+            break;
+    }
+}
+
+/// Index of the first byte different from skip, n if none
+std::size_t
+find_scalar(const std::uint8_t *p, std::size_t n, std::uint8_t skip) {
+    const std::uint64_t word = 0x0101010101010101ULL * skip;
+    std::size_t         i    = 0;
+    for (; i + 8 <= n && load64(p + i) == word; i += 8)
+        ;
+    for (; i < n && p[i] == skip; ++i)
+        ;
+    return i;
+}
+
+/*
+ * AVX2 kernels
+ */
+
+#ifdef QBM_REDIS_BITMAP_AVX2
+
+/// Nibble lookup popcount (Mula), bytes sums folded with SAD every iteration
+__attribute__((target("avx2"))) std::uint64_t
+popcount_avx2(const std::uint8_t *p, std::size_t n) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i       acc      = _mm256_setzero_si256();
+
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        __m256i lo  = _mm256_and_si256(v, low_mask);
+        __m256i hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                      _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+
+    std::uint64_t total = static_cast<std::uint64_t>(_mm256_extract_epi64(acc, 0)) +
+                          static_cast<std::uint64_t>(_mm256_extract_epi64(acc, 1)) +
+                          static_cast<std::uint64_t>(_mm256_extract_epi64(acc, 2)) +
+                          static_cast<std::uint64_t>(_mm256_extract_epi64(acc, 3));
+    return total + popcount_scalar(p + i, n - i);
+}
+
+__attribute__((target("avx2"))) void
+combine_avx2(BitOp op, std::uint8_t *dst, const std::uint8_t *src, std::size_t n) {
+    const __m256i ones = _mm256_set1_epi8(-1);
+
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto   *d = reinterpret_cast<__m256i *>(dst + i);
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        __m256i r;
+        switch (op) {
+            case BitOp::AND:
+                r = _mm256_and_si256(_mm256_loadu_si256(d), s);
+                break;
+            case BitOp::OR:
+                r = _mm256_or_si256(_mm256_loadu_si256(d), s);
+                break;
+            case BitOp::XOR:
+                r = _mm256_xor_si256(_mm256_loadu_si256(d), s);
+                break;
+            default:
+                r = _mm256_xor_si256(s, ones);
+                break;
+        }
+        _mm256_storeu_si256(d, r);
+    }
+    combine_scalar(op, dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) std::size_t
+find_avx2(const std::uint8_t *p, std::size_t n, std::uint8_t skip) {
+    const __m256i pattern = _mm256_set1_epi8(static_cast<char>(skip));
+
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i  v    = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, pattern)));
+        if (mask != 0xFFFFFFFFu)
+            return i + static_cast<std::size_t>(__builtin_ctz(~mask));
+    }
+    return i + find_scalar(p + i, n - i, skip);
+}
+
+const bool has_avx2 = __builtin_cpu_supports("avx2");
+
+#endif
+
+std::uint64_t
+popcount(const std::uint8_t *p, std::size_t n) {
+#ifdef QBM_REDIS_BITMAP_AVX2
+    if (has_avx2)
+        return popcount_avx2(p, n);
+#endif
+    return popcount_scalar(p, n);
+}
+
+void
+combine(BitOp op, std::uint8_t *dst, const std::uint8_t *src, std::size_t n) {
+#ifdef QBM_REDIS_BITMAP_AVX2
+    if (has_avx2)
+        return combine_avx2(op, dst, src, n);
+#endif
+    combine_scalar(op, dst, src, n);
+}
+
+std::size_t
+find(const std::uint8_t *p, std::size_t n, std::uint8_t skip) {
+#ifdef QBM_REDIS_BITMAP_AVX2
+    if (has_avx2)
+        return find_avx2(p, n, skip);
+#endif
+    return find_scalar(p, n, skip);
+}
+
+/**
+ * @brief Runs fn(begin, end, slice) over [0, n) split in slices of at least
+ * parallel_threshold bytes, one thread per slice
+ * @return Number of slices
+ */
+template <typename Fn>
+std::size_t
+parallel_for(std::size_t n, Fn &&fn) {
+    std::size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, n / qb::redis::bitmap::parallel_threshold);
+    if (workers <= 1) {
+        fn(std::size_t(0), n, std::size_t(0));
+        return 1;
+    }
+
+    // Slices aligned on 64 bytes so that vector loads do not straddle them
+    std::size_t slice = ((n + workers - 1) / workers + 63) & ~std::size_t(63);
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t w = 1; w < workers; ++w) {
+        std::size_t begin = std::min(n, w * slice);
+        std::size_t end   = std::min(n, begin + slice);
+        threads.emplace_back([&fn, begin, end, w] { fn(begin, end, w); });
+    }
+    fn(std::size_t(0), std::min(n, slice), std::size_t(0));
+    for (auto &t : threads)
+        t.join();
+    return workers;
+}
+
+/**
+ * @brief Normalizes a BITCOUNT/BITPOS byte range
+ * @return false if the range is empty
+ */
+bool
+clamp_range(long long size, long long &start, long long &end) {
+    if (start < 0)
+        start += size;
+    if (end < 0)
+        end += size;
+    start = std::max(start, 0LL);
+    end   = std::max(end, 0LL);
+    end   = std::min(end, size - 1);
+    return size > 0 && start <= end;
+}
+
+} // namespace
+
+namespace qb::redis {
+
+std::uint64_t
+bitmap::count(long long start, long long end) const {
+    if (!clamp_range(static_cast<long long>(size()), start, end))
+        return 0;
+
+    auto                       *p = data() + start;
+    std::vector<std::uint64_t> partial(std::max(1u, std::thread::hardware_concurrency()));
+    auto slices = parallel_for(static_cast<std::size_t>(end - start + 1),
+                               [&](std::size_t b, std::size_t e, std::size_t w) {
+                                   partial[w] = popcount(p + b, e - b);
+                               });
+    std::uint64_t total = 0;
+    for (std::size_t w = 0; w < slices; ++w)
+        total += partial[w];
+    return total;
+}
+
+long long
+bitmap::pos(bool bit) const {
+    return pos(bit, 0, -1, false);
+}
+
+long long
+bitmap::pos(bool bit, long long start, long long end) const {
+    return pos(bit, start, end, true);
+}
+
+long long
+bitmap::pos(bool bit, long long start, long long end, bool end_given) const {
+    // A missing key is an empty string full of zeros
+    if (empty())
+        return bit ? -1 : 0;
+    if (!clamp_range(static_cast<long long>(size()), start, end))
+        return -1;
+
+    const std::uint8_t skip  = bit ? 0x00 : 0xFF;
+    auto              *p     = data() + start;
+    std::size_t        bytes = static_cast<std::size_t>(end - start + 1);
+
+    std::vector<std::size_t> found(std::max(1u, std::thread::hardware_concurrency()),
+                                   bytes);
+    auto slices = parallel_for(bytes, [&](std::size_t b, std::size_t e, std::size_t w) {
+        auto i   = b + find(p + b, e - b, skip);
+        found[w] = i < e ? i : bytes;
+    });
+    auto byte = *std::min_element(found.begin(), found.begin() + slices);
+
+    if (byte == bytes)
+        return bit || end_given ? -1 : (start + static_cast<long long>(bytes)) * 8;
+
+    unsigned value = bit ? p[byte] : static_cast<std::uint8_t>(~p[byte]);
+    int      shift = 7;
+    while (!((value >> shift) & 1))
+        --shift;
+    return (start + static_cast<long long>(byte)) * 8 + (7 - shift);
+}
+
+bitmap
+bitmap::bitop(BitOp op, const std::vector<const bitmap *> &sources) {
+    if (op == BitOp::NOT && sources.size() != 1)
+        throw std::invalid_argument("BITOP NOT takes a single source");
+
+    std::size_t length = 0;
+    for (auto *src : sources)
+        length = std::max(length, src->size());
+
+    bitmap result;
+    if (sources.empty() || !length)
+        return result;
+
+    if (op == BitOp::NOT) {
+        result.resize(length);
+        parallel_for(length, [&](std::size_t b, std::size_t e, std::size_t) {
+            combine(BitOp::NOT, result.data() + b, sources[0]->data() + b, e - b);
+        });
+        return result;
+    }
+
+    result._bytes.assign(sources[0]->_bytes.begin(), sources[0]->_bytes.end());
+    result.resize(length);
+    parallel_for(length, [&](std::size_t b, std::size_t e, std::size_t) {
+        for (std::size_t s = 1; s < sources.size(); ++s) {
+            auto *src = sources[s];
+            // Bytes past the end of a source are zeros
+            std::size_t avail = src->size() > b ? std::min(e, src->size()) - b : 0;
+            combine(op, result.data() + b, src->data() + b, avail);
+            if (op == BitOp::AND && avail < e - b)
+                std::memset(result.data() + b + avail, 0, e - b - avail);
+        }
+    });
+    return result;
+}
+
+} // namespace qb::redis
@@ -0,0 +1,167 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_BITMAP_H
+#define QBM_REDIS_BITMAP_H
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "reply.h"
+
+namespace qb::redis {
+
+/**
+ * @class bitmap
+ * @brief Local copy of a Redis bitmap with server compatible operations
+ *
+ * Bits are numbered as Redis does: bit 0 is the most significant bit of the
+ * first byte. count(), pos() and bitop() follow BITCOUNT, BITPOS and BITOP
+ * semantics but run client side, with AVX2 kernels when the CPU supports them,
+ * and split across threads for bitmaps larger than parallel_threshold bytes.
+ */
+class bitmap {
+    std::vector<std::uint8_t> _bytes;
+
+public:
+    /// Bytes per thread below which operations run on the calling thread
+    static constexpr std::size_t parallel_threshold = std::size_t(1) << 20;
+
+    bitmap() = default;
+
+    /**
+     * @brief Constructs a zeroed bitmap
+     * @param bytes Size in bytes
+     */
+    explicit bitmap(std::size_t bytes)
+        : _bytes(bytes) {}
+
+    /**
+     * @brief Constructs a bitmap from a Redis string value
+     * @param value Raw value, as returned by GET
+     */
+    explicit bitmap(std::string_view value)
+        : _bytes(value.begin(), value.end()) {}
+
+    [[nodiscard]] std::size_t
+    size() const {
+        return _bytes.size();
+    }
+
+    [[nodiscard]] bool
+    empty() const {
+        return _bytes.empty();
+    }
+
+    void
+    resize(std::size_t bytes) {
+        _bytes.resize(bytes);
+    }
+
+    [[nodiscard]] std::uint8_t *
+    data() {
+        return _bytes.data();
+    }
+
+    [[nodiscard]] const std::uint8_t *
+    data() const {
+        return _bytes.data();
+    }
+
+    /**
+     * @brief Gets the raw value, to store with SET
+     * @return View on the bitmap bytes
+     */
+    [[nodiscard]] std::string_view
+    view() const {
+        return {reinterpret_cast<const char *>(_bytes.data()), _bytes.size()};
+    }
+
+    /**
+     * @brief Gets a bit, as GETBIT does
+     * @param offset Bit offset
+     * @return Bit value, false beyond the end
+     */
+    [[nodiscard]] bool
+    get(std::size_t offset) const {
+        auto byte = offset >> 3;
+        return byte < _bytes.size() && (_bytes[byte] >> (7 - (offset & 7))) & 1;
+    }
+
+    /**
+     * @brief Sets a bit, as SETBIT does, growing the bitmap if needed
+     * @param offset Bit offset
+     * @param value Bit value
+     */
+    void
+    set(std::size_t offset, bool value) {
+        auto byte = offset >> 3;
+        if (byte >= _bytes.size())
+            _bytes.resize(byte + 1);
+        auto mask = static_cast<std::uint8_t>(1 << (7 - (offset & 7)));
+        _bytes[byte] = value ? (_bytes[byte] | mask) : (_bytes[byte] & ~mask);
+    }
+
+    /**
+     * @brief Counts the set bits in a byte range, as BITCOUNT does
+     * @param start First byte, negative values count from the end
+     * @param end Last byte (inclusive), negative values count from the end
+     * @return Number of bits set to 1
+     */
+    [[nodiscard]] std::uint64_t count(long long start = 0, long long end = -1) const;
+
+    /**
+     * @brief Finds the first bit set or cleared, as BITPOS does without range
+     * @param bit Bit value to search for
+     * @return Bit position, -1 if bit is 1 and none is set, the bit after the
+     * last byte if bit is 0 and all are set
+     */
+    [[nodiscard]] long long pos(bool bit) const;
+
+    /**
+     * @brief Finds the first bit set or cleared in a byte range, as BITPOS does
+     * @param bit Bit value to search for
+     * @param start First byte, negative values count from the end
+     * @param end Last byte (inclusive), negative values count from the end
+     * @return Bit position, -1 if not found
+     */
+    [[nodiscard]] long long pos(bool bit, long long start, long long end) const;
+
+    /**
+     * @brief Combines bitmaps, as BITOP does
+     *
+     * Shorter sources are zero padded to the longest one. NOT takes a single
+     * source.
+     *
+     * @param op Bitwise operation
+     * @param sources Bitmaps to combine
+     * @return The resulting bitmap
+     * @throws std::invalid_argument if NOT is given more than one source
+     */
+    static bitmap bitop(BitOp op, const std::vector<const bitmap *> &sources);
+
+    bool
+    operator==(const bitmap &other) const {
+        return _bytes == other._bytes;
+    }
+
+private:
+    long long pos(bool bit, long long start, long long end, bool end_given) const;
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_BITMAP_H
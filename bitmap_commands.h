@@ -18,6 +18,9 @@
 #ifndef QBM_REDIS_BITMAP_COMMANDS_H
 #define QBM_REDIS_BITMAP_COMMANDS_H
 
+#include <algorithm>
+#include <cstring>
+#include "bitmap.h"
 #include "reply.h"
 
 namespace qb::redis {
@@ -135,6 +138,55 @@ public:
             std::forward<Func>(func), "BITFIELD", key, operations);
     }
 
+    /**
+     * @brief Performs typed bitfield operations in a single command.
+     *
+     * Operations are encoded straight into the command pipe. A list of GET
+     * operations only is sent as BITFIELD_RO, which is allowed on replicas.
+     *
+     * @param key The key storing the string value
+     * @param ops Operations to perform
+     * @return One result per GET, SET and INCRBY, nullopt when an operation
+     * failed with OVERFLOW FAIL
+     * @note Time complexity: O(1) for each operation
+     * @see https://redis.io/commands/bitfield
+     * @see https://redis.io/commands/bitfield_ro
+     */
+    std::vector<std::optional<long long>>
+    bitfield(const std::string &key, const bitfield_ops &ops) {
+        if (ops.empty()) {
+            return {};
+        }
+        return derived()
+            .template command<std::vector<std::optional<long long>>>(
+                ops.read_only() ? "BITFIELD_RO" : "BITFIELD", key, ops)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of the typed BITFIELD command.
+     *
+     * @param func Callback function to handle the result
+     * @param key The key storing the string value
+     * @param ops Operations to perform
+     * @return Reference to the derived class
+     * @see https://redis.io/commands/bitfield
+     */
+    template <typename Func>
+    std::enable_if_t<
+        std::is_invocable_v<Func, Reply<std::vector<std::optional<long long>>> &&>,
+        Derived &>
+    bitfield(Func &&func, const std::string &key, const bitfield_ops &ops) {
+        if (ops.empty()) {
+            std::forward<Func>(func)(
+                Reply<std::vector<std::optional<long long>>>{true, {}, {}, {}});
+            return derived();
+        }
+        return derived().template command<std::vector<std::optional<long long>>>(
+            std::forward<Func>(func), ops.read_only() ? "BITFIELD_RO" : "BITFIELD", key,
+            ops);
+    }
+
     /**
      * @brief Perform bitwise operations between strings.
      *
@@ -299,6 +351,116 @@ public:
         return derived().template command<long long>(
             std::forward<Func>(func), "SETBIT", key, offset, static_cast<int>(value));
     }
+
+    /**
+     * @brief Fetches a bitmap key for local analytics
+     *
+     * With chunk_size 0 the value is read with a single GET, copied straight
+     * from the reply buffer. Otherwise its length is read with STRLEN and the
+     * value is fetched with pipelined GETRANGE commands of chunk_size bytes,
+     * so that the server never serializes a huge reply at once. A value
+     * modified between the STRLEN and the GETRANGE replies may be torn.
+     *
+     * @param key The key storing the bitmap
+     * @param chunk_size Bytes per GETRANGE, 0 for a single GET
+     * @return The bitmap, empty if the key does not exist
+     * @throws std::runtime_error if the key is not a string
+     * @see bitmap
+     */
+    bitmap
+    bitmap_get(const std::string &key, std::size_t chunk_size = 0) {
+        Reply<bitmap> value{};
+        bitmap_get([&value](auto &&reply) { value = std::move(reply); }, key,
+                   chunk_size);
+        derived().await();
+
+        if (!value.ok())
+            throw std::runtime_error(std::string(value.error()));
+        return std::move(value.result());
+    }
+
+    /**
+     * @brief Asynchronous version of bitmap_get
+     *
+     * @param func Callback function to handle the result
+     * @param key The key storing the bitmap
+     * @param chunk_size Bytes per GETRANGE, 0 for a single GET
+     * @return Reference to the derived class
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<bitmap> &&>, Derived &>
+    bitmap_get(Func &&func, const std::string &key, std::size_t chunk_size = 0) {
+        if (!chunk_size) {
+            return derived().template command<std::optional<std::string_view>>(
+                [func = std::forward<Func>(func)](auto &&reply) mutable {
+                    Reply<bitmap> value{reply.ok(), {}, std::move(reply.raw()),
+                                        reply.error()};
+                    if (value.ok() && reply.result())
+                        value.result() = bitmap(*reply.result());
+                    std::move(func)(std::move(value));
+                },
+                "GET", key);
+        }
+
+        return derived().template command<long long>(
+            [this, key, chunk_size,
+             func = std::forward<Func>(func)](auto &&reply) mutable {
+                if (!reply.ok() || !reply.result()) {
+                    std::move(func)(Reply<bitmap>{reply.ok(), {}, std::move(reply.raw()),
+                                                  reply.error()});
+                    return;
+                }
+
+                auto length = static_cast<std::size_t>(reply.result());
+                auto state  = make_fan_in<bitmap>(std::move(func), bitmap(length));
+                state->hold((length + chunk_size - 1) / chunk_size);
+
+                for (std::size_t off = 0; off < length; off += chunk_size) {
+                    derived().template command<std::string_view>(
+                        [state, off](auto &&chunk) {
+                            auto &value = state->reply;
+                            if (!state->failed(chunk) && value.ok()) {
+                                auto size = std::min(chunk.result().size(),
+                                                     value.result().size() - off);
+                                std::memcpy(value.result().data() + off,
+                                            chunk.result().data(), size);
+                            }
+                            state->done();
+                        },
+                        "GETRANGE", key, off, off + chunk_size - 1);
+                }
+                state->done();
+            },
+            "STRLEN", key);
+    }
+
+    /**
+     * @brief Stores a local bitmap, e.g. the result of bitmap::bitop
+     *
+     * @param key The key to store the bitmap in
+     * @param value The bitmap to store
+     * @return status object with the result
+     * @see https://redis.io/commands/set
+     */
+    status
+    bitmap_set(const std::string &key, const bitmap &value) {
+        return derived().template command<status>("SET", key, value.view()).result();
+    }
+
+    /**
+     * @brief Asynchronous version of bitmap_set
+     *
+     * @param func Callback function to handle the result
+     * @param key The key to store the bitmap in
+     * @param value The bitmap to store
+     * @return Reference to the derived class
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<status> &&>, Derived &>
+    bitmap_set(Func &&func, const std::string &key, const bitmap &value) {
+        return derived().template command<status>(std::forward<Func>(func), "SET", key,
+                                                  value.view());
+    }
 };
 
 } // namespace qb::redis
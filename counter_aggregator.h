@@ -0,0 +1,353 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_COUNTER_AGGREGATOR_H
+#define QBM_REDIS_COUNTER_AGGREGATOR_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "redis.h"
+
+namespace qb::redis {
+
+/**
+ * @class counter_aggregator
+ * @brief Write-behind aggregation of INCRBY, HINCRBY and ZINCRBY
+ *
+ * Increments are summed locally per key, field or member, and sent as one
+ * pipelined batch by flush(). A million increments of the same counter thus
+ * cost a single command.
+ *
+ * The increment methods can be called from any thread: the deltas are kept in
+ * shards, each guarded by a spinlock held only for a map update. flush(), poll()
+ * and start() use the client and must run on its event loop thread.
+ *
+ * Deltas not flushed yet are lost if the process dies, which bounds the loss
+ * to the flush interval. Call flush() before shutting down.
+ *
+ * @tparam QB_IO_ The QB I/O type of the client
+ */
+template <typename QB_IO_>
+class counter_aggregator {
+public:
+    using client_type = detail::Redis<QB_IO_>;
+    using clock       = std::chrono::steady_clock;
+
+    /**
+     * @struct options
+     * @brief Flush policy of an aggregator
+     */
+    struct options {
+        std::chrono::milliseconds interval{100};   ///< Max delay before a delta is sent
+        std::chrono::milliseconds tick{10};        ///< Timer period of start()
+        std::size_t               max_entries = 10000; ///< Entries triggering a flush
+        std::size_t               shards      = 16;    ///< Independently locked maps
+    };
+
+    /**
+     * @struct statistics
+     * @brief Flush metrics, updated on the client thread
+     */
+    struct statistics {
+        std::uint64_t             flushes    = 0; ///< Completed non-empty flushes
+        std::uint64_t             commands   = 0; ///< Commands sent
+        std::uint64_t             errors     = 0; ///< Failed commands, deltas lost
+        std::size_t               last_batch = 0; ///< Commands of the last flush
+        std::size_t               max_batch  = 0; ///< Largest flush
+        std::chrono::microseconds last_latency{0}; ///< Send to last reply
+        std::chrono::microseconds max_latency{0};  ///< Slowest flush
+    };
+
+private:
+    template <typename T>
+    using field_map = qb::unordered_map<std::string, T>;
+
+    struct shard {
+        std::atomic_flag                lock = ATOMIC_FLAG_INIT;
+        field_map<long long>            counters;
+        field_map<field_map<long long>> hashes;
+        field_map<field_map<double>>    sorted_sets;
+    };
+
+    /**
+     * @brief Holds the spinlock of a shard
+     */
+    class shard_lock {
+        std::atomic_flag &_lock;
+
+    public:
+        explicit shard_lock(shard &s)
+            : _lock(s.lock) {
+            while (_lock.test_and_set(std::memory_order_acquire))
+                ;
+        }
+        ~shard_lock() {
+            _lock.clear(std::memory_order_release);
+        }
+    };
+
+    client_type             &_redis;
+    options                  _opts;
+    std::unique_ptr<shard[]> _shards;
+    std::atomic<std::size_t> _entries{0};
+    clock::time_point        _last_flush = clock::now();
+    statistics               _stats;
+    std::shared_ptr<bool>    _timer;
+
+    shard &
+    shard_of(std::string_view key) {
+        return _shards[std::hash<std::string_view>{}(key) % _opts.shards];
+    }
+
+    template <typename T, typename V>
+    void
+    add(field_map<T> &map, const std::string &key, V delta) {
+        auto [it, inserted] = map.try_emplace(key, V{});
+        it->second += delta;
+        if (inserted)
+            _entries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    /**
+     * @brief Constructs an aggregator
+     * @param redis Client used to send the batches
+     * @param opts Flush policy
+     */
+    explicit counter_aggregator(client_type &redis, options opts = {})
+        : _redis(redis)
+        , _opts(opts) {
+        if (!_opts.shards)
+            throw std::invalid_argument("counter_aggregator: shards must be positive");
+        _shards = std::make_unique<shard[]>(_opts.shards);
+    }
+
+    counter_aggregator(const counter_aggregator &) = delete;
+    counter_aggregator &operator=(const counter_aggregator &) = delete;
+
+    ~counter_aggregator() {
+        stop();
+    }
+
+    /**
+     * @brief Adds one to the counter at key
+     * @param key Key of the counter
+     */
+    void
+    incr(const std::string &key) {
+        incrby(key, 1);
+    }
+
+    /**
+     * @brief Adds a delta to the counter at key
+     * @param key Key of the counter
+     * @param delta Increment, negative to decrement
+     */
+    void
+    incrby(const std::string &key, long long delta) {
+        auto      &s = shard_of(key);
+        shard_lock lock{s};
+        add(s.counters, key, delta);
+    }
+
+    /**
+     * @brief Adds a delta to a field of the hash at key
+     * @param key Key of the hash
+     * @param field Field of the counter
+     * @param delta Increment, negative to decrement
+     */
+    void
+    hincrby(const std::string &key, const std::string &field, long long delta) {
+        auto      &s = shard_of(key);
+        shard_lock lock{s};
+        add(s.hashes[key], field, delta);
+    }
+
+    /**
+     * @brief Adds a delta to the score of a member of the sorted set at key
+     * @param key Key of the sorted set
+     * @param member Member whose score is incremented
+     * @param delta Increment, negative to decrement
+     */
+    void
+    zincrby(const std::string &key, const std::string &member, double delta) {
+        auto      &s = shard_of(key);
+        shard_lock lock{s};
+        add(s.sorted_sets[key], member, delta);
+    }
+
+    /**
+     * @brief Gets the number of keys, fields and members not flushed yet
+     */
+    [[nodiscard]] std::size_t
+    size() const {
+        return _entries.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Checks whether the size threshold or the interval is reached
+     */
+    [[nodiscard]] bool
+    due() const {
+        const auto entries = size();
+        return entries >= _opts.max_entries ||
+               (entries && clock::now() - _last_flush >= _opts.interval);
+    }
+
+    /**
+     * @brief Gets the flush metrics
+     */
+    [[nodiscard]] const statistics &
+    stats() const {
+        return _stats;
+    }
+
+    /**
+     * @brief Flushes the pending deltas if due()
+     * @return true if a flush was started
+     */
+    bool
+    poll() {
+        if (!due())
+            return false;
+        flush(no_check);
+        return true;
+    }
+
+    /**
+     * @brief Starts a timer calling poll() every tick
+     */
+    void
+    start() {
+        stop();
+        _timer = std::make_shared<bool>(true);
+        call_every(_timer, std::chrono::duration<double>(_opts.tick).count(),
+                   [this]() { poll(); });
+    }
+
+    /**
+     * @brief Stops the timer started by start()
+     */
+    void
+    stop() {
+        if (_timer) {
+            *_timer = false;
+            _timer.reset();
+        }
+    }
+
+    /**
+     * @brief Flushes the pending deltas and waits for the replies
+     * @return Number of commands sent
+     */
+    long long
+    flush() {
+        return sync_result<long long>([this](auto &&func) { flush(func); });
+    }
+
+    /**
+     * @brief Flushes the pending deltas as one pipelined batch
+     *
+     * Deltas summing to zero are dropped. Deltas added during the flush go to
+     * the next one.
+     *
+     * @param func Callback receiving the number of commands sent
+     * @return Reference to the aggregator for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, counter_aggregator &>
+    flush(Func &&func) {
+        auto state = make_fan_in<long long>(
+            [this, start = clock::now(),
+             func = std::forward<Func>(func)](Reply<long long> &&reply) mutable {
+                using std::chrono::microseconds;
+                const auto latency =
+                    std::chrono::duration_cast<microseconds>(clock::now() - start);
+                const auto count = static_cast<std::size_t>(reply.result());
+                if (count) {
+                    ++_stats.flushes;
+                    _stats.commands += count;
+                    _stats.last_batch   = count;
+                    _stats.max_batch    = std::max(_stats.max_batch, count);
+                    _stats.last_latency = latency;
+                    _stats.max_latency  = std::max(_stats.max_latency, latency);
+                }
+                std::move(func)(std::move(reply));
+            });
+        auto on_reply = [this, state]() {
+            return [this, state](auto &&reply) {
+                if (state->failed(reply))
+                    ++_stats.errors;
+                state->done();
+            };
+        };
+        auto send = [&](auto &&command) {
+            state->hold();
+            ++state->reply.result();
+            command(on_reply());
+        };
+
+        _last_flush = clock::now();
+        for (std::size_t i = 0; i < _opts.shards; ++i) {
+            shard drained;
+            {
+                shard_lock lock{_shards[i]};
+                std::swap(drained.counters, _shards[i].counters);
+                std::swap(drained.hashes, _shards[i].hashes);
+                std::swap(drained.sorted_sets, _shards[i].sorted_sets);
+            }
+
+            std::size_t entries = drained.counters.size();
+            for (const auto &[key, delta] : drained.counters) {
+                if (delta)
+                    send([&](auto &&cb) { _redis.incrby(std::move(cb), key, delta); });
+            }
+            for (const auto &[key, fields] : drained.hashes) {
+                entries += fields.size();
+                for (const auto &[field, delta] : fields) {
+                    if (delta)
+                        send([&](auto &&cb) {
+                            _redis.hincrby(std::move(cb), key, field, delta);
+                        });
+                }
+            }
+            for (const auto &[key, members] : drained.sorted_sets) {
+                entries += members.size();
+                for (const auto &[member, delta] : members) {
+                    if (delta != 0)
+                        send([&](auto &&cb) {
+                            _redis.zincrby(std::move(cb), key, delta, member);
+                        });
+                }
+            }
+            _entries.fetch_sub(entries, std::memory_order_relaxed);
+        }
+
+        state->done();
+        return *this;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_COUNTER_AGGREGATOR_H
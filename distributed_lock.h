@@ -0,0 +1,481 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_DISTRIBUTED_LOCK_H
+#define QBM_REDIS_DISTRIBUTED_LOCK_H
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "redis.h"
+
+namespace qb::redis {
+
+namespace detail {
+
+/**
+ * @brief Deletes KEYS[1] if it still holds the token ARGV[1]
+ */
+inline const script &
+lock_release_script() {
+    static const script s{R"(
+if redis.call('GET', KEYS[1]) == ARGV[1] then
+    return redis.call('DEL', KEYS[1])
+end
+return 0
+)"};
+    return s;
+}
+
+/**
+ * @brief Sets the time to live of KEYS[1] to ARGV[2] milliseconds if it still
+ * holds the token ARGV[1]
+ */
+inline const script &
+lock_extend_script() {
+    static const script s{R"(
+if redis.call('GET', KEYS[1]) == ARGV[1] then
+    return redis.call('PEXPIRE', KEYS[1], ARGV[2])
+end
+return 0
+)"};
+    return s;
+}
+
+/**
+ * @brief Generates a 128 bits random token in hexadecimal
+ */
+inline std::string
+lock_token() {
+    static thread_local std::mt19937_64 engine{std::random_device{}()};
+    char                                buffer[33];
+    std::snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+                  static_cast<unsigned long long>(engine()),
+                  static_cast<unsigned long long>(engine()));
+    return buffer;
+}
+
+} // namespace detail
+
+/**
+ * @class distributed_lock
+ * @brief Lock shared across processes, on one Redis instance or on a quorum of
+ * independent instances (Redlock)
+ *
+ * acquire() sends SET key token NX PX ttl and INCR key:fence to every instance
+ * at once, so acquiring costs a single round trip. The lock is held when a
+ * majority of the instances set the key, within the ttl minus the time spent
+ * acquiring and a clock drift allowance. The fencing token is the highest
+ * INCR result. On a single instance it grows with every acquisition, so a
+ * resource can reject the writes of a holder whose lock expired. On several
+ * instances it is not monotonic: the next holder may reach a quorum without
+ * the instance that gave the highest count, and get a lower token.
+ *
+ * release() and extend() run Lua scripts checking the random token, so a lock
+ * taken over by another holder is never touched. With auto_extend, the lease
+ * is extended in the background when renew_at of the ttl has elapsed. If the
+ * extension fails, the lock is lost and the on_lost() handler is called.
+ *
+ * The lock must be used on the event loop thread of its clients, and outlive
+ * its pending commands. It is not released on destruction.
+ *
+ * @tparam QB_IO_ The QB I/O type of the clients
+ */
+template <typename QB_IO_>
+class distributed_lock {
+public:
+    using client_type = detail::Redis<QB_IO_>;
+    using clock       = std::chrono::steady_clock;
+
+    /**
+     * @struct options
+     * @brief Lease policy of a lock
+     */
+    struct options {
+        std::chrono::milliseconds ttl{10000};          ///< Lease on each instance
+        bool                      auto_extend  = true; ///< Extends in the background
+        double                    renew_at     = 0.5;  ///< Ratio of the ttl elapsed
+        double                    drift_factor = 0.01; ///< Clock drift, ratio of ttl
+    };
+
+private:
+    std::vector<client_type *> _instances;
+    std::string                _name;
+    std::string                _fence_key;
+    options                    _opts;
+    std::string                _token;
+    long long                  _fence = 0;
+    bool                       _held  = false;
+    clock::time_point          _valid_until;
+    std::shared_ptr<bool>      _timer;
+    std::function<void()>      _on_lost;
+
+    [[nodiscard]] std::size_t
+    quorum() const {
+        return _instances.size() / 2 + 1;
+    }
+
+    /**
+     * @brief Gets the end of validity of a lease started at start
+     */
+    [[nodiscard]] clock::time_point
+    valid_until(clock::time_point start) const {
+        const auto drift = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               _opts.ttl * _opts.drift_factor) +
+                           std::chrono::milliseconds(2);
+        return start + _opts.ttl - drift;
+    }
+
+    /**
+     * @brief Runs a token checking script on every instance
+     *
+     * @param func Callback receiving the number of instances where it succeeded
+     */
+    template <typename Func>
+    void
+    broadcast(const script &s, std::vector<std::string> args, Func &&func) {
+        auto state = make_fan_in<long long>(std::forward<Func>(func));
+        for (auto *instance : _instances) {
+            state->hold();
+            instance->template evalsha<long long>(
+                [state](auto &&reply) {
+                    if (!state->failed(reply) && reply.result() == 1)
+                        ++state->reply.result();
+                    state->done();
+                },
+                s, {_name}, args);
+        }
+        state->done();
+    }
+
+    /**
+     * @brief Marks the lock as lost and calls the handler
+     */
+    void
+    lose() {
+        const bool was_held = _held;
+        _held               = false;
+        stop();
+        if (was_held && _on_lost)
+            _on_lost();
+    }
+
+    /**
+     * @brief Schedules the next extension while the token is valid
+     */
+    void
+    arm(std::shared_ptr<bool> token) {
+        const double delay =
+            std::chrono::duration<double>(_opts.ttl).count() * _opts.renew_at;
+        call_later(token, delay, [this, token]() {
+            extend([this, token](auto &&reply) {
+                if (*token && reply.ok() && reply.result())
+                    arm(token);
+            });
+        });
+    }
+
+    void
+    stop() {
+        if (_timer) {
+            *_timer = false;
+            _timer.reset();
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs a lock on a single instance
+     * @param redis Client of the instance
+     * @param name Key of the lock
+     * @param opts Lease policy
+     */
+    distributed_lock(client_type &redis, std::string name, options opts = {})
+        : distributed_lock(std::vector<client_type *>{&redis}, std::move(name), opts) {}
+
+    /**
+     * @brief Constructs a lock on a quorum of independent instances
+     * @param instances Clients of the instances, usually 3 or 5
+     * @param name Key of the lock
+     * @param opts Lease policy
+     */
+    distributed_lock(std::vector<client_type *> instances, std::string name,
+                     options opts = {})
+        : _instances(std::move(instances))
+        , _name(std::move(name))
+        , _fence_key(_name + ":fence")
+        , _opts(opts) {
+        if (_instances.empty())
+            throw std::invalid_argument("distributed_lock: no instance");
+        if (_opts.ttl.count() <= 0 || _opts.renew_at <= 0 || _opts.renew_at >= 1)
+            throw std::invalid_argument("distributed_lock: invalid ttl or renew_at");
+        for (auto *instance : _instances) {
+            instance->register_script(detail::lock_release_script());
+            instance->register_script(detail::lock_extend_script());
+        }
+    }
+
+    distributed_lock(const distributed_lock &) = delete;
+    distributed_lock &operator=(const distributed_lock &) = delete;
+
+    ~distributed_lock() {
+        stop();
+    }
+
+    /**
+     * @brief Sets the handler called when an extension fails and the lock is lost
+     * @param handler Handler to call
+     * @return Reference to the lock for chaining
+     */
+    distributed_lock &
+    on_lost(std::function<void()> handler) {
+        _on_lost = std::move(handler);
+        return *this;
+    }
+
+    /**
+     * @brief Tries to acquire the lock and waits for the replies
+     * @return The fencing token, nullopt if the lock is held by another owner
+     * @throws std::runtime_error if a quorum could not be reached because of errors
+     */
+    std::optional<long long>
+    acquire() {
+        return sync_result<std::optional<long long>>(
+            [this](auto &&func) { acquire(func); });
+    }
+
+    /**
+     * @brief Tries to acquire the lock in a single round trip
+     *
+     * Acquiring a lock already held passes its current fencing token. On
+     * failure, the instances where the key was set are released.
+     *
+     * @param func Callback receiving the fencing token, nullopt if the lock is
+     * held by another owner
+     * @return Reference to the lock for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<long long>> &&>,
+                     distributed_lock &>
+    acquire(Func &&func) {
+        if (held()) {
+            std::forward<Func>(func)(
+                Reply<std::optional<long long>>{true, _fence, {}, {}});
+            return *this;
+        }
+        stop();
+        _held = false;
+
+        struct votes {
+            std::vector<bool> locked;
+            long long         fence;
+        };
+
+        const auto count = _instances.size();
+        const auto token = detail::lock_token();
+        const auto start = clock::now();
+        auto       state = make_fan_in<votes>(
+            [this, token, start, func = std::forward<Func>(func)](auto &&reply) mutable {
+                const auto &found  = reply.result();
+                const auto  locked = static_cast<std::size_t>(
+                    std::count(found.locked.begin(), found.locked.end(), true));
+                const auto until = valid_until(start);
+                if (locked >= quorum() && clock::now() < until) {
+                    _token       = token;
+                    _fence       = found.fence;
+                    _held        = true;
+                    _valid_until = until;
+                    if (_opts.auto_extend) {
+                        _timer = std::make_shared<bool>(true);
+                        arm(_timer);
+                    }
+                    std::move(func)(
+                        Reply<std::optional<long long>>{true, _fence, {}, {}});
+                    return;
+                }
+                for (std::size_t i = 0; i < found.locked.size(); ++i) {
+                    if (found.locked[i])
+                        _instances[i]->template evalsha<long long>(
+                            no_check, detail::lock_release_script(), {_name}, {token});
+                }
+                std::move(func)(Reply<std::optional<long long>>{
+                    reply.ok(), std::nullopt, std::move(reply.raw()), reply.error()});
+            },
+            votes{std::vector<bool>(count, false), 0});
+
+        state->hold(2 * count);
+        for (std::size_t i = 0; i < count; ++i) {
+            _instances[i]->template command<std::optional<std::string>>(
+                [state, i](auto &&reply) {
+                    if (!state->failed(reply))
+                        state->reply.result().locked[i] = reply.result().has_value();
+                    state->done();
+                },
+                "SET", _name, token, "NX", "PX",
+                static_cast<long long>(_opts.ttl.count()));
+            _instances[i]->incr(
+                [state](auto &&reply) {
+                    if (!state->failed(reply))
+                        state->reply.result().fence =
+                            std::max(state->reply.result().fence, reply.result());
+                    state->done();
+                },
+                _fence_key);
+        }
+        state->done();
+        return *this;
+    }
+
+    /**
+     * @brief Releases the lock and waits for the replies
+     * @return true if the lock was still held on a quorum of instances
+     */
+    bool
+    release() {
+        return sync_result<bool>([this](auto &&func) { release(func); });
+    }
+
+    /**
+     * @brief Releases the lock on every instance
+     *
+     * Only the keys still holding the token of this lock are deleted.
+     *
+     * @param func Callback receiving true if the lock was still held on a quorum
+     * of instances
+     * @return Reference to the lock for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<bool> &&>, distributed_lock &>
+    release(Func &&func) {
+        stop();
+        if (!_held) {
+            std::forward<Func>(func)(Reply<bool>{true, false, {}, {}});
+            return *this;
+        }
+        _held = false;
+        broadcast(detail::lock_release_script(), {_token},
+                  [this, func = std::forward<Func>(func)](auto &&reply) mutable {
+                      const bool released =
+                          static_cast<std::size_t>(reply.result()) >= quorum();
+                      func(Reply<bool>{reply.ok() || released, released,
+                                       std::move(reply.raw()), reply.error()});
+                  });
+        return *this;
+    }
+
+    /**
+     * @brief Extends the lease of the lock and waits for the replies
+     * @return true if the lease was extended, false if the lock is lost
+     */
+    bool
+    extend() {
+        return sync_result<bool>([this](auto &&func) { extend(func); });
+    }
+
+    /**
+     * @brief Extends the lease of the lock by the ttl on every instance
+     *
+     * The lock is lost, and the on_lost() handler called, when a quorum of
+     * instances does not hold the token anymore.
+     *
+     * @param func Callback receiving true if the lease was extended
+     * @return Reference to the lock for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<bool> &&>, distributed_lock &>
+    extend(Func &&func) {
+        if (!_held) {
+            std::forward<Func>(func)(Reply<bool>{true, false, {}, {}});
+            return *this;
+        }
+        const auto start = clock::now();
+        broadcast(detail::lock_extend_script(),
+                  {_token, std::to_string(_opts.ttl.count())},
+                  [this, start, func = std::forward<Func>(func)](auto &&reply) mutable {
+                      const auto until    = valid_until(start);
+                      const bool extended = _held &&
+                                            static_cast<std::size_t>(reply.result()) >=
+                                                quorum() &&
+                                            clock::now() < until;
+                      if (extended)
+                          _valid_until = until;
+                      else
+                          lose();
+                      func(Reply<bool>{reply.ok() || extended, extended,
+                                       std::move(reply.raw()), reply.error()});
+                  });
+        return *this;
+    }
+
+    /**
+     * @brief Checks whether the lock is held and its lease still valid
+     */
+    [[nodiscard]] bool
+    held() const {
+        return _held && clock::now() < _valid_until;
+    }
+
+    /**
+     * @brief Gets the fencing token of the last acquisition
+     *
+     * Only grows from one acquisition to the next on a single instance.
+     */
+    [[nodiscard]] long long
+    fencing_token() const {
+        return _fence;
+    }
+
+    /**
+     * @brief Gets the time left before the lease expires
+     */
+    [[nodiscard]] std::chrono::milliseconds
+    validity() const {
+        if (!_held)
+            return std::chrono::milliseconds(0);
+        return std::max(std::chrono::milliseconds(0),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(
+                            _valid_until - clock::now()));
+    }
+
+    /**
+     * @brief Gets the random token identifying the owner on the instances
+     */
+    [[nodiscard]] const std::string &
+    token() const {
+        return _token;
+    }
+
+    /**
+     * @brief Gets the key of the lock
+     */
+    [[nodiscard]] const std::string &
+    name() const {
+        return _name;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_DISTRIBUTED_LOCK_H
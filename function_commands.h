@@ -17,10 +17,130 @@
 
 #ifndef QBM_REDIS_FUNCTION_COMMANDS_H
 #define QBM_REDIS_FUNCTION_COMMANDS_H
+#include <tuple>
 #include "reply.h"
 
 namespace qb::redis {
 
+template <typename Derived, typename Signature>
+class function_binding;
+
+/**
+ * @class function_binding
+ * @brief Typed callable bound to a server-side Redis function
+ *
+ * The FCALL prefix (function name and number of keys) is encoded once at
+ * construction, each call only encodes its own parameters. The first
+ * `numkeys` parameters are sent as keys, the remaining ones as arguments.
+ * If the function is unknown to the server and its library was registered
+ * on the client, the library is loaded and the call retried once. The
+ * parameters are kept for the retry only while libraries are registered,
+ * and then as their single encoding.
+ *
+ * @tparam Derived The Redis client type
+ * @tparam Ret Result type of the function
+ * @tparam Params Parameter types of the function (keys first)
+ */
+template <typename Derived, typename Ret, typename... Params>
+class function_binding<Derived, Ret(Params...)> {
+    struct state {
+        std::string  library;
+        std::string  command;
+        encoded_args header;
+    };
+    Derived                     *_client;
+    std::shared_ptr<const state> _state;
+
+    static bool
+    is_not_found(Reply<Ret> &reply) {
+        return !reply.ok() && reply.error().compare(0, 22, "ERR Function not found") == 0;
+    }
+
+public:
+    /**
+     * @brief Binds a function of a library
+     *
+     * @param client Redis client used to call the function
+     * @param library Library which defines the function
+     * @param name Name of the function
+     * @param numkeys Number of leading parameters that are keys
+     * @param read_only Whether to call the function with FCALL_RO
+     * @throws std::invalid_argument if numkeys exceeds the number of parameters
+     */
+    function_binding(Derived &client, std::string library, const std::string &name,
+                     std::size_t numkeys, bool read_only)
+        : _client(&client) {
+        if (numkeys > sizeof...(Params))
+            throw std::invalid_argument("Function has less parameters than numkeys");
+        _state = std::make_shared<const state>(
+            state{std::move(library), read_only ? "FCALL_RO" : "FCALL",
+                  encode_args(name, numkeys)});
+    }
+
+    /**
+     * @brief Gets the library which defines the function
+     * @return The library name
+     */
+    [[nodiscard]] const std::string &
+    library() const {
+        return _state->library;
+    }
+
+    /**
+     * @brief Calls the function
+     *
+     * @param params Keys then arguments of the function
+     * @return Result of the function, typed as Ret
+     * @throws std::runtime_error if the function fails
+     */
+    Ret
+    operator()(Params const &...params) {
+        Reply<Ret> value{};
+        (*this)([&value](auto &&reply) { value = std::move(reply); }, params...);
+        _client->await();
+
+        if (!value.ok())
+            throw std::runtime_error(std::string(value.error()));
+
+        return std::move(value.result());
+    }
+
+    /**
+     * @brief Asynchronous version of the function call
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param params Keys then arguments of the function
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<Ret> &&>, Derived &>
+    operator()(Func &&func, Params const &...params) {
+        if (_client->registered_libraries().empty())
+            return _client->template command<Ret>(std::forward<Func>(func),
+                                                  _state->command, _state->header,
+                                                  params...);
+
+        auto args = std::make_shared<const encoded_args>(encode_args(params...));
+        return _client->template command<Ret>(
+            [client = _client, state = _state, args, func = std::forward<Func>(func)](
+                auto &&reply) mutable {
+                if (is_not_found(reply)) {
+                    auto const &libraries = client->registered_libraries();
+                    auto        it        = libraries.find(state->library);
+                    if (it != libraries.end()) {
+                        client->function_load([](auto &&) {}, it->second);
+                        client->template command<Ret>(std::move(func), state->command,
+                                                      state->header, *args);
+                        return;
+                    }
+                }
+                std::move(func)(std::forward<decltype(reply)>(reply));
+            },
+            _state->command, _state->header, *args);
+    }
+};
+
 /**
  * @class function_commands
  * @brief Provides Redis Function command implementations.
@@ -37,8 +157,190 @@ private:
     derived() {
         return static_cast<Derived &>(*this);
     }
+    qb::unordered_map<std::string, std::string> libraries_;
+
+    /**
+     * @brief Extracts the library name from the `#!lua name=<name>` shebang
+     * @param code Lua code of the library
+     * @return The library name
+     * @throws std::invalid_argument if the shebang has no name
+     */
+    static std::string
+    library_name(const std::string &code) {
+        auto eol = code.find('\n');
+        auto pos = code.find("name=");
+        if (code.compare(0, 2, "#!") != 0 || pos == std::string::npos || pos > eol)
+            throw std::invalid_argument("Library code must start with #!lua name=<name>");
+        pos += 5;
+        auto end = code.find_first_of(" \r\n", pos);
+        return code.substr(pos, end == std::string::npos ? end : end - pos);
+    }
+
+protected:
+    /**
+     * @brief Loads all registered libraries on the server
+     *
+     * Called by the client when the connection is established. FUNCTION LOAD
+     * fails without REPLACE if the library exists, so only absent libraries
+     * are created and their errors are ignored.
+     */
+    void
+    preload_libraries() {
+        for (const auto &library : libraries_)
+            derived().template command<status>([](auto &&) {}, "FUNCTION", "LOAD",
+                                               library.second);
+    }
 
 public:
+    /**
+     * @brief Calls a server-side function
+     *
+     * @tparam Ret Return type of the function
+     * @param function Name of the function
+     * @param keys Vector of key names that the function will access
+     * @param args Vector of additional arguments to the function
+     * @return Result of the function, typed as Ret
+     * @see https://redis.io/commands/fcall
+     */
+    template <typename Ret>
+    Ret
+    fcall(const std::string &function, const std::vector<std::string> &keys = {},
+          const std::vector<std::string> &args = {}) {
+        return derived()
+            .template command<Ret>("FCALL", function, keys.size(), keys, args)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of fcall
+     *
+     * @tparam Ret Return type of the function
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param function Name of the function
+     * @param keys Vector of key names that the function will access
+     * @param args Vector of additional arguments to the function
+     * @return Reference to the derived class
+     * @see https://redis.io/commands/fcall
+     */
+    template <typename Ret, typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<Ret> &&>, Derived &>
+    fcall(Func &&func, const std::string &function,
+          const std::vector<std::string> &keys = {},
+          const std::vector<std::string> &args = {}) {
+        return derived().template command<Ret>(std::forward<Func>(func), "FCALL",
+                                               function, keys.size(), keys, args);
+    }
+
+    /**
+     * @brief Calls a read-only server-side function
+     *
+     * The function must be flagged `no-writes`. FCALL_RO can be served by
+     * replicas.
+     *
+     * @tparam Ret Return type of the function
+     * @param function Name of the function
+     * @param keys Vector of key names that the function will access
+     * @param args Vector of additional arguments to the function
+     * @return Result of the function, typed as Ret
+     * @see https://redis.io/commands/fcall_ro
+     */
+    template <typename Ret>
+    Ret
+    fcall_ro(const std::string &function, const std::vector<std::string> &keys = {},
+             const std::vector<std::string> &args = {}) {
+        return derived()
+            .template command<Ret>("FCALL_RO", function, keys.size(), keys, args)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of fcall_ro
+     *
+     * @tparam Ret Return type of the function
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param function Name of the function
+     * @param keys Vector of key names that the function will access
+     * @param args Vector of additional arguments to the function
+     * @return Reference to the derived class
+     * @see https://redis.io/commands/fcall_ro
+     */
+    template <typename Ret, typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<Ret> &&>, Derived &>
+    fcall_ro(Func &&func, const std::string &function,
+             const std::vector<std::string> &keys = {},
+             const std::vector<std::string> &args = {}) {
+        return derived().template command<Ret>(std::forward<Func>(func), "FCALL_RO",
+                                               function, keys.size(), keys, args);
+    }
+
+    /**
+     * @brief Registers a library to be loaded on every connection
+     *
+     * The library is created during the connection handshake if it is absent
+     * from the server, and reloaded by typed bindings that hit an unknown
+     * function.
+     *
+     * @param code Lua code of the library, starting with `#!lua name=<name>`
+     * @return The library name
+     * @throws std::invalid_argument if the code has no library name
+     */
+    std::string
+    register_library(std::string code) {
+        auto name        = library_name(code);
+        libraries_[name] = std::move(code);
+        return name;
+    }
+
+    /**
+     * @brief Gets the libraries registered for preloading
+     * @return Map of library names to their code
+     */
+    const qb::unordered_map<std::string, std::string> &
+    registered_libraries() const {
+        return libraries_;
+    }
+
+    /**
+     * @brief Binds a typed callable to a server-side function
+     *
+     * @code
+     * auto incr = redis.function<long long(std::string, long long)>("lib", "incr", 1);
+     * long long v = incr("counter", 5);
+     * @endcode
+     *
+     * @tparam Signature Function signature, `Ret(Keys..., Args...)`
+     * @param library Library which defines the function
+     * @param name Name of the function
+     * @param numkeys Number of leading parameters that are keys
+     * @return The function binding
+     */
+    template <typename Signature>
+    function_binding<Derived, Signature>
+    function(const std::string &library, const std::string &name,
+             std::size_t numkeys = 0) {
+        return {derived(), library, name, numkeys, false};
+    }
+
+    /**
+     * @brief Binds a typed callable to a read-only server-side function
+     *
+     * Calls are sent with FCALL_RO, the function must be flagged `no-writes`.
+     *
+     * @tparam Signature Function signature, `Ret(Keys..., Args...)`
+     * @param library Library which defines the function
+     * @param name Name of the function
+     * @param numkeys Number of leading parameters that are keys
+     * @return The function binding
+     */
+    template <typename Signature>
+    function_binding<Derived, Signature>
+    function_ro(const std::string &library, const std::string &name,
+                std::size_t numkeys = 0) {
+        return {derived(), library, name, numkeys, true};
+    }
+
     /**
      * @brief List all functions
      *
@@ -17,6 +17,9 @@
 
 #ifndef QBM_REDIS_GEO_COMMANDS_H
 #define QBM_REDIS_GEO_COMMANDS_H
+#include <algorithm>
+#include <iterator>
+#include "geohash.h"
 #include "reply.h"
 
 namespace qb::redis {
@@ -74,6 +77,100 @@ public:
             std::forward<Func>(func), "GEOADD", key, std::forward<Members>(members)...);
     }
 
+    /**
+     * @brief Adds points from parallel arrays with chunked, pipelined GEOADD commands
+     *
+     * The arrays can be any contiguous containers (std::vector, std::array, C
+     * arrays, ...). Points are encoded straight from the caller buffers, at most
+     * chunk_size per command, and all the chunks are sent in the same batch.
+     *
+     * @param key Key where the geospatial data is stored
+     * @param longitudes Longitudes of the points
+     * @param latitudes Latitudes of the points
+     * @param members Member names of the points
+     * @param type Update type (ALWAYS, EXIST for XX, NOT_EXIST for NX)
+     * @param changed If true, count changed elements too (CH)
+     * @param chunk_size Maximum number of points per command
+     * @return Number of elements added (or changed) over all the chunks
+     * @throws std::invalid_argument if the array sizes differ or chunk_size is 0
+     * @throws std::runtime_error if a chunk fails
+     */
+    template <typename Lons, typename Lats, typename Names>
+    long long
+    geoadd_batch(const std::string &key, const Lons &longitudes, const Lats &latitudes,
+                 const Names &members, UpdateType type = UpdateType::ALWAYS,
+                 bool changed = false, std::size_t chunk_size = 512) {
+        Reply<long long> value{};
+        geoadd_batch([&value](auto &&reply) { value = std::move(reply); }, key,
+                     longitudes, latitudes, members, type, changed, chunk_size);
+        derived().await();
+
+        if (!value.ok())
+            throw std::runtime_error(std::string(value.error()));
+        return value.result();
+    }
+
+    /**
+     * @brief Asynchronous version of geoadd_batch
+     *
+     * The callback is invoked once, when all the chunks are replied, with the
+     * sum of the chunk results or the first error.
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the geospatial data is stored
+     * @param longitudes Longitudes of the points
+     * @param latitudes Latitudes of the points
+     * @param members Member names of the points
+     * @param type Update type (ALWAYS, EXIST for XX, NOT_EXIST for NX)
+     * @param changed If true, count changed elements too (CH)
+     * @param chunk_size Maximum number of points per command
+     * @return Reference to the Redis handler for chaining
+     * @throws std::invalid_argument if the array sizes differ or chunk_size is 0
+     */
+    template <typename Func, typename Lons, typename Lats, typename Names>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, Derived &>
+    geoadd_batch(Func &&func, const std::string &key, const Lons &longitudes,
+                 const Lats &latitudes, const Names &members,
+                 UpdateType type = UpdateType::ALWAYS, bool changed = false,
+                 std::size_t chunk_size = 512) {
+        using member_type =
+            std::remove_cv_t<std::remove_pointer_t<decltype(std::data(members))>>;
+        const std::size_t count = std::size(members);
+        if (std::size(longitudes) != count || std::size(latitudes) != count)
+            throw std::invalid_argument("geoadd_batch: array sizes differ");
+        if (!chunk_size)
+            throw std::invalid_argument("geoadd_batch: chunk_size must be positive");
+        if (!count) {
+            std::forward<Func>(func)(Reply<long long>{true, 0, {}, {}});
+            return derived();
+        }
+
+        std::optional<std::string> opt_up, opt_ch;
+        if (type != UpdateType::ALWAYS)
+            opt_up = std::to_string(type);
+        if (changed)
+            opt_ch = "CH";
+
+        auto state = make_fan_in<long long>(std::forward<Func>(func));
+        state->hold((count + chunk_size - 1) / chunk_size);
+        for (std::size_t off = 0; off < count; off += chunk_size) {
+            geo_points<member_type> points{std::data(longitudes) + off,
+                                           std::data(latitudes) + off,
+                                           std::data(members) + off,
+                                           std::min(chunk_size, count - off)};
+            derived().template command<long long>(
+                [state](auto &&reply) {
+                    if (!state->failed(reply))
+                        state->reply.result() += reply.result();
+                    state->done();
+                },
+                "GEOADD", key, opt_up, opt_ch, points);
+        }
+        state->done();
+        return derived();
+    }
+
     /**
      * @brief Calculates the distance between two members of a geospatial index
      *
@@ -327,6 +424,104 @@ public:
             std::forward<Func>(func), "GEOSEARCH", key, "FROMMEMBER", member, "BYRADIUS",
             std::to_string(radius), std::to_string(unit), options);
     }
+
+    /**
+     * @brief Searches a geospatial index and decodes the entries with their extras
+     *
+     * The result is a structure of arrays: member names plus one contiguous
+     * array per requested WITHDIST, WITHCOORD and WITHHASH option, so distances
+     * and positions come back in the same round trip.
+     *
+     * @param key Key where the geospatial data is stored
+     * @param origin Search center (geo_origin::from_member or geo_origin::from_lonlat)
+     * @param shape Search area (geo_shape::radius or geo_shape::box)
+     * @param options Sort order, COUNT [ANY] and WITH* flags
+     * @return Matching members and their requested extras
+     * @see https://redis.io/commands/geosearch
+     */
+    geo_search_result
+    geosearch(const std::string &key, const geo_origin &origin, const geo_shape &shape,
+              const geo_search_options &options = {}) {
+        return derived()
+            .template command<geo_search_result>("GEOSEARCH", key, origin, shape, options)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of geosearch with a structure-of-arrays result
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the geospatial data is stored
+     * @param origin Search center
+     * @param shape Search area
+     * @param options Sort order, COUNT [ANY] and WITH* flags
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<geo_search_result> &&>, Derived &>
+    geosearch(Func &&func, const std::string &key, const geo_origin &origin,
+              const geo_shape &shape, const geo_search_options &options = {}) {
+        return derived().template command<geo_search_result>(
+            std::forward<Func>(func), "GEOSEARCH", key, origin, shape, options);
+    }
+
+    /**
+     * @brief Stores the result of a geospatial search in a key
+     *
+     * WITH* flags of the options are ignored, they are not valid for this command.
+     *
+     * @param destination Key where the result is stored
+     * @param source Key where the geospatial data is stored
+     * @param origin Search center
+     * @param shape Search area
+     * @param options Sort order and COUNT [ANY]
+     * @param store_dist Store the distances as scores instead of the geohashes
+     * @return Number of members stored
+     * @see https://redis.io/commands/geosearchstore
+     */
+    long long
+    geosearchstore(const std::string &destination, const std::string &source,
+                   const geo_origin &origin, const geo_shape &shape,
+                   geo_search_options options = {}, bool store_dist = false) {
+        options.with_coord = options.with_dist = options.with_hash = false;
+        std::optional<std::string> opt_store;
+        if (store_dist)
+            opt_store = "STOREDIST";
+        return derived()
+            .template command<long long>("GEOSEARCHSTORE", destination, source, origin,
+                                         shape, options, opt_store)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of geosearchstore
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param destination Key where the result is stored
+     * @param source Key where the geospatial data is stored
+     * @param origin Search center
+     * @param shape Search area
+     * @param options Sort order and COUNT [ANY]
+     * @param store_dist Store the distances as scores instead of the geohashes
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, Derived &>
+    geosearchstore(Func &&func, const std::string &destination,
+                   const std::string &source, const geo_origin &origin,
+                   const geo_shape &shape, geo_search_options options = {},
+                   bool store_dist = false) {
+        options.with_coord = options.with_dist = options.with_hash = false;
+        std::optional<std::string> opt_store;
+        if (store_dist)
+            opt_store = "STOREDIST";
+        return derived().template command<long long>(std::forward<Func>(func),
+                                                     "GEOSEARCHSTORE", destination,
+                                                     source, origin, shape, options,
+                                                     opt_store);
+    }
 };
 
 } // namespace qb::redis
@@ -0,0 +1,112 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <stdexcept>
+#include "geohash.h"
+
+namespace {
+
+/**
+ * @brief Spreads the 32 bits of x over the even bits of a 64 bits word
+ */
+inline std::uint64_t
+spread(std::uint32_t x) {
+    std::uint64_t v = x;
+    v               = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v               = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v               = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v               = (v | (v << 2)) & 0x3333333333333333ULL;
+    v               = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+}
+
+/**
+ * @brief Gathers the even bits of a 64 bits word, inverse of spread
+ */
+inline std::uint32_t
+squash(std::uint64_t v) {
+    v &= 0x5555555555555555ULL;
+    v = (v | (v >> 1)) & 0x3333333333333333ULL;
+    v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v >> 4)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v >> 8)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v >> 16)) & 0x00000000FFFFFFFFULL;
+    return static_cast<std::uint32_t>(v);
+}
+
+/**
+ * @brief Interleaves latitude (even bits) and longitude (odd bits) offsets
+ */
+std::uint64_t
+interleave(double longitude, double latitude, double lat_min, double lat_max,
+           unsigned step) {
+    if (step == 0 || step > qb::redis::geohash::max_step)
+        throw std::invalid_argument("geohash step must be in [1, 26]");
+    if (longitude < qb::redis::geohash::min_longitude ||
+        longitude > qb::redis::geohash::max_longitude || latitude < lat_min ||
+        latitude > lat_max)
+        throw std::invalid_argument("invalid longitude or latitude");
+
+    double scale   = static_cast<double>(1ULL << step);
+    double lat_off = (latitude - lat_min) / (lat_max - lat_min) * scale;
+    double lon_off = (longitude - qb::redis::geohash::min_longitude) /
+                     (qb::redis::geohash::max_longitude -
+                      qb::redis::geohash::min_longitude) *
+                     scale;
+    return spread(static_cast<std::uint32_t>(lat_off)) |
+           (spread(static_cast<std::uint32_t>(lon_off)) << 1);
+}
+
+} // namespace
+
+namespace qb::redis::geohash {
+
+std::uint64_t
+encode(double longitude, double latitude, unsigned step) {
+    return interleave(longitude, latitude, min_latitude, max_latitude, step);
+}
+
+geo_pos
+decode(std::uint64_t bits, unsigned step) {
+    double scale   = static_cast<double>(1ULL << step);
+    double lat_off = squash(bits);
+    double lon_off = squash(bits >> 1);
+
+    double lat_min = min_latitude + lat_off / scale * (max_latitude - min_latitude);
+    double lat_max = min_latitude + (lat_off + 1) / scale * (max_latitude - min_latitude);
+    double lon_min = min_longitude + lon_off / scale * (max_longitude - min_longitude);
+    double lon_max =
+        min_longitude + (lon_off + 1) / scale * (max_longitude - min_longitude);
+
+    auto clamp = [](double v, double lo, double hi) { return v < lo ? lo : v > hi ? hi : v; };
+    return {clamp((lon_min + lon_max) / 2, min_longitude, max_longitude),
+            clamp((lat_min + lat_max) / 2, min_latitude, max_latitude)};
+}
+
+std::string
+to_string(double longitude, double latitude) {
+    static constexpr char alphabet[] = "0123456789bcdefghjkmnpqrstuvwxyz";
+
+    auto bits = interleave(longitude, latitude, -90, 90, max_step);
+    // 52 bits give 10 full characters, Redis pads the 11th with '0'
+    std::string hash(11, '0');
+    for (int i = 0; i < 10; ++i)
+        hash[i] = alphabet[(bits >> (52 - (i + 1) * 5)) & 0x1F];
+    return hash;
+}
+
+} // namespace qb::redis::geohash
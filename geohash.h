@@ -0,0 +1,90 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_GEOHASH_H
+#define QBM_REDIS_GEOHASH_H
+#include <cstdint>
+#include <string>
+#include "reply.h"
+
+namespace qb::redis {
+
+/**
+ * @brief Geohash scheme used by Redis sorted sets
+ *
+ * Positions are stored as 52-bit interleaved geohashes (26 bits per axis),
+ * with latitudes limited to the Web Mercator range. These helpers reproduce
+ * the server encoding so that scores, cells and GEOHASH strings can be
+ * computed without a round trip.
+ */
+namespace geohash {
+
+constexpr double   min_longitude = -180;
+constexpr double   max_longitude = 180;
+constexpr double   min_latitude  = -85.05112878;
+constexpr double   max_latitude  = 85.05112878;
+constexpr unsigned max_step      = 26; ///< Bits per axis of a sorted set score
+
+/**
+ * @brief Encodes a position as Redis does for GEOADD scores
+ *
+ * @param longitude Longitude in degrees
+ * @param latitude Latitude in degrees
+ * @param step Bits per axis, lower values give coarser cells for bucketing
+ * @return Interleaved geohash of 2 * step bits
+ * @throws std::invalid_argument if the position or step is out of range
+ */
+std::uint64_t encode(double longitude, double latitude, unsigned step = max_step);
+
+/**
+ * @brief Decodes a geohash to the center of its cell, as GEOPOS does
+ *
+ * @param bits Interleaved geohash
+ * @param step Bits per axis used to encode bits
+ * @return Center of the geohash cell
+ */
+geo_pos decode(std::uint64_t bits, unsigned step = max_step);
+
+/**
+ * @brief Truncates a full precision geohash to a coarser cell
+ *
+ * @param bits Geohash of max_step bits per axis (a sorted set score)
+ * @param step Bits per axis of the cell
+ * @return Geohash of the cell containing bits
+ */
+constexpr std::uint64_t
+cell(std::uint64_t bits, unsigned step) {
+    return bits >> (2 * (max_step - step));
+}
+
+/**
+ * @brief Computes the 11 characters string returned by GEOHASH
+ *
+ * GEOHASH uses the standard [-90, 90] latitude range, so the string can be
+ * used with other geohash tools.
+ *
+ * @param longitude Longitude in degrees
+ * @param latitude Latitude in degrees
+ * @return Base32 geohash string
+ * @throws std::invalid_argument if the position is out of range
+ */
+std::string to_string(double longitude, double latitude);
+
+} // namespace geohash
+} // namespace qb::redis
+
+#endif // QBM_REDIS_GEOHASH_H
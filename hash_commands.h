@@ -17,6 +17,8 @@
 
 #ifndef QBM_REDIS_HASH_COMMANDS_H
 #define QBM_REDIS_HASH_COMMANDS_H
+#include <stdexcept>
+#include "hash_mapping.h"
 #include "reply.h"
 
 namespace qb::redis {
@@ -450,6 +452,106 @@ public:
             std::forward<FieldValues>(field_values)...);
     }
 
+    /**
+     * @brief Gets a random field from a hash
+     *
+     * @param key Key where the hash is stored
+     * @return A random field, or nullopt if the hash does not exist
+     * @see https://redis.io/commands/hrandfield
+     */
+    std::optional<std::string>
+    hrandfield(const std::string &key) {
+        return derived()
+            .template command<std::optional<std::string>>("HRANDFIELD", key)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of hrandfield
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the hash is stored
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<std::string>> &&>,
+                     Derived &>
+    hrandfield(Func &&func, const std::string &key) {
+        return derived().template command<std::optional<std::string>>(
+            std::forward<Func>(func), "HRANDFIELD", key);
+    }
+
+    /**
+     * @brief Gets several random fields from a hash
+     *
+     * @param key Key where the hash is stored
+     * @param count Number of distinct fields, or if negative, number of fields
+     * allowing repetitions
+     * @return Random fields
+     * @see https://redis.io/commands/hrandfield
+     */
+    std::vector<std::string>
+    hrandfield(const std::string &key, long long count) {
+        return derived()
+            .template command<std::vector<std::string>>("HRANDFIELD", key, count)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of hrandfield with a count
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the hash is stored
+     * @param count Number of distinct fields, or if negative, number of fields
+     * allowing repetitions
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::vector<std::string>> &&>,
+                     Derived &>
+    hrandfield(Func &&func, const std::string &key, long long count) {
+        return derived().template command<std::vector<std::string>>(
+            std::forward<Func>(func), "HRANDFIELD", key, count);
+    }
+
+    /**
+     * @brief Gets several random fields from a hash, with their values
+     *
+     * Fields and values are returned as a structure of arrays, backed by a single
+     * buffer.
+     *
+     * @param key Key where the hash is stored
+     * @param count Number of distinct fields, or if negative, number of fields
+     * allowing repetitions
+     * @return Random fields and their values
+     * @see https://redis.io/commands/hrandfield
+     */
+    field_value_list
+    hrandfield_withvalues(const std::string &key, long long count) {
+        return derived()
+            .template command<field_value_list>("HRANDFIELD", key, count, "WITHVALUES")
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of hrandfield_withvalues
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the hash is stored
+     * @param count Number of distinct fields, or if negative, number of fields
+     * allowing repetitions
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<field_value_list> &&>, Derived &>
+    hrandfield_withvalues(Func &&func, const std::string &key, long long count) {
+        return derived().template command<field_value_list>(
+            std::forward<Func>(func), "HRANDFIELD", key, count, "WITHVALUES");
+    }
+
     /**
      * @brief Incrementally iterates hash fields and values
      *
@@ -709,6 +811,122 @@ public:
         new multi_hvals<Func>(derived(), std::move(keys), std::forward<Func>(func));
         return derived();
     }
+
+    /**
+     * @brief Stores an object as a hash, through its hash_mapping
+     *
+     * Field names are pre-encoded once per type and values are written
+     * straight into the command buffer. Empty optional members are skipped.
+     *
+     * @tparam T Mapped structure
+     * @param key Key where the hash is stored
+     * @param object Object to store
+     * @return Number of fields that were added
+     */
+    template <typename T>
+    std::enable_if_t<detail::has_hash_mapping<T>::value, long long>
+    hset_object(const std::string &key, const T &object) {
+        if (!redis_count(hash_object<T>{object}))
+            return 0;
+        return derived()
+            .template command<long long>("HSET", key, hash_object<T>{object})
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of hset_object
+     *
+     * @tparam Func Callback function type
+     * @tparam T Mapped structure
+     * @param func Callback function
+     * @param key Key where the hash is stored
+     * @param object Object to store
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func, typename T>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&> &&
+                         detail::has_hash_mapping<T>::value,
+                     Derived &>
+    hset_object(Func &&func, const std::string &key, const T &object) {
+        if (!redis_count(hash_object<T>{object})) {
+            std::forward<Func>(func)(Reply<long long>{true, 0, {}, {}});
+            return derived();
+        }
+        return derived().template command<long long>(std::forward<Func>(func), "HSET",
+                                                     key, hash_object<T>{object});
+    }
+
+    /**
+     * @brief Loads an object from a hash, through its hash_mapping
+     *
+     * Without members, all the mapped fields are fetched. Otherwise only the
+     * given members are fetched and the others keep their default value.
+     * Values are decoded by position from a single HMGET.
+     *
+     * @tparam T Mapped structure
+     * @tparam Members Types of the members to load
+     * @param key Key where the hash is stored
+     * @param members Members to load (all when empty)
+     * @return The object, or nullopt if none of the fields exist
+     * @throws std::invalid_argument if a member is not mapped
+     * @throws std::runtime_error if a value does not fit its member type
+     */
+    template <typename T, typename... Members>
+    std::optional<T>
+    hget_object(const std::string &key, Members T::*...members) {
+        Reply<std::optional<T>> value{};
+        hget_object<T>([&value](auto &&reply) { value = std::move(reply); }, key,
+                       members...);
+        derived().await();
+
+        if (!value.ok())
+            throw std::runtime_error(std::string(value.error()));
+        return std::move(value.result());
+    }
+
+    /**
+     * @brief Asynchronous version of hget_object
+     *
+     * @tparam T Mapped structure
+     * @tparam Func Callback function type
+     * @tparam Members Types of the members to load
+     * @param func Callback function
+     * @param key Key where the hash is stored
+     * @param members Members to load (all when empty)
+     * @return Reference to the Redis handler for chaining
+     * @throws std::invalid_argument if a member is not mapped
+     */
+    template <typename T, typename Func, typename... Members>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<T>> &&>, Derived &>
+    hget_object(Func &&func, const std::string &key, Members T::*...members) {
+        constexpr std::size_t N =
+            sizeof...(Members) ? sizeof...(Members) : detail::hash_field_count<T>;
+        using list_type = hash_field_list<T, N>;
+
+        list_type fields;
+        if constexpr (sizeof...(Members) == 0)
+            fields = list_type::all();
+        else
+            fields = list_type::of(members...);
+
+        return derived().template command<std::vector<std::optional<std::string_view>>>(
+            [func = std::forward<Func>(func), fields](auto &&reply) mutable {
+                Reply<std::optional<T>> object{reply.ok(), {}, std::move(reply.raw()),
+                                               reply.error()};
+                if (object.ok()) {
+                    T    value{};
+                    auto found = fields.decode(reply.result(), value);
+                    if (found < 0) {
+                        object.ok()    = false;
+                        object.error() = "ERR hash value does not match the field type";
+                    } else if (found) {
+                        object.result() = std::move(value);
+                    }
+                }
+                std::move(func)(std::move(object));
+            },
+            "HMGET", key, fields);
+    }
 };
 
 } // namespace qb::redis
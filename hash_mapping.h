@@ -0,0 +1,349 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_HASH_MAPPING_H
+#define QBM_REDIS_HASH_MAPPING_H
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "reply.h"
+
+namespace qb::redis {
+
+/**
+ * @struct hash_field
+ * @brief Binds a hash field name to a data member
+ *
+ * @tparam T Mapped structure
+ * @tparam M Member type
+ */
+template <typename T, typename M>
+struct hash_field {
+    std::string_view name;
+    M T::*member;
+};
+
+template <typename T, typename M>
+hash_field(std::string_view, M T::*) -> hash_field<T, M>;
+
+/**
+ * @struct hash_mapping
+ * @brief Field table of a structure stored as a Redis hash
+ *
+ * Specialize it with a constexpr tuple of hash_field named `fields`:
+ *
+ * @code
+ * template <>
+ * struct qb::redis::hash_mapping<user> {
+ *     static constexpr auto fields = std::make_tuple(
+ *         qb::redis::hash_field{"name", &user::name},
+ *         qb::redis::hash_field{"age", &user::age});
+ * };
+ * @endcode
+ *
+ * Supported member types are strings, integers, enums, bool, floating point
+ * values and std::optional of those. An empty optional is not written.
+ *
+ * @tparam T Mapped structure
+ */
+template <typename T>
+struct hash_mapping;
+
+namespace detail {
+
+template <typename T, typename = void>
+struct has_hash_mapping : std::false_type {};
+
+template <typename T>
+struct has_hash_mapping<T, std::void_t<decltype(hash_mapping<T>::fields)>>
+    : std::true_type {};
+
+template <typename T>
+struct is_optional : std::false_type {};
+
+template <typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template <typename T>
+constexpr std::size_t hash_field_count =
+    std::tuple_size_v<std::decay_t<decltype(hash_mapping<T>::fields)>>;
+
+/**
+ * @brief Calls func with the field descriptor at a runtime index
+ */
+template <typename T, typename Func, std::size_t... I>
+void
+visit_hash_field(std::size_t index, Func &&func, std::index_sequence<I...>) {
+    ((index == I ? (void) func(std::get<I>(hash_mapping<T>::fields)) : (void) 0), ...);
+}
+
+template <typename T, typename Func>
+void
+visit_hash_field(std::size_t index, Func &&func) {
+    visit_hash_field<T>(index, std::forward<Func>(func),
+                        std::make_index_sequence<hash_field_count<T>>{});
+}
+
+/**
+ * @brief Gets the RESP bulk strings of the field names, built once per type
+ */
+template <typename T>
+const std::array<std::string, hash_field_count<T>> &
+encoded_hash_fields() {
+    static const auto names = std::apply(
+        [](const auto &...field) {
+            auto encode = [](std::string_view name) {
+                std::string out = "$" + std::to_string(name.size()) + "\r\n";
+                out.append(name.data(), name.size());
+                out += "\r\n";
+                return out;
+            };
+            return std::array<std::string, hash_field_count<T>>{encode(field.name)...};
+        },
+        hash_mapping<T>::fields);
+    return names;
+}
+
+template <typename M>
+bool
+has_hash_value(const M &value) {
+    if constexpr (is_optional<M>::value)
+        return value.has_value();
+    else
+        return true;
+}
+
+template <typename M>
+void
+put_hash_value(qb::allocator::pipe<char> &pipe, const M &value) {
+    if constexpr (is_optional<M>::value) {
+        put_hash_value(pipe, *value);
+    } else if constexpr (std::is_same_v<M, bool>) {
+        to_redis_integer(pipe, value ? 1 : 0);
+    } else if constexpr (std::is_enum_v<M>) {
+        put_hash_value(pipe, static_cast<std::underlying_type_t<M>>(value));
+    } else if constexpr (std::is_integral_v<M> &&
+                         (std::is_signed_v<M> || sizeof(M) < sizeof(long long))) {
+        to_redis_integer(pipe, static_cast<long long>(value));
+    } else if constexpr (std::is_floating_point_v<M>) {
+        to_redis_double(pipe, static_cast<double>(value));
+    } else {
+        to_redis_string(pipe, value);
+    }
+}
+
+/**
+ * @brief Decodes a field value into a member
+ * @return false if the value does not fit the member type
+ */
+template <typename M>
+bool
+get_hash_value(std::string_view value, M &out) {
+    if constexpr (is_optional<M>::value) {
+        typename M::value_type inner{};
+        if (!get_hash_value(value, inner))
+            return false;
+        out = std::move(inner);
+        return true;
+    } else if constexpr (std::is_same_v<M, bool>) {
+        if (value != "0" && value != "1")
+            return false;
+        out = value == "1";
+        return true;
+    } else if constexpr (std::is_enum_v<M>) {
+        std::underlying_type_t<M> raw{};
+        if (!get_hash_value(value, raw))
+            return false;
+        out = static_cast<M>(raw);
+        return true;
+    } else if constexpr (std::is_arithmetic_v<M>) {
+        const char *end = value.data() + value.size();
+        auto        res = std::from_chars(value.data(), end, out);
+        return res.ec == std::errc() && res.ptr == end;
+    } else {
+        static_assert(std::is_assignable_v<M &, std::string_view>,
+                      "unsupported hash field type");
+        out = value;
+        return true;
+    }
+}
+
+template <typename T, typename M>
+std::size_t
+hash_field_index(M T::*member) {
+    std::size_t index = hash_field_count<T>;
+    std::size_t i     = 0;
+    std::apply(
+        [&](const auto &...field) {
+            (((void) [&] {
+                 if constexpr (std::is_same_v<decltype(field.member), M T::*>) {
+                     if (index == hash_field_count<T> && field.member == member)
+                         index = i;
+                 }
+                 ++i;
+             }()),
+             ...);
+        },
+        hash_mapping<T>::fields);
+    if (index == hash_field_count<T>)
+        throw std::invalid_argument("member is not part of the hash mapping");
+    return index;
+}
+
+} // namespace detail
+
+/**
+ * @struct hash_object
+ * @brief Encodes the mapped fields of an object as HSET field value pairs
+ */
+template <typename T>
+struct hash_object {
+    const T &object;
+};
+
+/**
+ * @struct hash_field_list
+ * @brief Encodes a selection of mapped field names, for HMGET
+ *
+ * @tparam T Mapped structure
+ * @tparam N Number of selected fields
+ */
+template <typename T, std::size_t N>
+struct hash_field_list {
+    std::array<std::size_t, N> indices;
+
+    /**
+     * @brief Selects all the mapped fields
+     */
+    static hash_field_list
+    all() {
+        hash_field_list list{};
+        for (std::size_t i = 0; i < N; ++i)
+            list.indices[i] = i;
+        return list;
+    }
+
+    /**
+     * @brief Selects the fields bound to the given members
+     * @throws std::invalid_argument if a member is not mapped
+     */
+    template <typename... Members>
+    static hash_field_list
+    of(Members T::*...members) {
+        return {{detail::hash_field_index<T>(members)...}};
+    }
+
+    /**
+     * @brief Decodes an HMGET reply into an object
+     *
+     * Missing fields leave the member untouched.
+     *
+     * @param values HMGET values, in the order of the selection
+     * @param object Object to fill
+     * @return Number of fields found, or -1 if a value does not fit its member
+     */
+    long long
+    decode(const std::vector<std::optional<std::string_view>> &values, T &object) const {
+        long long found = 0;
+        bool      valid = values.size() == N;
+        for (std::size_t i = 0; valid && i < N; ++i) {
+            if (!values[i])
+                continue;
+            ++found;
+            detail::visit_hash_field<T>(indices[i], [&](const auto &field) {
+                valid = detail::get_hash_value(*values[i], object.*field.member);
+            });
+        }
+        return valid ? found : -1;
+    }
+};
+
+/**
+ * @brief Writes the mapped fields of an object as field value pairs
+ * @param pipe Output pipe to write to
+ * @param obj Object to convert
+ * @return Always returns true
+ */
+template <typename T>
+bool
+to_redis_string(qb::allocator::pipe<char> &pipe, hash_object<T> const &obj) {
+    const auto &names = detail::encoded_hash_fields<T>();
+    std::size_t i     = 0;
+    std::apply(
+        [&](const auto &...field) {
+            ((detail::has_hash_value(obj.object.*field.member)
+                  ? (pipe.write(names[i].data(), names[i].size()),
+                     detail::put_hash_value(pipe, obj.object.*field.member))
+                  : void(),
+              ++i),
+             ...);
+        },
+        hash_mapping<T>::fields);
+    return true;
+}
+
+/**
+ * @brief Counts the field value pairs written for an object
+ * @param obj Object to count
+ * @return Two elements per field holding a value
+ */
+template <typename T>
+std::size_t
+redis_count(hash_object<T> const &obj) {
+    return std::apply(
+        [&](const auto &...field) {
+            return ((detail::has_hash_value(obj.object.*field.member) ? 2 : 0) + ... +
+                    std::size_t{0});
+        },
+        hash_mapping<T>::fields);
+}
+
+/**
+ * @brief Writes a selection of mapped field names
+ * @param pipe Output pipe to write to
+ * @param list Selection to convert
+ * @return Always returns true
+ */
+template <typename T, std::size_t N>
+bool
+to_redis_string(qb::allocator::pipe<char> &pipe, hash_field_list<T, N> const &list) {
+    const auto &names = detail::encoded_hash_fields<T>();
+    for (auto index : list.indices)
+        pipe.write(names[index].data(), names[index].size());
+    return true;
+}
+
+/**
+ * @brief Counts the field names of a selection
+ * @return Number of selected fields
+ */
+template <typename T, std::size_t N>
+constexpr std::size_t
+redis_count(hash_field_list<T, N> const &) {
+    return N;
+}
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_HASH_MAPPING_H
@@ -0,0 +1,237 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "hyperloglog.h"
+
+namespace {
+
+constexpr unsigned      hll_bits     = 6;
+constexpr unsigned      hll_q        = 64 - qb::redis::hyperloglog::precision;
+constexpr std::uint8_t  register_max = (1 << hll_bits) - 1;
+constexpr std::uint64_t hll_seed     = 0xadc83b19ULL;
+constexpr double        alpha_inf    = 0.721347520444481703680;
+
+inline std::uint64_t
+load_le64(const unsigned char *p) {
+    std::uint64_t v = 0;
+    for (int i = 7; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+double
+hll_sigma(double x) {
+    if (x == 1.)
+        return INFINITY;
+    double z_prime;
+    double y = 1;
+    double z = x;
+    do {
+        x *= x;
+        z_prime = z;
+        z += x * y;
+        y += y;
+    } while (z_prime != z);
+    return z;
+}
+
+double
+hll_tau(double x) {
+    if (x == 0. || x == 1.)
+        return 0.;
+    double z_prime;
+    double y = 1.0;
+    double z = 1 - x;
+    do {
+        x = std::sqrt(x);
+        z_prime = z;
+        y *= 0.5;
+        z -= std::pow(1 - x, 2) * y;
+    } while (z_prime != z);
+    return z / 3;
+}
+
+} // namespace
+
+namespace qb::redis {
+
+std::uint64_t
+murmurhash64a(std::string_view data, std::uint32_t seed) {
+    constexpr std::uint64_t m = 0xc6a4a7935bd1e995ULL;
+    constexpr int           r = 47;
+
+    auto          len = data.size();
+    std::uint64_t h   = seed ^ (len * m);
+    auto         *p   = reinterpret_cast<const unsigned char *>(data.data());
+    auto         *end = p + (len - (len & 7));
+
+    for (; p != end; p += 8) {
+        std::uint64_t k = load_le64(p);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch (len & 7) {
+        case 7:
+            h ^= std::uint64_t(p[6]) << 48;
+            [[fallthrough]];
+        case 6:
+            h ^= std::uint64_t(p[5]) << 40;
+            [[fallthrough]];
+        case 5:
+            h ^= std::uint64_t(p[4]) << 32;
+            [[fallthrough]];
+        case 4:
+            h ^= std::uint64_t(p[3]) << 24;
+            [[fallthrough]];
+        case 3:
+            h ^= std::uint64_t(p[2]) << 16;
+            [[fallthrough]];
+        case 2:
+            h ^= std::uint64_t(p[1]) << 8;
+            [[fallthrough]];
+        case 1:
+            h ^= std::uint64_t(p[0]);
+            h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+bool
+hyperloglog::add(std::string_view element) {
+    auto hash  = murmurhash64a(element, static_cast<std::uint32_t>(hll_seed));
+    auto index = hash & (registers - 1);
+    hash >>= precision;
+    hash |= std::uint64_t(1) << hll_q;
+
+    std::uint8_t count = 1;
+    for (std::uint64_t bit = 1; !(hash & bit); bit <<= 1)
+        ++count;
+
+    if (_registers[index] >= count)
+        return false;
+    _registers[index] = count;
+    return true;
+}
+
+void
+hyperloglog::merge(const hyperloglog &other) {
+    for (std::size_t i = 0; i < registers; ++i)
+        _registers[i] = std::max(_registers[i], other._registers[i]);
+}
+
+std::uint64_t
+hyperloglog::count() const {
+    double m             = registers;
+    int    histogram[64] = {};
+    for (auto reg : _registers)
+        ++histogram[reg];
+
+    double z = m * hll_tau((m - histogram[hll_q + 1]) / m);
+    for (int j = hll_q; j >= 1; --j) {
+        z += histogram[j];
+        z *= 0.5;
+    }
+    z += m * hll_sigma(histogram[0] / m);
+    return static_cast<std::uint64_t>(std::llround(alpha_inf * m * m / z));
+}
+
+std::string
+hyperloglog::to_string() const {
+    std::string out(dense_size, '\0');
+    std::memcpy(out.data(), "HYLL", 4);
+    // Encoding 0 (dense), cached cardinality flagged invalid
+    out[15] = static_cast<char>(0x80);
+
+    auto *p = reinterpret_cast<unsigned char *>(out.data() + header_size);
+    for (std::size_t i = 0; i < registers; ++i) {
+        unsigned value = _registers[i];
+        auto     byte  = i * hll_bits / 8;
+        auto     fb    = i * hll_bits & 7;
+        p[byte] |= static_cast<unsigned char>(value << fb);
+        if (fb > 8 - hll_bits)
+            p[byte + 1] |= static_cast<unsigned char>(value >> (8 - fb));
+    }
+    return out;
+}
+
+hyperloglog
+hyperloglog::from_string(std::string_view value) {
+    if (value.size() < header_size || value.compare(0, 4, "HYLL") != 0)
+        throw std::invalid_argument("not a HyperLogLog value");
+
+    hyperloglog hll;
+    auto       *p   = reinterpret_cast<const unsigned char *>(value.data() + header_size);
+    auto        len = value.size() - header_size;
+
+    switch (value[4]) {
+        case 0: // dense
+            if (value.size() != dense_size)
+                throw std::invalid_argument("invalid dense HyperLogLog size");
+            for (std::size_t i = 0; i < registers; ++i) {
+                auto     byte = i * hll_bits / 8;
+                auto     fb   = i * hll_bits & 7;
+                unsigned b0   = p[byte];
+                unsigned b1   = byte + 1 < len ? p[byte + 1] : 0;
+                hll._registers[i] =
+                    static_cast<std::uint8_t>(((b0 >> fb) | (b1 << (8 - fb))) & register_max);
+            }
+            break;
+        case 1: { // sparse: ZERO, XZERO and VAL run-length opcodes
+            std::size_t index = 0;
+            for (std::size_t i = 0; i < len; ++i) {
+                unsigned    op = p[i];
+                std::size_t run;
+                if ((op & 0xC0) == 0) { // ZERO 00xxxxxx
+                    run = (op & 0x3F) + 1;
+                } else if ((op & 0xC0) == 0x40) { // XZERO 01xxxxxx yyyyyyyy
+                    if (++i == len)
+                        throw std::invalid_argument("truncated sparse HyperLogLog");
+                    run = (((op & 0x3F) << 8) | p[i]) + 1;
+                } else { // VAL 1vvvvvxx
+                    run = (op & 0x3) + 1;
+                    if (index + run > registers)
+                        throw std::invalid_argument("invalid sparse HyperLogLog");
+                    std::fill_n(hll._registers.begin() + index, run,
+                                static_cast<std::uint8_t>(((op >> 2) & 0x1F) + 1));
+                }
+                index += run;
+                if (index > registers)
+                    throw std::invalid_argument("invalid sparse HyperLogLog");
+            }
+            if (index != registers)
+                throw std::invalid_argument("invalid sparse HyperLogLog");
+            break;
+        }
+        default:
+            throw std::invalid_argument("unknown HyperLogLog encoding");
+    }
+    return hll;
+}
+
+} // namespace qb::redis
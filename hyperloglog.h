@@ -0,0 +1,110 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_HYPERLOGLOG_H
+#define QBM_REDIS_HYPERLOGLOG_H
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace qb::redis {
+
+/**
+ * @brief MurmurHash64A as used by Redis to hash HyperLogLog elements
+ *
+ * @param data Buffer to hash
+ * @param seed Hash seed
+ * @return 64 bits hash
+ */
+std::uint64_t murmurhash64a(std::string_view data, std::uint32_t seed);
+
+/**
+ * @class hyperloglog
+ * @brief Client side HyperLogLog compatible with the Redis encoding
+ *
+ * Elements are hashed and bucketed exactly as PFADD does (MurmurHash64A,
+ * 16384 registers of 6 bits), so a sketch filled locally can be written with
+ * SET in the dense HYLL format and merged on the server with PFMERGE, and a
+ * sketch read with GET (dense or sparse) can be counted or merged locally.
+ */
+class hyperloglog {
+public:
+    static constexpr unsigned    precision = 14;
+    static constexpr std::size_t registers = std::size_t(1) << precision;
+    static constexpr std::size_t header_size = 16;
+    static constexpr std::size_t dense_size  = header_size + registers * 6 / 8;
+
+    /**
+     * @brief Adds an element to the sketch
+     * @param element Element to add
+     * @return true if a register was altered, as returned by PFADD
+     */
+    bool add(std::string_view element);
+
+    /**
+     * @brief Merges another sketch into this one, as PFMERGE does
+     * @param other Sketch to merge
+     */
+    void merge(const hyperloglog &other);
+
+    /**
+     * @brief Estimates the cardinality, as PFCOUNT does
+     * @return Estimated number of distinct elements
+     */
+    [[nodiscard]] std::uint64_t count() const;
+
+    /**
+     * @brief Serializes the sketch in the dense HYLL format
+     *
+     * The cached cardinality of the header is flagged invalid, so the server
+     * recomputes it on the next PFCOUNT.
+     *
+     * @return Value to store with SET
+     */
+    [[nodiscard]] std::string to_string() const;
+
+    /**
+     * @brief Loads a sketch read from the server
+     * @param value Dense or sparse HYLL string, as returned by GET
+     * @return The decoded sketch
+     * @throws std::invalid_argument if value is not a valid HYLL string
+     */
+    static hyperloglog from_string(std::string_view value);
+
+    /**
+     * @brief Gets the value of a register
+     * @param index Register index, lower than registers
+     * @return Register value
+     */
+    [[nodiscard]] std::uint8_t
+    get(std::size_t index) const {
+        return _registers[index];
+    }
+
+    bool
+    operator==(const hyperloglog &other) const {
+        return _registers == other._registers;
+    }
+
+private:
+    std::array<std::uint8_t, registers> _registers{};
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_HYPERLOGLOG_H
@@ -17,6 +17,7 @@
 
 #ifndef QBM_REDIS_HYPERLOG_COMMANDS_H
 #define QBM_REDIS_HYPERLOG_COMMANDS_H
+#include "hyperloglog.h"
 #include "reply.h"
 
 namespace qb::redis {
@@ -40,6 +41,25 @@ private:
         return static_cast<Derived &>(*this);
     }
 
+    /**
+     * @brief Gets the temporary key of pfmerge_sketch, in the hash slot of the
+     * destination
+     *
+     * Keeps the {hash tag} of the destination, or makes the whole destination
+     * the tag. A destination without tag but with a '}' can not be tagged and
+     * gets the plain suffix.
+     */
+    static std::string
+    sketch_key(const std::string &destination) {
+        const auto open  = destination.find('{');
+        const auto close = destination.find('}', open + 1);
+        const bool tagged =
+            open != std::string::npos && close != std::string::npos && close > open + 1;
+        if (tagged || destination.find('}') != std::string::npos)
+            return destination + ":pfmerge-sketch";
+        return "{" + destination + "}:pfmerge-sketch";
+    }
+
 public:
     /**
      * @brief Adds elements to a HyperLogLog data structure
@@ -139,6 +159,109 @@ public:
                                                   destination,
                                                   std::forward<Keys>(keys)...);
     }
+
+    /**
+     * @brief Merges a locally built sketch into a HyperLogLog key
+     *
+     * The sketch is written in the dense format to a temporary key and merged
+     * with PFMERGE, all in one MULTI/EXEC transaction, so elements counted
+     * client side cost a single 12KB write instead of one PFADD argument each.
+     * The temporary key shares the hash slot of the destination, e.g.
+     * {visitors}:pfmerge-sketch for visitors, so it also works on a cluster.
+     *
+     * @param destination Key of the HyperLogLog to merge into
+     * @param sketch Local sketch
+     * @return true if the sketch was merged
+     * @throws std::runtime_error if the destination is not a HyperLogLog
+     */
+    bool
+    pfmerge_sketch(const std::string &destination, const hyperloglog &sketch) {
+        auto tmp = sketch_key(destination);
+        return derived()
+            .transaction()
+            .template command<status>("SET", tmp, sketch.to_string())
+            .template command<status>("PFMERGE", destination, destination, tmp)
+            .template command<long long>("DEL", tmp)
+            .exec()
+            .has_value();
+    }
+
+    /**
+     * @brief Asynchronous version of pfmerge_sketch
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param destination Key of the HyperLogLog to merge into
+     * @param sketch Local sketch
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<bool> &&>, Derived &>
+    pfmerge_sketch(Func &&func, const std::string &destination,
+                   const hyperloglog &sketch) {
+        auto tmp = sketch_key(destination);
+        return derived()
+            .transaction()
+            .template command<status>("SET", tmp, sketch.to_string())
+            .template command<status>("PFMERGE", destination, destination, tmp)
+            .template command<long long>("DEL", tmp)
+            .exec([func = std::forward<Func>(func)](auto &&reply) mutable {
+                bool merged = reply.ok() && reply.result().has_value();
+                std::move(func)(Reply<bool>{reply.ok(), merged, std::move(reply.raw()),
+                                            reply.error()});
+            });
+    }
+
+    /**
+     * @brief Reads a HyperLogLog key as a local sketch
+     *
+     * Sketches read this way can be merged and counted client side, e.g. to
+     * estimate the union of many keys without a PFCOUNT per combination.
+     *
+     * @param key Key under which the HyperLogLog is stored
+     * @return The sketch, or nullopt if the key does not exist
+     * @throws std::invalid_argument if the value is not a HyperLogLog
+     */
+    std::optional<hyperloglog>
+    pfget_sketch(const std::string &key) {
+        auto value =
+            derived().template command<std::optional<std::string>>("GET", key).result();
+        if (!value)
+            return std::nullopt;
+        return hyperloglog::from_string(*value);
+    }
+
+    /**
+     * @brief Asynchronous version of pfget_sketch
+     *
+     * A value which is not a HyperLogLog is reported as a failed reply.
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key under which the HyperLogLog is stored
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<hyperloglog>> &&>,
+                     Derived &>
+    pfget_sketch(Func &&func, const std::string &key) {
+        return derived().template command<std::optional<std::string_view>>(
+            [func = std::forward<Func>(func)](auto &&reply) mutable {
+                Reply<std::optional<hyperloglog>> sketch{reply.ok(), {},
+                                                         std::move(reply.raw()),
+                                                         reply.error()};
+                if (sketch.ok() && reply.result()) {
+                    try {
+                        sketch.result() = hyperloglog::from_string(*reply.result());
+                    } catch (const std::invalid_argument &) {
+                        sketch.ok()    = false;
+                        sketch.error() = "WRONGTYPE value is not a HyperLogLog";
+                    }
+                }
+                std::move(func)(std::move(sketch));
+            },
+            "GET", key);
+    }
 };
 
 } // namespace qb::redis
@@ -0,0 +1,392 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_ID_ALLOCATOR_H
+#define QBM_REDIS_ID_ALLOCATOR_H
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "redis.h"
+
+namespace qb::redis {
+
+namespace detail {
+
+/**
+ * @brief Reserves up to ARGV[1] sequences of a millisecond of the server
+ * clock, at most ARGV[2] per millisecond. Returns the millisecond, the first
+ * sequence and the number reserved.
+ *
+ * A millisecond whose sequences are exhausted lends the next one, so
+ * blocks never overlap, even if the server clock goes back.
+ */
+inline const script &
+id_block_script() {
+    static const script s{R"(
+local size = tonumber(ARGV[1])
+local limit = tonumber(ARGV[2])
+local t = redis.call('TIME')
+local now = t[1] * 1000 + math.floor(t[2] / 1000)
+local state = redis.call('HMGET', KEYS[1], 'ms', 'seq')
+local ms = tonumber(state[1] or '0')
+local seq = tonumber(state[2] or '0')
+if now > ms then
+    ms, seq = now, 0
+elseif seq >= limit then
+    ms, seq = ms + 1, 0
+end
+size = math.min(size, limit - seq)
+redis.call('HSET', KEYS[1], 'ms', ms, 'seq', seq + size)
+return {ms, seq, size}
+)"};
+    return s;
+}
+
+} // namespace detail
+
+/**
+ * @class id_allocator
+ * @brief Hi/lo allocator of unique IDs reserving blocks with INCRBY
+ *
+ * Each INCRBY on the counter key reserves a block of IDs, which are then
+ * handed out locally. When the prefetch ratio of a block is used (80% by
+ * default), the next block is requested in the background, so next() only
+ * waits for Redis when IDs are consumed faster than a round trip.
+ *
+ * The block size follows the consumption rate: a block is sized to last about
+ * target_duration, within min_block and max_block. IDs left in a block when
+ * the process stops are lost, so IDs are unique but not contiguous.
+ *
+ * With a snowflake layout, blocks are reserved by a script from a counter
+ * per millisecond of the server clock: an ID is the reservation millisecond
+ * since the epoch in the high bits and the sequence within that millisecond
+ * in the low bits. IDs are then roughly sorted by creation time and unique
+ * whatever the time they are handed out.
+ *
+ * The allocator must be used on the event loop thread of its client, and
+ * outlive its pending requests.
+ *
+ * @tparam QB_IO_ The QB I/O type of the client
+ */
+template <typename QB_IO_>
+class id_allocator {
+public:
+    using client_type = detail::Redis<QB_IO_>;
+    using clock       = std::chrono::steady_clock;
+
+    /**
+     * @struct snowflake
+     * @brief Layout of time ordered IDs
+     *
+     * At most 2^sequence_bits IDs are reserved per millisecond, the next ones
+     * borrow the following milliseconds. The counter key then holds a hash.
+     * The epoch is required and bounds the lifetime of the layout to
+     * 2^(63 - sequence_bits) milliseconds, about 69 years with 22 bits.
+     */
+    struct snowflake {
+        std::chrono::system_clock::time_point epoch; ///< Origin of the timestamps
+        unsigned sequence_bits = 22;                 ///< Low bits of the sequence
+    };
+
+    /**
+     * @struct options
+     * @brief Block policy of an allocator
+     */
+    struct options {
+        long long                 block     = 1000;    ///< Size of the first block
+        long long                 min_block = 100;     ///< Smallest adapted block
+        long long                 max_block = 1 << 20; ///< Largest adapted block
+        double                    prefetch  = 0.8;     ///< Used ratio fetching the next
+        std::chrono::milliseconds target_duration{1000}; ///< Lifetime of a block
+        std::optional<snowflake>  layout; ///< Time ordered IDs if set
+    };
+
+private:
+    struct range {
+        long long next  = 0;
+        long long last  = -1;
+        long long stamp = 0; ///< Milliseconds since the epoch of a snowflake block
+
+        [[nodiscard]] long long
+        size() const {
+            return last - next + 1;
+        }
+    };
+
+    using waiter = std::function<void(Reply<long long>)>;
+
+    client_type         &_redis;
+    std::string          _key;
+    options              _opts;
+    range                _current;
+    std::optional<range> _prefetched;
+    long long            _current_size = 0;
+    long long            _block;
+    clock::time_point    _started  = clock::now();
+    bool                 _fetching = false;
+    std::uint64_t        _blocks   = 0;
+    std::deque<waiter>   _waiters;
+
+    /**
+     * @brief Applies the layout to a sequence of a block
+     */
+    long long
+    format(const range &block, long long sequence) const {
+        if (!_opts.layout)
+            return sequence;
+        return (block.stamp << _opts.layout->sequence_bits) | sequence;
+    }
+
+    /**
+     * @brief Makes the prefetched block current, adapting the block size to the
+     * time the previous one lasted
+     */
+    void
+    advance() {
+        const auto now     = clock::now();
+        const auto elapsed = std::chrono::duration<double>(now - _started).count();
+        if (_current_size && elapsed > 0) {
+            const double rate   = _current_size / elapsed;
+            const double target = std::chrono::duration<double>(_opts.target_duration)
+                                      .count();
+            _block = std::clamp(static_cast<long long>(rate * target), _opts.min_block,
+                                _opts.max_block);
+        }
+        _current      = *_prefetched;
+        _current_size = _current.size();
+        _started      = now;
+        _prefetched.reset();
+    }
+
+    /**
+     * @brief Takes the next ID of the current block, if any
+     */
+    std::optional<long long>
+    take() {
+        if (!_current.size() && _prefetched)
+            advance();
+        if (!_current.size())
+            return std::nullopt;
+        const long long id = format(_current, _current.next++);
+        if (_current_size - _current.size() >= _current_size * _opts.prefetch)
+            fetch();
+        return id;
+    }
+
+    /**
+     * @brief Reserves the next block unless one is reserved or in flight
+     */
+    void
+    fetch() {
+        if (_fetching || _prefetched)
+            return;
+        _fetching = true;
+        const long long size = _block;
+        if (_opts.layout) {
+            fetch_stamped(size);
+            return;
+        }
+        _redis.incrby(
+            [this, size](auto &&reply) {
+                _fetching = false;
+                if (reply.ok()) {
+                    _prefetched = range{reply.result() - size + 1, reply.result()};
+                    ++_blocks;
+                }
+                fetched(std::forward<decltype(reply)>(reply));
+            },
+            _key, size);
+    }
+
+    /**
+     * @brief Reserves a block of sequences of a millisecond for the layout
+     */
+    void
+    fetch_stamped(long long size) {
+        const auto bits  = _opts.layout->sequence_bits;
+        const auto epoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               _opts.layout->epoch.time_since_epoch())
+                               .count();
+        _redis.template evalsha<std::vector<long long>>(
+            [this, bits, epoch](auto &&reply) {
+                _fetching = false;
+                Reply<long long> result{reply.ok(), 0, {}, reply.error()};
+                if (reply.ok() && reply.result().size() == 3) {
+                    const auto &block = reply.result();
+                    const auto  stamp = block[0] - epoch;
+                    // The timestamp must fit the high bits without reaching the sign
+                    if (stamp < 0 || stamp >= (1LL << (63 - bits))) {
+                        result = {false, 0, {}, "id_allocator: time out of the layout"};
+                    } else {
+                        _prefetched = range{block[1], block[1] + block[2] - 1, stamp};
+                        ++_blocks;
+                    }
+                } else if (reply.ok()) {
+                    result = {false, 0, {}, "id_allocator: invalid block reply"};
+                }
+                fetched(std::move(result));
+            },
+            detail::id_block_script(), {_key},
+            {std::to_string(size), std::to_string(1LL << bits)});
+    }
+
+    void
+    fetched(Reply<long long> &&reply) {
+        while (!_waiters.empty()) {
+            auto id = take();
+            if (!id)
+                break;
+            auto func = std::move(_waiters.front());
+            _waiters.pop_front();
+            func(Reply<long long>{true, *id, {}, {}});
+        }
+        if (_waiters.empty())
+            return;
+        // Requests still waiting fail with the reserve error
+        if (!reply.ok()) {
+            auto waiters = std::move(_waiters);
+            _waiters     = {};
+            for (auto &func : waiters)
+                func(Reply<long long>{false, 0, {}, reply.error()});
+            return;
+        }
+        fetch();
+    }
+
+public:
+    /**
+     * @brief Constructs an allocator
+     * @param redis Client reserving the blocks
+     * @param key Key of the counter
+     * @param opts Block policy
+     */
+    id_allocator(client_type &redis, std::string key, options opts = {})
+        : _redis(redis)
+        , _key(std::move(key))
+        , _opts(std::move(opts))
+        , _block(_opts.block) {
+        if (_opts.block <= 0 || _opts.min_block <= 0 || _opts.max_block < _opts.min_block)
+            throw std::invalid_argument("id_allocator: invalid block sizes");
+        if (_opts.layout && (!_opts.layout->sequence_bits ||
+                             _opts.layout->sequence_bits >= 63))
+            throw std::invalid_argument("id_allocator: invalid sequence_bits");
+        if (_opts.layout &&
+            _opts.layout->epoch == std::chrono::system_clock::time_point{})
+            throw std::invalid_argument("id_allocator: the snowflake epoch is required");
+        if (_opts.layout)
+            _redis.register_script(detail::id_block_script());
+    }
+
+    id_allocator(const id_allocator &) = delete;
+    id_allocator &operator=(const id_allocator &) = delete;
+
+    /**
+     * @brief Gets an ID without waiting
+     *
+     * Reserves the next block in the background when none is left locally.
+     *
+     * @return The ID, nullopt if no block is available yet
+     */
+    std::optional<long long>
+    try_next() {
+        if (!_waiters.empty()) {
+            fetch();
+            return std::nullopt;
+        }
+        auto id = take();
+        if (!id)
+            fetch();
+        return id;
+    }
+
+    /**
+     * @brief Gets an ID, waiting for a block if needed
+     * @return The ID
+     * @throws std::runtime_error if the block could not be reserved
+     */
+    long long
+    next() {
+        return sync_result<long long>([this](auto &&func) { next(func); });
+    }
+
+    /**
+     * @brief Gets an ID asynchronously
+     *
+     * The callback is invoked before returning when the current block has IDs
+     * left. Requests waiting for a block are served in order.
+     *
+     * @param func Callback receiving the ID
+     * @return Reference to the allocator for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, id_allocator &>
+    next(Func &&func) {
+        if (auto id = try_next()) {
+            std::forward<Func>(func)(Reply<long long>{true, *id, {}, {}});
+            return *this;
+        }
+        // Shared so that move-only callbacks fit in a std::function
+        auto shared = std::make_shared<std::decay_t<Func>>(std::forward<Func>(func));
+        _waiters.emplace_back(
+            [shared](Reply<long long> reply) { (*shared)(std::move(reply)); });
+        return *this;
+    }
+
+    /**
+     * @brief Gets the size of the next block to reserve
+     */
+    [[nodiscard]] long long
+    block_size() const {
+        return _block;
+    }
+
+    /**
+     * @brief Gets the number of IDs left locally, prefetched block included
+     */
+    [[nodiscard]] long long
+    remaining() const {
+        return _current.size() + (_prefetched ? _prefetched->size() : 0);
+    }
+
+    /**
+     * @brief Gets the number of blocks reserved
+     */
+    [[nodiscard]] std::uint64_t
+    blocks() const {
+        return _blocks;
+    }
+
+    /**
+     * @brief Gets the key of the counter
+     */
+    [[nodiscard]] const std::string &
+    key() const {
+        return _key;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_ID_ALLOCATOR_H
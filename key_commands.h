@@ -102,6 +102,50 @@ private:
     };
 
 public:
+    /**
+     * @brief Copy the value stored at a key to another key.
+     * @param source Source key.
+     * @param destination Destination key.
+     * @param replace Whether to overwrite an existing destination key.
+     * @param db Logical database of the destination key, the current one if not set.
+     * @return Whether the value has been copied.
+     * @retval false If the source does not exist or the destination already exists.
+     * @see https://redis.io/commands/copy
+     */
+    bool
+    copy(const std::string &source, const std::string &destination, bool replace = false,
+         std::optional<long long> db = std::nullopt) {
+        std::optional<std::string> opt_replace;
+
+        if (replace)
+            opt_replace = "REPLACE";
+
+        if (db)
+            return derived()
+                .template command<bool>("COPY", source, destination, "DB", *db,
+                                        opt_replace)
+                .result();
+        return derived()
+            .template command<bool>("COPY", source, destination, opt_replace)
+            .result();
+    }
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<bool> &&>, Derived &>
+    copy(Func &&func, const std::string &source, const std::string &destination,
+         bool replace = false, std::optional<long long> db = std::nullopt) {
+        std::optional<std::string> opt_replace;
+
+        if (replace)
+            opt_replace = "REPLACE";
+
+        if (db)
+            return derived().template command<bool>(std::forward<Func>(func), "COPY",
+                                                    source, destination, "DB", *db,
+                                                    opt_replace);
+        return derived().template command<bool>(std::forward<Func>(func), "COPY", source,
+                                                destination, opt_replace);
+    }
+
     /**
      * @brief Delete the given keys.
      * @param keys Keys, variadic(could be a string, or a container of keys)... .
@@ -246,6 +290,25 @@ public:
         return expireat(std::forward<Func>(func), key, tp.time_since_epoch().count());
     }
 
+    /**
+     * @brief Get the absolute expiration time of a key.
+     * @param key Key.
+     * @return UNIX timestamp in seconds at which the key expires.
+     * @retval -1 If the key has no expiration.
+     * @retval -2 If the key does not exist.
+     * @see https://redis.io/commands/expiretime
+     */
+    long long
+    expiretime(const std::string &key) {
+        return derived().template command<long long>("EXPIRETIME", key).result();
+    }
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, Derived &>
+    expiretime(Func &&func, const std::string &key) {
+        return derived().template command<long long>(std::forward<Func>(func),
+                                                     "EXPIRETIME", key);
+    }
+
     /**
      * @brief Get all keys matching the given pattern.
      * @param pattern Pattern, supporting glob-style patterns.
@@ -392,6 +455,25 @@ public:
         return pexpireat(std::forward<Func>(func), key, tp.time_since_epoch().count());
     }
 
+    /**
+     * @brief Get the absolute expiration time of a key in milliseconds.
+     * @param key Key.
+     * @return UNIX timestamp in milliseconds at which the key expires.
+     * @retval -1 If the key has no expiration.
+     * @retval -2 If the key does not exist.
+     * @see https://redis.io/commands/pexpiretime
+     */
+    long long
+    pexpiretime(const std::string &key) {
+        return derived().template command<long long>("PEXPIRETIME", key).result();
+    }
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, Derived &>
+    pexpiretime(Func &&func, const std::string &key) {
+        return derived().template command<long long>(std::forward<Func>(func),
+                                                     "PEXPIRETIME", key);
+    }
+
     /**
      * @brief Get the TTL of a key in milliseconds.
      * @param key Key.
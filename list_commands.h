@@ -771,56 +771,150 @@ public:
             std::to_string(wherefrom), std::to_string(whereto));
     }
 
+    /**
+     * @brief Move an element from one list to another in a blocking way.
+     * @param source Key of the source list.
+     * @param destination Key of the destination list.
+     * @param wherefrom Where to pop from (LEFT or RIGHT).
+     * @param whereto Where to push to (LEFT or RIGHT).
+     * @param timeout Timeout in seconds. 0 means block forever.
+     * @return The element being moved.
+     * @note If the timeout is reached, returns `std::nullopt`.
+     * @see https://redis.io/commands/blmove
+     */
+    std::optional<std::string>
+    blmove(const std::string &source, const std::string &destination,
+           ListPosition wherefrom, ListPosition whereto, double timeout = 0) {
+        if (source.empty() || destination.empty()) {
+            return std::nullopt;
+        }
+        return derived()
+            .template command<std::optional<std::string>>(
+                "BLMOVE", source, destination, std::to_string(wherefrom),
+                std::to_string(whereto), timeout)
+            .result();
+    }
+
+    /**
+     * @brief Move an element from one list to another in a blocking way asynchronously.
+     * @param func Callback function to handle the result.
+     * @param source Key of the source list.
+     * @param destination Key of the destination list.
+     * @param wherefrom Where to pop from (LEFT or RIGHT).
+     * @param whereto Where to push to (LEFT or RIGHT).
+     * @param timeout Timeout in seconds. 0 means block forever.
+     * @return Reference to the derived class.
+     * @see https://redis.io/commands/blmove
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<std::string>> &&>,
+                     Derived &>
+    blmove(Func &&func, const std::string &source, const std::string &destination,
+           ListPosition wherefrom, ListPosition whereto, double timeout = 0) {
+        return derived().template command<std::optional<std::string>>(
+            std::forward<Func>(func), "BLMOVE", source, destination,
+            std::to_string(wherefrom), std::to_string(whereto), timeout);
+    }
+
     /**
      * @brief Pop elements from the first non-empty list key from the list of provided
      * key names.
      * @param keys List of keys to check.
      * @param position Where to pop from (LEFT or RIGHT).
-     * @param count Number of elements to pop (optional).
-     * @return A pair containing the key name and the popped elements.
+     * @param count Maximum number of elements to pop.
+     * @return The key name and the popped elements.
      * @note If all lists are empty, returns `std::nullopt`.
      * @see https://redis.io/commands/lmpop
      */
-    // Todo : implement lmpop
-    // std::optional<std::pair<std::string, std::vector<std::string>>>
-    // lmpop(const std::vector<std::string> &keys, ListPosition position, long long
-    // count) {
-    //     if (keys.size() == 0 || count < 1) {
-    //         return std::nullopt;
-    //     }
-    //     return derived()
-    //         .template command<std::optional<std::pair<std::string,
-    //         std::vector<std::string>>>>(
-    //             "LMPOP",
-    //             1,
-    //             keys,
-    //             std::to_string(position),
-    //             count)
-    //         .result();
-    //// }
-    ///**
-    // * @brief Pop elements from the first non-empty list key asynchronously.
-    // * @param func Callback function to handle the result.
-    // * @param keys List of keys to check.
-    // * @param position Where to pop from (LEFT or RIGHT).
-    // * @param count Number of elements to pop (optional).
-    // * @return Reference to the derived class.
-    // */
-    // template <typename Func>
-    // std::enable_if_t<std::is_invocable_v<Func,
-    // Reply<std::optional<std::pair<std::string, std::vector<std::string>>>> &&>,
-    // Derived &> lmpop(Func &&func, const std::vector<std::string> &keys, ListPosition
-    // position, long long count) {
-    //    return derived()
-    //        .template command<std::optional<std::pair<std::string,
-    //        std::vector<std::string>>>>(
-    //            std::forward<Func>(func),
-    //            "LMPOP",
-    //            1,
-    //            keys,
-    //            std::to_string(position),
-    //            count);
-    //}
+    std::optional<list_pop_result>
+    lmpop(const std::vector<std::string> &keys, ListPosition position,
+          long long count = 1) {
+        if (keys.empty() || count < 1) {
+            return std::nullopt;
+        }
+        return derived()
+            .template command<std::optional<list_pop_result>>(
+                "LMPOP", keys.size(), keys, std::to_string(position), "COUNT", count)
+            .result();
+    }
+
+    /**
+     * @brief Pop elements from the first non-empty list key asynchronously.
+     * @param func Callback function to handle the result.
+     * @param keys List of keys to check.
+     * @param position Where to pop from (LEFT or RIGHT).
+     * @param count Maximum number of elements to pop.
+     * @return Reference to the derived class.
+     * @note Without keys, or if count is below 1, the callback receives
+     * `std::nullopt` before returning.
+     * @see https://redis.io/commands/lmpop
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<list_pop_result>> &&>,
+                     Derived &>
+    lmpop(Func &&func, const std::vector<std::string> &keys, ListPosition position,
+          long long count = 1) {
+        if (keys.empty() || count < 1) {
+            std::forward<Func>(func)(
+                Reply<std::optional<list_pop_result>>{true, std::nullopt, {}, {}});
+            return derived();
+        }
+        return derived().template command<std::optional<list_pop_result>>(
+            std::forward<Func>(func), "LMPOP", keys.size(), keys,
+            std::to_string(position), "COUNT", count);
+    }
+
+    /**
+     * @brief Pop elements from the first non-empty list key, blocking if they are all
+     * empty.
+     * @param keys List of keys to check.
+     * @param position Where to pop from (LEFT or RIGHT).
+     * @param timeout Timeout in seconds. 0 means block forever.
+     * @param count Maximum number of elements to pop.
+     * @return The key name and the popped elements.
+     * @note If the timeout expires, returns `std::nullopt`.
+     * @see https://redis.io/commands/blmpop
+     */
+    std::optional<list_pop_result>
+    blmpop(const std::vector<std::string> &keys, ListPosition position,
+           double timeout = 0, long long count = 1) {
+        if (keys.empty() || count < 1) {
+            return std::nullopt;
+        }
+        return derived()
+            .template command<std::optional<list_pop_result>>(
+                "BLMPOP", timeout, keys.size(), keys, std::to_string(position), "COUNT",
+                count)
+            .result();
+    }
+
+    /**
+     * @brief Pop elements from the first non-empty list key in a blocking way
+     * asynchronously.
+     * @param func Callback function to handle the result.
+     * @param keys List of keys to check.
+     * @param position Where to pop from (LEFT or RIGHT).
+     * @param timeout Timeout in seconds. 0 means block forever.
+     * @param count Maximum number of elements to pop.
+     * @return Reference to the derived class.
+     * @note Without keys, or if count is below 1, the callback receives
+     * `std::nullopt` before returning.
+     * @see https://redis.io/commands/blmpop
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<list_pop_result>> &&>,
+                     Derived &>
+    blmpop(Func &&func, const std::vector<std::string> &keys, ListPosition position,
+           double timeout = 0, long long count = 1) {
+        if (keys.empty() || count < 1) {
+            std::forward<Func>(func)(
+                Reply<std::optional<list_pop_result>>{true, std::nullopt, {}, {}});
+            return derived();
+        }
+        return derived().template command<std::optional<list_pop_result>>(
+            std::forward<Func>(func), "BLMPOP", timeout, keys.size(), keys,
+            std::to_string(position), "COUNT", count);
+    }
 
     /**
      * @brief Get the position of an element in a list.
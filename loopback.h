@@ -0,0 +1,417 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_LOOPBACK_H
+#define QBM_REDIS_LOOPBACK_H
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "redis.h"
+#include "resp.h"
+
+namespace qb::redis {
+
+/**
+ * @brief Answers a command received by a loopback client
+ *
+ * Appends exactly one encoded reply per command to the second argument.
+ */
+using loopback_responder = std::function<void(const resp_command &, std::string &)>;
+
+namespace responder {
+
+/**
+ * @brief Replies with the first argument of the command as a bulk string,
+ * +PONG to commands without argument
+ *
+ * ECHO and PING behave as on a server, GET returns the name of its key.
+ */
+inline loopback_responder
+echo() {
+    return [](const resp_command &command, std::string &reply) {
+        if (command.argc < 2) {
+            reply += "+PONG\r\n";
+            return;
+        }
+        reply += '$';
+        reply += std::to_string(command.key.size());
+        reply += "\r\n";
+        reply += command.key;
+        reply += "\r\n";
+    };
+}
+
+/**
+ * @brief Replies to every command with the same bytes
+ * @param reply Encoded reply, written as it is, invalid ones included
+ */
+inline loopback_responder
+constant(std::string reply) {
+    return [reply = std::move(reply)](const resp_command &, std::string &out) {
+        out += reply;
+    };
+}
+
+/**
+ * @brief Replies by command name
+ * @param replies Encoded reply of each upper case command name
+ * @param fallback Encoded reply of the other commands
+ */
+inline loopback_responder
+scripted(qb::unordered_map<std::string, std::string> replies,
+         std::string fallback = "-ERR unknown command\r\n") {
+    return [replies = std::move(replies), fallback = std::move(fallback),
+            name = std::string()](const resp_command &command,
+                                  std::string        &reply) mutable {
+        name.assign(command.name);
+        for (auto &c : name)
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        const auto it = replies.find(name);
+        reply += it != replies.end() ? it->second : fallback;
+    };
+}
+
+/**
+ * @brief Replies with the replies of a traffic log, in turn
+ * @param log Log written by a traffic_recorder
+ * @throws std::invalid_argument if the log has no reply or an invalid one
+ */
+inline loopback_responder
+traffic(std::string_view log) {
+    std::string    received;
+    traffic_reader reader(log);
+    traffic_record record;
+    while (reader.next(record))
+        if (record.direction == traffic_direction::IN)
+            received += record.data;
+
+    std::vector<std::string> replies;
+    for (std::size_t pos = 0; pos < received.size();) {
+        const auto size = resp_reply_size(std::string_view(received).substr(pos));
+        if (!size)
+            throw std::invalid_argument("truncated reply in the traffic log");
+        replies.push_back(received.substr(pos, size));
+        pos += size;
+    }
+    if (replies.empty())
+        throw std::invalid_argument("no reply in the traffic log");
+
+    return [replies = std::move(replies), next = std::size_t{0}](
+               const resp_command &, std::string &reply) mutable {
+        reply += replies[next];
+        next = (next + 1) % replies.size();
+    };
+}
+
+} // namespace responder
+
+namespace detail {
+
+/**
+ * @class loopback_socket
+ * @brief In-memory endpoint of a loopback client, holding its responder
+ */
+class loopback_socket {
+    loopback_responder _responder  = responder::echo();
+    std::size_t        _chunk_size = 0;
+    bool               _open       = false;
+
+public:
+    int
+    connect(const qb::io::uri &) {
+        _open = true;
+        return 0;
+    }
+
+    [[nodiscard]] bool
+    is_open() const {
+        return _open;
+    }
+
+    void
+    close() {
+        _open = false;
+    }
+
+    /**
+     * @brief Sets the responder, echo() by default
+     * @return Reference to the socket for chaining
+     */
+    loopback_socket &
+    respond(loopback_responder responder) {
+        _responder = std::move(responder);
+        return *this;
+    }
+
+    /**
+     * @brief Splits the replies passed to the protocol, to stress the parser
+     * @param size Maximum bytes per read, 0 to pass all the replies at once
+     * @return Reference to the socket for chaining
+     */
+    loopback_socket &
+    chunk_size(std::size_t size) {
+        _chunk_size = size;
+        return *this;
+    }
+
+    [[nodiscard]] std::size_t
+    chunk_size() const {
+        return _chunk_size;
+    }
+
+    void
+    answer(const resp_command &command, std::string &replies) {
+        _responder(command, replies);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @struct loopback_transport
+ * @brief In-memory transport, QB_IO_ of clients answered by a responder
+ */
+struct loopback_transport {
+    using transport_io_type = detail::loopback_socket;
+};
+
+namespace detail {
+
+/**
+ * @class loopback_client
+ * @brief Base of connectors on loopback_transport, in place of the qb TCP
+ * client
+ *
+ * Commands written by the client are answered by the responder of the
+ * socket and the replies are passed to the protocol on the next iteration of
+ * the event loop, in the same thread. process() does it at once, without
+ * the event loop, e.g. to time a batch of commands.
+ *
+ * A protocol error disconnects the client, which fails the commands waiting
+ * for a reply.
+ *
+ * @tparam Derived The connector type
+ */
+template <typename Derived>
+class loopback_client {
+    using protocol_type = qb::io::async::AProtocol<Derived>;
+
+    qb::allocator::pipe<char>      _in;
+    qb::allocator::pipe<char>      _out;
+    loopback_socket                _socket;
+    std::unique_ptr<protocol_type> _protocol;
+    std::string                    _replies;
+    bool                           _started    = false;
+    bool                           _scheduled  = false;
+    bool                           _processing = false;
+    bool                           _closing    = false;
+    std::shared_ptr<bool>          _alive = std::make_shared<bool>(true);
+
+    Derived &
+    derived() {
+        return static_cast<Derived &>(*this);
+    }
+
+    void
+    lost() {
+        _started = false;
+        _closing = false;
+        _out.reset();
+        _socket.close();
+        qb::io::async::event::disconnected event{};
+        derived().on(std::move(event));
+    }
+
+    /**
+     * @brief Passes the replies to the protocol, in chunks of chunk_size()
+     * @return false on a protocol error
+     */
+    bool
+    deliver() {
+        const auto chunk = _socket.chunk_size() ? _socket.chunk_size() : _replies.size();
+        for (std::size_t pos = 0; pos < _replies.size() && !_closing; pos += chunk) {
+            _in.write(_replies.data() + pos, std::min(chunk, _replies.size() - pos));
+            const auto size = _protocol->getMessageSize();
+            if (size) {
+                _protocol->onMessage(size);
+                _in.free_front(size);
+            }
+            if (!_protocol->ok())
+                return false;
+        }
+        return true;
+    }
+
+public:
+    loopback_client() = default;
+
+    ~loopback_client() {
+        *_alive = false;
+    }
+
+    loopback_client(const loopback_client &)            = delete;
+    loopback_client &operator=(const loopback_client &) = delete;
+
+    qb::allocator::pipe<char> &
+    in() {
+        return _in;
+    }
+
+    qb::allocator::pipe<char> &
+    out() {
+        return _out;
+    }
+
+    loopback_socket &
+    transport() {
+        return _socket;
+    }
+
+    protocol_type *
+    protocol() {
+        return _protocol.get();
+    }
+
+    void
+    clear_protocols() {
+        _protocol.reset();
+    }
+
+    template <typename Protocol, typename... Args>
+    Protocol *
+    switch_protocol(Args &&...args) {
+        auto protocol = std::make_unique<Protocol>(std::forward<Args>(args)...);
+        auto raw      = protocol.get();
+        _protocol     = std::move(protocol);
+        return raw;
+    }
+
+    void
+    start() {
+        _started = true;
+        _in.reset();
+        _out.reset();
+    }
+
+    /**
+     * @brief Schedules the answer of the commands being written
+     */
+    void
+    ready_to_write() {
+        if (_scheduled)
+            return;
+        _scheduled = true;
+        qb::io::async::callback(
+            [this, alive = _alive]() {
+                if (*alive)
+                    process();
+            },
+            0);
+    }
+
+    /**
+     * @brief Answers the written commands and dispatches the replies
+     */
+    void
+    process() {
+        _scheduled = false;
+        if (_processing)
+            return;
+        if (!_started || !_protocol) {
+            // Commands written after a disconnection fail
+            if (!_out.empty())
+                lost();
+            return;
+        }
+
+        _processing = true;
+        bool ok     = true;
+        try {
+            resp_command command;
+            std::size_t  size;
+            while (!_out.empty() &&
+                   (size = resp_command_size({_out.begin(), _out.size()}, command))) {
+                _socket.answer(command, _replies);
+                _out.free_front(size);
+            }
+            ok = deliver();
+        } catch (const std::exception &) {
+            ok = false;
+        }
+        _replies.clear();
+        _in.reset();
+        _processing = false;
+
+        if (!ok || _closing)
+            lost();
+        else if (!_out.empty())
+            ready_to_write();
+    }
+
+    /**
+     * @brief Answers the written commands, then disconnects
+     */
+    void
+    disconnect(int = 0) {
+        if (!_started)
+            return;
+        if (_processing) {
+            _closing = true;
+            return;
+        }
+        process();
+        if (_started)
+            lost();
+    }
+
+    [[nodiscard]] bool
+    is_alive() const {
+        return _started;
+    }
+};
+
+template <typename Derived>
+struct connector_client<Derived, loopback_transport> {
+    using type = loopback_client<Derived>;
+};
+
+} // namespace detail
+
+/**
+ * @struct loopback
+ * @brief Client types on loopback_transport
+ *
+ * @code
+ * qb::redis::loopback::client redis{"loopback://"};
+ * redis.transport().respond(qb::redis::responder::scripted({{"GET", "$1\r\nv\r\n"}}));
+ * redis.connect();
+ * redis.get("key"); // "v", without any socket
+ * @endcode
+ */
+struct loopback {
+    using client = detail::Redis<loopback_transport>;
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_LOOPBACK_H
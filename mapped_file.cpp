@@ -0,0 +1,75 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <stdexcept>
+#include "mapped_file.h"
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace qb::redis {
+
+#ifdef _WIN32
+
+mapped_file::mapped_file(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("unable to open " + path);
+    _buffer.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+    if (_buffer.empty())
+        throw std::runtime_error("unable to read " + path);
+    _data = _buffer.data();
+    _size = _buffer.size();
+}
+
+mapped_file::~mapped_file() = default;
+
+#else
+
+mapped_file::mapped_file(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("unable to open " + path);
+    struct stat st {};
+    if (::fstat(fd, &st) < 0 || st.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("unable to read " + path);
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void      *map  = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        throw std::runtime_error("unable to map " + path);
+    ::madvise(map, size, MADV_SEQUENTIAL);
+    _data = static_cast<const char *>(map);
+    _size = size;
+}
+
+mapped_file::~mapped_file() {
+    ::munmap(const_cast<char *>(_data), _size);
+}
+
+#endif
+
+} // namespace qb::redis
@@ -0,0 +1,65 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_MAPPED_FILE_H
+#define QBM_REDIS_MAPPED_FILE_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace qb::redis {
+
+/**
+ * @class mapped_file
+ * @brief Read-only file mapped in memory for a sequential scan
+ *
+ * The content is read on demand by the kernel and never copied, so files
+ * larger than the memory can be parsed. On Windows the file is read into a
+ * buffer instead.
+ */
+class mapped_file {
+public:
+    /**
+     * @brief Maps a file
+     * @param path Path of the file
+     * @throws std::runtime_error if the file can not be opened or is empty
+     */
+    explicit mapped_file(const std::string &path);
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    /**
+     * @brief Gets the content of the file
+     */
+    [[nodiscard]] std::string_view
+    data() const {
+        return {_data, _size};
+    }
+
+private:
+    const char *_data = nullptr;
+    std::size_t _size = 0;
+#ifdef _WIN32
+    std::string _buffer;
+#endif
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_MAPPED_FILE_H
@@ -0,0 +1,430 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_RATE_LIMITER_H
+#define QBM_REDIS_RATE_LIMITER_H
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "redis.h"
+
+namespace qb::redis {
+
+/**
+ * @enum RateAlgorithm
+ * @brief Algorithm of the bucket shared on the server
+ */
+enum class RateAlgorithm {
+    SLIDING_WINDOW, ///< Weighted sum of the current and previous windows
+    GCRA            ///< Generic cell rate algorithm, one timestamp per key
+};
+
+namespace detail {
+
+/**
+ * @brief Leases up to ARGV[3] tokens from a sliding window and returns the
+ * tokens granted and the index of their window. When ARGV[3] is negative,
+ * gives back the tokens of the (window, tokens) pairs following it and
+ * returns the number of tokens taken back.
+ */
+inline const script &
+sliding_window_script() {
+    static const script s{R"(
+local limit = tonumber(ARGV[1])
+local window = tonumber(ARGV[2])
+local count = tonumber(ARGV[3])
+local t = redis.call('TIME')
+local now = t[1] * 1000 + math.floor(t[2] / 1000)
+local current = math.floor(now / window)
+local used = tonumber(redis.call('HGET', KEYS[1], current) or '0')
+if count < 0 then
+    local back = 0
+    for i = 4, #ARGV, 2 do
+        local counted = tonumber(redis.call('HGET', KEYS[1], ARGV[i]) or '0')
+        local moved = math.min(counted, tonumber(ARGV[i + 1]))
+        if moved > 0 then
+            redis.call('HINCRBY', KEYS[1], ARGV[i], -moved)
+            back = back + moved
+        end
+    end
+    return back
+end
+local previous = tonumber(redis.call('HGET', KEYS[1], current - 1) or '0')
+local weight = 1 - (now % window) / window
+local granted = math.min(count, limit - used - math.ceil(previous * weight))
+if granted <= 0 then
+    return {0, current}
+end
+for _, field in ipairs(redis.call('HKEYS', KEYS[1])) do
+    if tonumber(field) < current - 1 then
+        redis.call('HDEL', KEYS[1], field)
+    end
+end
+redis.call('HINCRBY', KEYS[1], current, granted)
+redis.call('PEXPIRE', KEYS[1], window * 2)
+return {granted, current}
+)"};
+    return s;
+}
+
+/**
+ * @brief Leases up to ARGV[3] tokens from a GCRA bucket and returns the
+ * tokens granted and 0, or gives back -ARGV[3] tokens when negative and
+ * returns the number of tokens taken back.
+ */
+inline const script &
+gcra_script() {
+    static const script s{R"(
+local limit = tonumber(ARGV[1])
+local period = tonumber(ARGV[2])
+local count = tonumber(ARGV[3])
+local interval = period / limit
+local t = redis.call('TIME')
+local now = t[1] * 1000 + t[2] / 1000
+local tat = math.max(tonumber(redis.call('GET', KEYS[1]) or '0'), now)
+local moved
+if count < 0 then
+    moved = math.min(-count, math.floor((tat - now) / interval))
+    tat = tat - moved * interval
+else
+    moved = math.min(count, math.floor((now + period - tat) / interval))
+    if moved <= 0 then
+        return {0, 0}
+    end
+    tat = tat + moved * interval
+end
+if tat > now then
+    redis.call('SET', KEYS[1], string.format('%.3f', tat), 'PX', math.ceil(tat - now))
+else
+    redis.call('DEL', KEYS[1])
+end
+if count < 0 then
+    return moved
+end
+return {moved, 0}
+)"};
+    return s;
+}
+
+} // namespace detail
+
+/**
+ * @class rate_limiter
+ * @brief Rate limiter leasing batches of tokens from a bucket on the server
+ *
+ * The bucket is shared by every process using the same key and updated by a
+ * Lua script. Instead of one EVALSHA per request, the limiter leases up to
+ * lease_size tokens at once and serves the requests locally. When the local
+ * tokens fall to refill_below, the next lease is requested in the background,
+ * so the hot path does not wait for a round trip while the bucket has tokens.
+ *
+ * Leased tokens are only valid locally for lease_ttl: a token used long after
+ * it was granted would count against a window that is already gone. The
+ * shorter the ttl and the smaller the leases, the closer the effective rate is
+ * to the limit. Call release() on shutdown to give the unused tokens back.
+ *
+ * The limiter must be used on the event loop thread of its client, and outlive
+ * its pending leases.
+ *
+ * @tparam QB_IO_ The QB I/O type of the client
+ */
+template <typename QB_IO_>
+class rate_limiter {
+public:
+    using client_type = detail::Redis<QB_IO_>;
+    using clock       = std::chrono::steady_clock;
+
+    /**
+     * @struct options
+     * @brief Limit and lease policy of a rate limiter
+     */
+    struct options {
+        RateAlgorithm             algorithm = RateAlgorithm::SLIDING_WINDOW;
+        long long                 limit     = 100; ///< Tokens per period
+        std::chrono::milliseconds period{1000};    ///< Window or emission period
+        long long                 lease_size   = 10; ///< Tokens asked per lease
+        long long                 refill_below = 5;  ///< Tokens left asking the next
+        std::chrono::milliseconds lease_ttl{100};    ///< Local validity of a lease
+    };
+
+private:
+    struct lease {
+        long long         tokens;
+        long long         window; ///< Window the tokens are counted in
+        clock::time_point expires;
+    };
+
+    struct waiter {
+        long long                        tokens;
+        std::function<void(Reply<bool>)> func;
+    };
+
+    client_type       &_redis;
+    std::string        _key;
+    options            _opts;
+    script             _script;
+    std::deque<lease>  _leases;
+    std::deque<waiter> _waiters;
+    long long          _tokens  = 0;
+    bool               _leasing = false;
+    std::uint64_t      _leased  = 0;
+
+    std::vector<std::string>
+    arguments(long long count) const {
+        return {std::to_string(_opts.limit), std::to_string(_opts.period.count()),
+                std::to_string(count)};
+    }
+
+    /**
+     * @brief Drops the expired leases
+     */
+    void
+    prune() {
+        const auto now = clock::now();
+        while (!_leases.empty() && _leases.front().expires <= now) {
+            _tokens -= _leases.front().tokens;
+            _leases.pop_front();
+        }
+    }
+
+    /**
+     * @brief Takes tokens from the oldest leases first
+     */
+    void
+    take(long long count) {
+        _tokens -= count;
+        while (count) {
+            auto &front = _leases.front();
+            const auto used = std::min(count, front.tokens);
+            front.tokens -= used;
+            count -= used;
+            if (!front.tokens)
+                _leases.pop_front();
+        }
+    }
+
+    /**
+     * @brief Requests a lease unless one is in flight or enough tokens are left
+     */
+    void
+    refill() {
+        if (_leasing || (_tokens > _opts.refill_below && _waiters.empty()))
+            return;
+        long long ask = _opts.lease_size;
+        for (const auto &w : _waiters)
+            ask += w.tokens;
+        _leasing = true;
+        _redis.template evalsha<std::vector<long long>>(
+            [this](auto &&reply) { leased(std::forward<decltype(reply)>(reply)); },
+            _script, {_key}, arguments(ask));
+    }
+
+    void
+    leased(Reply<std::vector<long long>> &&reply) {
+        _leasing = false;
+        const auto     &moved   = reply.result();
+        const long long granted = reply.ok() && moved.size() == 2 ? moved[0] : 0;
+        if (granted > 0) {
+            _leases.push_back({granted, moved[1], clock::now() + _opts.lease_ttl});
+            _tokens += granted;
+            ++_leased;
+        }
+
+        // Waiters must not be served from leases past lease_ttl
+        prune();
+        while (!_waiters.empty() && _tokens >= _waiters.front().tokens) {
+            auto w = std::move(_waiters.front());
+            _waiters.pop_front();
+            take(w.tokens);
+            w.func(Reply<bool>{true, true, {}, {}});
+        }
+        // An empty bucket or an error denies the requests still waiting, and the
+        // next lease waits for the next request
+        if (granted <= 0) {
+            auto waiters = std::move(_waiters);
+            _waiters     = {};
+            for (auto &w : waiters)
+                w.func(Reply<bool>{reply.ok(), false, {}, reply.error()});
+            return;
+        }
+        refill();
+    }
+
+public:
+    /**
+     * @brief Constructs a rate limiter
+     * @param redis Client running the scripts
+     * @param key Key of the bucket on the server
+     * @param opts Limit and lease policy
+     */
+    rate_limiter(client_type &redis, std::string key, options opts = {})
+        : _redis(redis)
+        , _key(std::move(key))
+        , _opts(opts)
+        , _script(opts.algorithm == RateAlgorithm::GCRA
+                      ? detail::gcra_script()
+                      : detail::sliding_window_script()) {
+        if (_opts.limit <= 0 || _opts.period.count() <= 0 || _opts.lease_size <= 0)
+            throw std::invalid_argument(
+                "rate_limiter: limit, period and lease_size must be positive");
+        _redis.register_script(_script);
+    }
+
+    rate_limiter(const rate_limiter &) = delete;
+    rate_limiter &operator=(const rate_limiter &) = delete;
+
+    /**
+     * @brief Takes tokens from the local leases without waiting
+     *
+     * Requests the next lease in the background when the local tokens run low.
+     *
+     * @param tokens Number of tokens to take
+     * @return true if the tokens were available locally
+     * @throws std::invalid_argument if tokens is not positive
+     */
+    bool
+    try_acquire(long long tokens = 1) {
+        if (tokens <= 0)
+            throw std::invalid_argument("rate_limiter: tokens must be positive");
+        prune();
+        const bool acquired = _waiters.empty() && _tokens >= tokens;
+        if (acquired)
+            take(tokens);
+        refill();
+        return acquired;
+    }
+
+    /**
+     * @brief Takes tokens, leasing them from the server if needed
+     * @param tokens Number of tokens to take
+     * @return true if the tokens were granted, false if the limit is reached
+     * @throws std::invalid_argument if tokens is not positive
+     * @throws std::runtime_error if the script failed
+     */
+    bool
+    acquire(long long tokens = 1) {
+        return sync_result<bool>([this, tokens](auto &&func) { acquire(func, tokens); });
+    }
+
+    /**
+     * @brief Takes tokens asynchronously, leasing them from the server if needed
+     *
+     * The callback is invoked before returning when the tokens are available
+     * locally. Requests waiting for a lease are served in order.
+     *
+     * @param func Callback receiving true if the tokens were granted
+     * @param tokens Number of tokens to take
+     * @return Reference to the limiter for chaining
+     * @throws std::invalid_argument if tokens is not positive
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<bool> &&>, rate_limiter &>
+    acquire(Func &&func, long long tokens = 1) {
+        if (try_acquire(tokens)) {
+            std::forward<Func>(func)(Reply<bool>{true, true, {}, {}});
+            return *this;
+        }
+        // Shared so that move-only callbacks fit in a std::function
+        auto shared = std::make_shared<std::decay_t<Func>>(std::forward<Func>(func));
+        _waiters.push_back(
+            {tokens, [shared](Reply<bool> reply) { (*shared)(std::move(reply)); }});
+        refill();
+        return *this;
+    }
+
+    /**
+     * @brief Gives the unused tokens back to the bucket and waits for the reply
+     * @return Number of tokens the bucket took back
+     */
+    long long
+    release() {
+        return sync_result<long long>([this](auto &&func) { release(func); });
+    }
+
+    /**
+     * @brief Gives the unused tokens back to the bucket
+     *
+     * With a sliding window, the tokens of each lease are given back to the
+     * window they were counted in, and dropped if that window is gone. A
+     * lease still in flight is kept.
+     *
+     * @param func Callback receiving the number of tokens taken back
+     * @return Reference to the limiter for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, rate_limiter &>
+    release(Func &&func) {
+        prune();
+        const long long unused = _tokens;
+        auto            args   = arguments(-unused);
+        if (_opts.algorithm == RateAlgorithm::SLIDING_WINDOW) {
+            for (std::size_t i = 0; i < _leases.size();) {
+                const auto window = _leases[i].window;
+                long long  tokens = 0;
+                for (; i < _leases.size() && _leases[i].window == window; ++i)
+                    tokens += _leases[i].tokens;
+                args.push_back(std::to_string(window));
+                args.push_back(std::to_string(tokens));
+            }
+        }
+        _leases.clear();
+        _tokens = 0;
+        if (!unused) {
+            std::forward<Func>(func)(Reply<long long>{true, 0, {}, {}});
+            return *this;
+        }
+        _redis.template evalsha<long long>(std::forward<Func>(func), _script, {_key},
+                                           args);
+        return *this;
+    }
+
+    /**
+     * @brief Gets the number of tokens available locally
+     */
+    [[nodiscard]] long long
+    available() {
+        prune();
+        return _tokens;
+    }
+
+    /**
+     * @brief Gets the number of leases granted by the server
+     */
+    [[nodiscard]] std::uint64_t
+    leases() const {
+        return _leased;
+    }
+
+    /**
+     * @brief Gets the key of the bucket
+     */
+    [[nodiscard]] const std::string &
+    key() const {
+        return _key;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_RATE_LIMITER_H
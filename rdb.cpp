@@ -0,0 +1,1128 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include "mapped_file.h"
+#include "rdb.h"
+
+namespace {
+
+// Opcodes preceding the keys
+constexpr std::uint8_t OPCODE_SLOT_INFO       = 244;
+constexpr std::uint8_t OPCODE_FUNCTION2       = 245;
+constexpr std::uint8_t OPCODE_FUNCTION_PRE_GA = 246;
+constexpr std::uint8_t OPCODE_MODULE_AUX      = 247;
+constexpr std::uint8_t OPCODE_IDLE            = 248;
+constexpr std::uint8_t OPCODE_FREQ            = 249;
+constexpr std::uint8_t OPCODE_AUX             = 250;
+constexpr std::uint8_t OPCODE_RESIZEDB        = 251;
+constexpr std::uint8_t OPCODE_EXPIRETIME_MS   = 252;
+constexpr std::uint8_t OPCODE_EXPIRETIME      = 253;
+constexpr std::uint8_t OPCODE_SELECTDB        = 254;
+constexpr std::uint8_t OPCODE_EOF             = 255;
+
+// Stream entry flags
+constexpr long long STREAM_ITEM_DELETED    = 1;
+constexpr long long STREAM_ITEM_SAMEFIELDS = 2;
+
+/**
+ * @brief Signals that an item goes beyond the bytes received
+ */
+struct incomplete {
+    std::size_t wanted; ///< Bytes needed from the start of the item
+};
+
+/**
+ * @brief Element of a ziplist, listpack or intset
+ */
+struct packed {
+    std::string_view str;
+    long long        integer    = 0;
+    bool             is_integer = false;
+};
+
+[[noreturn]] void
+corrupted(const char *what) {
+    throw std::invalid_argument(std::string("invalid RDB dump: ") + what);
+}
+
+inline std::uint64_t
+little(const char *at, std::size_t n) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        value |= std::uint64_t(static_cast<std::uint8_t>(at[i])) << (8 * i);
+    return value;
+}
+
+inline std::uint64_t
+big(const char *at, std::size_t n) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        value = (value << 8) | static_cast<std::uint8_t>(at[i]);
+    return value;
+}
+
+/**
+ * @brief Reads a little endian signed integer of n bytes
+ */
+inline long long
+signed_little(const char *at, std::size_t n) {
+    auto value = little(at, n);
+    if (n < 8 && (value >> (8 * n - 1)) & 1)
+        value |= ~std::uint64_t(0) << (8 * n);
+    return static_cast<long long>(value);
+}
+
+/**
+ * @brief Gets the text of an element, integers being written to buffer
+ */
+inline std::string_view
+text(const packed &e, std::array<char, 24> &buffer) {
+    if (!e.is_integer)
+        return e.str;
+    auto *const begin = buffer.data();
+    const auto  end   = std::to_chars(begin, begin + buffer.size(), e.integer).ptr;
+    return {begin, static_cast<std::size_t>(end - begin)};
+}
+
+inline double
+to_double(std::string_view text) {
+    double value = 0;
+    // from_chars does not accept the leading + of some scores
+    if (!text.empty() && text.front() == '+')
+        text.remove_prefix(1);
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec != std::errc{} || result.ptr != text.data() + text.size())
+        corrupted("invalid score");
+    return value;
+}
+
+inline double
+to_double(const packed &e) {
+    return e.is_integer ? static_cast<double>(e.integer) : to_double(e.str);
+}
+
+/**
+ * @brief Gets the name of a module data type from its 64 bits ID
+ */
+std::string
+module_name(std::uint64_t id) {
+    static constexpr char charset[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    std::string name(9, ' ');
+    id >>= 10;
+    for (int i = 8; i >= 0; --i) {
+        name[i] = charset[id & 63];
+        id >>= 6;
+    }
+    return name;
+}
+
+template <typename F>
+void
+each_ziplist(std::string_view zl, F &&f) {
+    const auto *p    = reinterpret_cast<const std::uint8_t *>(zl.data());
+    std::size_t pos  = 10;
+    auto        need = [&](std::size_t n) {
+        if (n > zl.size() - pos)
+            corrupted("truncated ziplist");
+    };
+    if (zl.size() < 11)
+        corrupted("ziplist too short");
+
+    while (true) {
+        need(1);
+        if (p[pos] == 0xFF)
+            return;
+        pos += p[pos] < 254 ? 1 : 5; // Length of the previous entry
+        need(1);
+        const auto  enc    = p[pos];
+        std::size_t header = 1;
+        std::size_t len    = 0;
+        packed      e;
+        switch (enc >> 6) {
+        case 0:
+            len = enc & 0x3F;
+            break;
+        case 1:
+            need(2);
+            len    = ((enc & 0x3F) << 8) | p[pos + 1];
+            header = 2;
+            break;
+        case 2:
+            need(5);
+            len    = big(zl.data() + pos + 1, 4);
+            header = 5;
+            break;
+        default:
+            e.is_integer = true;
+            switch (enc) {
+            case 0xC0:
+                len = 2;
+                break;
+            case 0xD0:
+                len = 4;
+                break;
+            case 0xE0:
+                len = 8;
+                break;
+            case 0xF0:
+                len = 3;
+                break;
+            case 0xFE:
+                len = 1;
+                break;
+            default:
+                // 4 bits immediate values from 0 to 12
+                if (enc < 0xF1 || enc > 0xFD)
+                    corrupted("invalid ziplist encoding");
+                e.integer = (enc & 0x0F) - 1;
+            }
+        }
+        need(header + len);
+        const char *at = zl.data() + pos + header;
+        if (!e.is_integer)
+            e.str = std::string_view(at, len);
+        else if (len)
+            e.integer = signed_little(at, len);
+        f(e);
+        pos += header + len;
+    }
+}
+
+template <typename F>
+void
+each_listpack(std::string_view lp, F &&f) {
+    const auto *p    = reinterpret_cast<const std::uint8_t *>(lp.data());
+    std::size_t pos  = 6;
+    auto        need = [&](std::size_t n) {
+        if (n > lp.size() - pos)
+            corrupted("truncated listpack");
+    };
+    if (lp.size() < 7)
+        corrupted("listpack too short");
+
+    while (true) {
+        need(1);
+        const auto b = p[pos];
+        if (b == 0xFF)
+            return;
+        std::size_t size   = 1; // Encoding and data
+        std::size_t header = 0; // Encoding of a string
+        packed      e;
+        e.is_integer = true;
+        if (!(b & 0x80)) {
+            e.integer = b & 0x7F;
+        } else if ((b & 0xC0) == 0x80) {
+            e.is_integer = false;
+            header       = 1;
+            size         = 1 + (b & 0x3F);
+        } else if ((b & 0xE0) == 0xC0) {
+            need(2);
+            const long long value = ((b & 0x1F) << 8) | p[pos + 1];
+            e.integer             = value >= 4096 ? value - 8192 : value;
+            size                  = 2;
+        } else if ((b & 0xF0) == 0xE0) {
+            need(2);
+            e.is_integer = false;
+            header       = 2;
+            size         = 2 + (((b & 0x0F) << 8) | p[pos + 1]);
+        } else {
+            std::size_t bytes = 0;
+            switch (b) {
+            case 0xF0:
+                need(5);
+                e.is_integer = false;
+                header       = 5;
+                size         = 5 + little(lp.data() + pos + 1, 4);
+                break;
+            case 0xF1:
+                bytes = 2;
+                break;
+            case 0xF2:
+                bytes = 3;
+                break;
+            case 0xF3:
+                bytes = 4;
+                break;
+            case 0xF4:
+                bytes = 8;
+                break;
+            default:
+                corrupted("invalid listpack encoding");
+            }
+            if (bytes) {
+                need(1 + bytes);
+                e.integer = signed_little(lp.data() + pos + 1, bytes);
+                size      = 1 + bytes;
+            }
+        }
+        // The entry is followed by its own size, stored on 1 to 5 bytes
+        const std::size_t backlen = size <= 127        ? 1
+                                    : size < 16383     ? 2
+                                    : size < 2097151   ? 3
+                                    : size < 268435455 ? 4
+                                                       : 5;
+        need(size + backlen);
+        if (!e.is_integer)
+            e.str = std::string_view(lp.data() + pos + header, size - header);
+        f(e);
+        pos += size + backlen;
+    }
+}
+
+template <typename F>
+void
+each_intset(std::string_view is, F &&f) {
+    if (is.size() < 8)
+        corrupted("intset too short");
+    const auto width = little(is.data(), 4);
+    const auto count = little(is.data() + 4, 4);
+    if ((width != 2 && width != 4 && width != 8) || is.size() != 8 + width * count)
+        corrupted("invalid intset");
+    for (std::size_t i = 0; i < count; ++i) {
+        packed e;
+        e.is_integer = true;
+        e.integer    = signed_little(is.data() + 8 + i * width, width);
+        f(e);
+    }
+}
+
+template <typename F>
+void
+each_zipmap(std::string_view zm, F &&f) {
+    const auto *p    = reinterpret_cast<const std::uint8_t *>(zm.data());
+    std::size_t pos  = 1;
+    auto        need = [&](std::size_t n) {
+        if (n > zm.size() - pos)
+            corrupted("truncated zipmap");
+    };
+    auto length = [&]() -> std::size_t {
+        need(1);
+        if (p[pos] < 254)
+            return p[pos++];
+        if (p[pos] != 254)
+            corrupted("invalid zipmap length");
+        need(5);
+        const auto len = little(zm.data() + pos + 1, 4);
+        pos += 5;
+        return len;
+    };
+
+    while (true) {
+        need(1);
+        if (p[pos] == 0xFF)
+            return;
+        const auto field_len = length();
+        need(field_len);
+        const std::string_view field(zm.data() + pos, field_len);
+        pos += field_len;
+        const auto value_len = length();
+        need(1);
+        const std::size_t free = p[pos++];
+        need(value_len + free);
+        f(field, std::string_view(zm.data() + pos, value_len));
+        pos += value_len + free;
+    }
+}
+
+/**
+ * @brief Groups the elements of a compact encoding by N
+ */
+template <std::size_t N, typename Each, typename F>
+void
+each_group(Each &&each, F &&f) {
+    std::array<packed, N> group;
+    std::size_t           filled = 0;
+    each([&](const packed &e) {
+        group[filled++] = e;
+        if (filled == N) {
+            f(group);
+            filled = 0;
+        }
+    });
+    if (filled)
+        corrupted("incomplete group of elements");
+}
+
+/**
+ * @brief Decodes the entries of a stream listpack
+ *
+ * The node starts with a master entry holding the field names shared by the
+ * entries flagged SAMEFIELDS. IDs are stored as deltas from the node ID.
+ */
+template <typename F>
+void
+each_stream_entry(std::string_view lp, const qb::redis::stream_id &master, F &&f) {
+    std::vector<packed> items;
+    each_listpack(lp, [&](const packed &e) { items.push_back(e); });
+    auto integer = [&](std::size_t i) {
+        if (i >= items.size() || !items[i].is_integer)
+            corrupted("invalid stream entry");
+        return items[i].integer;
+    };
+    auto string = [&](std::size_t i) {
+        if (i >= items.size())
+            corrupted("truncated stream entry");
+        return items[i].is_integer ? std::to_string(items[i].integer)
+                                   : std::string(items[i].str);
+    };
+
+    const auto  fields = static_cast<std::size_t>(integer(2));
+    std::size_t i      = 3 + fields;
+    if (integer(i++) != 0)
+        corrupted("invalid stream master entry");
+    while (i < items.size()) {
+        const auto                flags = integer(i);
+        qb::redis::stream_entry   entry;
+        entry.id = {master.timestamp + integer(i + 1), master.sequence + integer(i + 2)};
+        i += 3;
+        const bool deleted = flags & STREAM_ITEM_DELETED;
+        if (flags & STREAM_ITEM_SAMEFIELDS) {
+            for (std::size_t j = 0; j < fields; ++j, ++i)
+                if (!deleted)
+                    entry.fields.emplace(string(3 + j), string(i));
+        } else {
+            const auto count = static_cast<std::size_t>(integer(i++));
+            for (std::size_t j = 0; j < count; ++j, i += 2)
+                if (!deleted)
+                    entry.fields.emplace(string(i), string(i + 1));
+        }
+        ++i; // Number of items of the entry, to iterate backward
+        if (!deleted)
+            f(entry);
+    }
+}
+
+qb::redis::RdbType
+type_of(std::uint8_t encoding) {
+    using qb::redis::RdbType;
+    switch (encoding) {
+    case 0:
+        return RdbType::STRING;
+    case 1:
+    case 10:
+    case 14:
+    case 18:
+        return RdbType::LIST;
+    case 2:
+    case 11:
+    case 20:
+        return RdbType::SET;
+    case 3:
+    case 5:
+    case 12:
+    case 17:
+        return RdbType::ZSET;
+    case 4:
+    case 9:
+    case 13:
+    case 16:
+    case 22:
+    case 23:
+    case 24:
+    case 25:
+        return RdbType::HASH;
+    case 15:
+    case 19:
+    case 21:
+        return RdbType::STREAM;
+    case 7:
+        return RdbType::MODULE;
+    default:
+        corrupted("unsupported value type");
+    }
+}
+
+} // namespace
+
+namespace qb::redis {
+
+void
+lzf_decompress(std::string_view in, std::size_t size, std::string &out) {
+    out.resize(size);
+    char       *op = out.data();
+    const auto *ip = reinterpret_cast<const std::uint8_t *>(in.data());
+    const auto *in_end = ip + in.size();
+
+    while (ip < in_end) {
+        std::size_t ctrl = *ip++;
+        if (ctrl < 32) {
+            // Literal run of ctrl + 1 bytes
+            ++ctrl;
+            if (ctrl > static_cast<std::size_t>(in_end - ip) ||
+                ctrl > static_cast<std::size_t>(out.data() + size - op))
+                throw std::invalid_argument("corrupted LZF data");
+            std::memcpy(op, ip, ctrl);
+            op += ctrl;
+            ip += ctrl;
+            continue;
+        }
+        // Back reference of len bytes, back + 1 bytes before
+        std::size_t len  = ctrl >> 5;
+        std::size_t back = (ctrl & 0x1F) << 8;
+        if (len == 7) {
+            if (ip == in_end)
+                throw std::invalid_argument("corrupted LZF data");
+            len += *ip++;
+        }
+        if (ip == in_end)
+            throw std::invalid_argument("corrupted LZF data");
+        back += *ip++;
+        len += 2;
+        if (back >= static_cast<std::size_t>(op - out.data()) ||
+            len > static_cast<std::size_t>(out.data() + size - op))
+            throw std::invalid_argument("corrupted LZF data");
+        // Byte by byte, as the reference may overlap the output
+        const char *ref = op - back - 1;
+        for (; len; --len)
+            *op++ = *ref++;
+    }
+    if (op != out.data() + size)
+        throw std::invalid_argument("corrupted LZF data");
+}
+
+/**
+ * @brief Cursor on the bytes of an item
+ *
+ * When emit is false, the item is only measured: nothing is decoded and the
+ * parser state is not modified.
+ */
+struct rdb_parser::reader {
+    const char *data;
+    std::size_t size;
+    bool        emit;
+    std::size_t pos = 0;
+
+    void
+    need(std::size_t n) const {
+        if (n > size - pos)
+            throw incomplete{pos + n};
+    }
+
+    std::uint8_t
+    byte() {
+        need(1);
+        return static_cast<std::uint8_t>(data[pos++]);
+    }
+
+    std::string_view
+    raw(std::size_t n) {
+        need(n);
+        std::string_view view(data + pos, n);
+        pos += n;
+        return view;
+    }
+
+    std::uint64_t
+    little(std::size_t n) {
+        return ::little(raw(n).data(), n);
+    }
+
+    long long
+    millis() {
+        return static_cast<long long>(little(8));
+    }
+
+    std::uint64_t
+    length(bool &encoded) {
+        const auto b = byte();
+        encoded      = false;
+        switch (b >> 6) {
+        case 0:
+            return b & 0x3F;
+        case 1:
+            return ((b & 0x3F) << 8) | byte();
+        case 2:
+            if (b == 0x80)
+                return big(raw(4).data(), 4);
+            if (b == 0x81)
+                return big(raw(8).data(), 8);
+            corrupted("invalid length");
+        default:
+            encoded = true;
+            return b & 0x3F;
+        }
+    }
+
+    std::uint64_t
+    length() {
+        bool encoded;
+        const auto len = length(encoded);
+        if (encoded)
+            corrupted("unexpected encoded length");
+        return len;
+    }
+
+    /**
+     * @brief Reads a string, decompressed or formatted into scratch if needed
+     * @param decode false to skip the string, an empty view is returned
+     */
+    std::string_view
+    string(std::string &scratch, bool decode) {
+        bool       encoded;
+        const auto len = length(encoded);
+        if (!encoded)
+            return raw(len);
+
+        long long value;
+        switch (len) {
+        case 0:
+            value = signed_little(raw(1).data(), 1);
+            break;
+        case 1:
+            value = signed_little(raw(2).data(), 2);
+            break;
+        case 2:
+            value = signed_little(raw(4).data(), 4);
+            break;
+        case 3: {
+            const auto compressed = length();
+            const auto size       = length();
+            const auto in         = raw(compressed);
+            if (!decode)
+                return {};
+            lzf_decompress(in, size, scratch);
+            return scratch;
+        }
+        default:
+            corrupted("invalid string encoding");
+        }
+        if (!decode)
+            return {};
+        scratch.resize(24);
+        const auto result = std::to_chars(scratch.data(), scratch.data() + 24, value);
+        scratch.resize(result.ptr - scratch.data());
+        return scratch;
+    }
+
+    /**
+     * @brief Reads a score of the first sorted set format, stored as text
+     */
+    double
+    text_double() {
+        const auto len = byte();
+        switch (len) {
+        case 253:
+            return std::numeric_limits<double>::quiet_NaN();
+        case 254:
+            return std::numeric_limits<double>::infinity();
+        case 255:
+            return -std::numeric_limits<double>::infinity();
+        default:
+            return to_double(raw(len));
+        }
+    }
+
+    double
+    binary_double() {
+        const auto bits  = little(8);
+        double     value = 0;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Skips a module value, a list of typed fields ending with EOF
+     */
+    void
+    module_value(std::string &scratch) {
+        while (true) {
+            switch (length()) {
+            case 0: // EOF
+                return;
+            case 1: // Signed integer
+            case 2: // Unsigned integer
+                length();
+                break;
+            case 3: // Float
+                raw(4);
+                break;
+            case 4: // Double
+                raw(8);
+                break;
+            case 5: // String
+                string(scratch, false);
+                break;
+            default:
+                corrupted("invalid module value");
+            }
+        }
+    }
+};
+
+void
+rdb_parser::parse(std::string_view data) {
+    consume(data.data(), data.size(), true);
+    finish();
+}
+
+void
+rdb_parser::feed(std::string_view chunk) {
+    if (_done)
+        return;
+    if (_buffer.empty()) {
+        const auto used = consume(chunk.data(), chunk.size(), false);
+        _buffer.assign(chunk.substr(used));
+        return;
+    }
+    _buffer.append(chunk);
+    // The pending item is not retried before the bytes it needs are received
+    if (_buffer.size() < _wanted)
+        return;
+    const auto used = consume(_buffer.data(), _buffer.size(), false);
+    _buffer.erase(0, used);
+}
+
+void
+rdb_parser::finish() const {
+    if (!_done)
+        throw std::invalid_argument("invalid RDB dump: truncated");
+}
+
+std::size_t
+rdb_parser::consume(const char *data, std::size_t size, bool complete) {
+    std::size_t used = 0;
+    _wanted          = 0;
+    while (!_done && used < size) {
+        // Measures the item first, so that an incomplete one is not half visited
+        if (!complete) {
+            reader dry{data + used, size - used, false};
+            try {
+                item(dry);
+            } catch (const incomplete &e) {
+                _wanted = e.wanted;
+                break;
+            }
+        }
+        _mark_pos   = 0;
+        _mark_index = 0;
+        reader r{data + used, size - used, true};
+        try {
+            item(r);
+        } catch (const incomplete &) {
+            corrupted("truncated");
+        }
+        used += r.pos;
+    }
+    return used;
+}
+
+/**
+ * @brief Gets the first element to measure of the pending item
+ *
+ * A dry run skips the elements measured by the previous ones, so that a
+ * large item received in small chunks is walked once and not once per chunk.
+ */
+std::uint64_t
+rdb_parser::resume(reader &r) const {
+    if (r.emit || !_mark_pos)
+        return 0;
+    r.pos = _mark_pos;
+    return _mark_index;
+}
+
+void
+rdb_parser::checkpoint(const reader &r, std::uint64_t index) {
+    if (r.emit)
+        return;
+    _mark_pos   = r.pos;
+    _mark_index = index;
+}
+
+void
+rdb_parser::item(reader &r) {
+    if (!_version) {
+        const auto magic = r.raw(9);
+        int        version = 0;
+        const auto result = std::from_chars(magic.data() + 5, magic.data() + 9, version);
+        if (magic.substr(0, 5) != "REDIS" || result.ptr != magic.data() + 9 || !version)
+            corrupted("bad header");
+        if (r.emit) {
+            _version = version;
+            _visitor.on_version(version);
+        }
+        return;
+    }
+
+    const auto start = r.pos;
+    const auto op    = r.byte();
+    switch (op) {
+    case OPCODE_EOF: {
+        const auto checksum = _version >= 5 ? r.little(8) : 0;
+        if (r.emit) {
+            _done = true;
+            _visitor.on_end(checksum);
+        }
+        return;
+    }
+    case OPCODE_SELECTDB: {
+        const auto db = static_cast<long long>(r.length());
+        if (r.emit) {
+            _db = db;
+            _visitor.on_select_db(db);
+        }
+        return;
+    }
+    case OPCODE_EXPIRETIME: {
+        const auto seconds = static_cast<long long>(r.little(4));
+        if (r.emit)
+            _expire_ms = seconds * 1000;
+        return;
+    }
+    case OPCODE_EXPIRETIME_MS: {
+        const auto ms = r.millis();
+        if (r.emit)
+            _expire_ms = ms;
+        return;
+    }
+    case OPCODE_RESIZEDB: {
+        const auto keys    = r.length();
+        const auto expires = r.length();
+        if (r.emit)
+            _visitor.on_resize_db(keys, expires);
+        return;
+    }
+    case OPCODE_AUX: {
+        const auto field = r.string(_scratch[0], r.emit);
+        const auto value = r.string(_scratch[1], r.emit);
+        if (r.emit)
+            _visitor.on_aux(field, value);
+        return;
+    }
+    case OPCODE_FREQ:
+        r.byte();
+        return;
+    case OPCODE_IDLE:
+        r.length();
+        return;
+    case OPCODE_MODULE_AUX: {
+        const auto id = r.length();
+        r.length(); // When opcode
+        r.length(); // When
+        const auto begin = r.pos;
+        r.module_value(_scratch[0]);
+        if (r.emit)
+            _visitor.on_module_aux(module_name(id),
+                                   std::string_view(r.data + begin, r.pos - begin));
+        return;
+    }
+    case OPCODE_FUNCTION2: {
+        const auto code = r.string(_scratch[0], r.emit);
+        if (r.emit)
+            _visitor.on_function(code);
+        return;
+    }
+    case OPCODE_FUNCTION_PRE_GA:
+        corrupted("pre-GA functions are not supported");
+    case OPCODE_SLOT_INFO:
+        r.length(); // Slot
+        r.length(); // Keys
+        r.length(); // Volatile keys
+        return;
+    default:
+        break;
+    }
+
+    rdb_key key;
+    key.encoding  = op;
+    key.type      = type_of(op);
+    key.db        = _db;
+    key.expire_ms = _expire_ms;
+    key.key       = r.string(_scratch[0], r.emit);
+    bool decode   = false;
+    if (r.emit) {
+        _expire_ms = -1;
+        decode     = _visitor.on_key(key);
+    }
+    value(r, key, decode);
+    if (r.emit)
+        _visitor.on_key_end(key, r.pos - start);
+}
+
+void
+rdb_parser::value(reader &r, const rdb_key &key, bool decode) {
+    auto                &v = _visitor;
+    std::array<char, 24> n1, n2;
+
+    auto list = [&](const packed &e) { v.on_list_element(key, text(e, n1)); };
+    auto set  = [&](const packed &e) { v.on_set_member(key, text(e, n1)); };
+    auto zset = [&](const std::array<packed, 2> &g) {
+        v.on_zset_member(key, text(g[0], n1), to_double(g[1]));
+    };
+    auto hash = [&](const std::array<packed, 2> &g) {
+        v.on_hash_field(key, text(g[0], n1), text(g[1], n2), -1);
+    };
+
+    switch (key.encoding) {
+    case 0: {
+        const auto value = r.string(_scratch[1], decode);
+        if (decode)
+            v.on_string(key, value);
+        break;
+    }
+    case 1:
+    case 2: {
+        const auto count = r.length();
+        for (auto i = resume(r); i < count; checkpoint(r, ++i)) {
+            const auto element = r.string(_scratch[1], decode);
+            if (!decode)
+                continue;
+            if (key.type == RdbType::LIST)
+                v.on_list_element(key, element);
+            else
+                v.on_set_member(key, element);
+        }
+        break;
+    }
+    case 3:
+    case 5: {
+        const auto count = r.length();
+        for (auto i = resume(r); i < count; checkpoint(r, ++i)) {
+            const auto member = r.string(_scratch[1], decode);
+            const auto score  = key.encoding == 5 ? r.binary_double() : r.text_double();
+            if (decode)
+                v.on_zset_member(key, member, score);
+        }
+        break;
+    }
+    case 4: {
+        const auto count = r.length();
+        for (auto i = resume(r); i < count; checkpoint(r, ++i)) {
+            const auto field = r.string(_scratch[1], decode);
+            const auto value = r.string(_scratch[2], decode);
+            if (decode)
+                v.on_hash_field(key, field, value, -1);
+        }
+        break;
+    }
+    case 7: {
+        const auto id    = r.length();
+        const auto begin = r.pos;
+        r.module_value(_scratch[1]);
+        if (decode)
+            v.on_module(key, module_name(id),
+                        std::string_view(r.data + begin, r.pos - begin));
+        break;
+    }
+    case 9: {
+        const auto blob = r.string(_scratch[1], decode);
+        if (decode)
+            each_zipmap(blob, [&](std::string_view field, std::string_view value) {
+                v.on_hash_field(key, field, value, -1);
+            });
+        break;
+    }
+    case 10:
+    case 12:
+    case 13: {
+        const auto blob = r.string(_scratch[1], decode);
+        if (!decode)
+            break;
+        auto each = [&](auto &&f) { each_ziplist(blob, f); };
+        if (key.encoding == 10)
+            each(list);
+        else if (key.encoding == 12)
+            each_group<2>(each, zset);
+        else
+            each_group<2>(each, hash);
+        break;
+    }
+    case 11: {
+        const auto blob = r.string(_scratch[1], decode);
+        if (decode)
+            each_intset(blob, set);
+        break;
+    }
+    case 14: {
+        const auto nodes = r.length();
+        for (auto i = resume(r); i < nodes; checkpoint(r, ++i)) {
+            const auto blob = r.string(_scratch[1], decode);
+            if (decode)
+                each_ziplist(blob, list);
+        }
+        break;
+    }
+    case 15:
+    case 19:
+    case 21:
+        stream(r, key, decode);
+        break;
+    case 16:
+    case 17:
+    case 20: {
+        const auto blob = r.string(_scratch[1], decode);
+        if (!decode)
+            break;
+        auto each = [&](auto &&f) { each_listpack(blob, f); };
+        if (key.encoding == 16)
+            each_group<2>(each, hash);
+        else if (key.encoding == 17)
+            each_group<2>(each, zset);
+        else
+            each(set);
+        break;
+    }
+    case 18: {
+        const auto nodes = r.length();
+        for (auto i = resume(r); i < nodes; checkpoint(r, ++i)) {
+            const auto container = r.length();
+            const auto blob      = r.string(_scratch[1], decode);
+            if (!decode)
+                continue;
+            // Large elements are stored alone in a plain node
+            if (container == 1)
+                v.on_list_element(key, blob);
+            else
+                each_listpack(blob, list);
+        }
+        break;
+    }
+    case 22:
+    case 24: {
+        // Field TTLs are stored relative to the smallest one, 0 meaning none.
+        // They were absolute in the pre-GA format.
+        const auto min   = key.encoding == 24 ? r.millis() : 1;
+        const auto count = r.length();
+        for (auto i = resume(r); i < count; checkpoint(r, ++i)) {
+            const auto ttl   = static_cast<long long>(r.length());
+            const auto field = r.string(_scratch[1], decode);
+            const auto value = r.string(_scratch[2], decode);
+            if (decode)
+                v.on_hash_field(key, field, value, ttl ? ttl + min - 1 : -1);
+        }
+        break;
+    }
+    case 23:
+    case 25: {
+        if (key.encoding == 25)
+            r.millis(); // Smallest field TTL
+        const auto blob = r.string(_scratch[1], decode);
+        if (decode)
+            each_group<3>([&](auto &&f) { each_listpack(blob, f); },
+                          [&](const std::array<packed, 3> &g) {
+                              const auto ttl = g[2].integer;
+                              v.on_hash_field(key, text(g[0], n1), text(g[1], n2),
+                                              g[2].is_integer && ttl ? ttl : -1);
+                          });
+        break;
+    }
+    default:
+        corrupted("unsupported value type");
+    }
+}
+
+void
+rdb_parser::stream(reader &r, const rdb_key &key, bool decode) {
+    const auto nodes = r.length();
+    for (auto i = resume(r); i < nodes; checkpoint(r, ++i)) {
+        const auto node = r.string(_scratch[1], decode);
+        const auto lp   = r.string(_scratch[2], decode);
+        if (!decode)
+            continue;
+        if (node.size() != 16)
+            corrupted("invalid stream node ID");
+        const stream_id master{static_cast<long long>(big(node.data(), 8)),
+                               static_cast<long long>(big(node.data() + 8, 8))};
+        each_stream_entry(lp, master, [&](const stream_entry &entry) {
+            _visitor.on_stream_entry(key, entry);
+        });
+    }
+
+    r.length(); // Number of entries
+    r.length(); // Last ID
+    r.length();
+    if (key.encoding >= 19)
+        for (int i = 0; i < 5; ++i) // First ID, max deleted ID, entries added
+            r.length();
+
+    const auto groups = r.length();
+    for (std::uint64_t i = 0; i < groups; ++i) {
+        const auto name = r.string(_scratch[1], decode);
+        stream_id  last;
+        last.timestamp = static_cast<long long>(r.length());
+        last.sequence  = static_cast<long long>(r.length());
+        if (key.encoding >= 19)
+            r.length(); // Entries read
+        // Pending entries: ID, delivery time and count
+        const auto pending = r.length();
+        for (std::uint64_t j = 0; j < pending; ++j) {
+            r.raw(16);
+            r.raw(8);
+            r.length();
+        }
+        const auto consumers = r.length();
+        for (std::uint64_t j = 0; j < consumers; ++j) {
+            r.string(_scratch[2], false);
+            r.raw(8); // Seen time
+            if (key.encoding >= 21)
+                r.raw(8); // Active time
+            const auto owned = r.length();
+            r.raw(16 * owned);
+        }
+        if (decode)
+            _visitor.on_stream_group(key, name, last);
+    }
+}
+
+void
+rdb_parser::parse_file(const std::string &path, rdb_visitor &visitor) {
+    const mapped_file file(path);
+    rdb_parser(visitor).parse(file.data());
+}
+
+void
+rdb_parser::parse_files(const std::vector<std::string> &paths,
+                        const std::vector<rdb_visitor *> &visitors, unsigned threads) {
+    if (paths.size() != visitors.size())
+        throw std::invalid_argument("parse_files: one visitor per file is required");
+    if (!threads)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, paths.size()));
+
+    std::atomic<std::size_t>        next{0};
+    std::vector<std::exception_ptr> errors(paths.size());
+    auto                            work = [&]() {
+        for (auto i = next++; i < paths.size(); i = next++) {
+            try {
+                parse_file(paths[i], *visitors[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+        pool.emplace_back(work);
+    work();
+    for (auto &thread : pool)
+        thread.join();
+    for (const auto &error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+} // namespace qb::redis
@@ -0,0 +1,280 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_RDB_H
+#define QBM_REDIS_RDB_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <qb/system/container/unordered_map.h>
+#include "types.h"
+
+namespace qb::redis {
+
+/**
+ * @enum RdbType
+ * @brief Data type of a key stored in an RDB file
+ */
+enum class RdbType {
+    STRING, ///< String
+    LIST,   ///< List, any encoding
+    SET,    ///< Set, any encoding
+    ZSET,   ///< Sorted set, any encoding
+    HASH,   ///< Hash, any encoding, with or without field expiration
+    STREAM, ///< Stream
+    MODULE  ///< Value of a module data type
+};
+
+/**
+ * @struct rdb_key
+ * @brief Key being read from an RDB file
+ */
+struct rdb_key {
+    std::string_view key;              ///< Key name, valid until on_key_end()
+    RdbType          type = RdbType::STRING;
+    std::uint8_t     encoding  = 0;    ///< RDB type byte, e.g. 16 for a listpack hash
+    long long        db        = 0;    ///< Database of the key
+    long long        expire_ms = -1;   ///< Unix time of expiration in ms, -1 if none
+};
+
+/**
+ * @class rdb_visitor
+ * @brief Receives the content of an RDB file from rdb_parser
+ *
+ * Every method does nothing by default. Strings are views on the parsed data
+ * or on a buffer of the parser, only valid during the call: copy what must be
+ * kept.
+ */
+class rdb_visitor {
+public:
+    virtual ~rdb_visitor() = default;
+
+    /**
+     * @brief Called after the header with the RDB format version
+     */
+    virtual void
+    on_version(int) {}
+
+    /**
+     * @brief Called for each auxiliary field, e.g. redis-ver or used-mem
+     */
+    virtual void
+    on_aux(std::string_view, std::string_view) {}
+
+    /**
+     * @brief Called when the following keys belong to another database
+     */
+    virtual void
+    on_select_db(long long) {}
+
+    /**
+     * @brief Called with the number of keys and of volatile keys of the database
+     */
+    virtual void
+    on_resize_db(std::uint64_t, std::uint64_t) {}
+
+    /**
+     * @brief Called before the value of a key
+     * @return false to skip the value, which is then not decoded
+     */
+    virtual bool
+    on_key(const rdb_key &) {
+        return true;
+    }
+
+    virtual void
+    on_string(const rdb_key &, std::string_view) {}
+
+    virtual void
+    on_list_element(const rdb_key &, std::string_view) {}
+
+    virtual void
+    on_set_member(const rdb_key &, std::string_view) {}
+
+    virtual void
+    on_zset_member(const rdb_key &, std::string_view, double) {}
+
+    /**
+     * @brief Called for each field of a hash, with its expiration in unix ms or -1
+     */
+    virtual void
+    on_hash_field(const rdb_key &, std::string_view, std::string_view, long long) {}
+
+    /**
+     * @brief Called for each entry of a stream, deleted entries excluded
+     */
+    virtual void
+    on_stream_entry(const rdb_key &, const stream_entry &) {}
+
+    /**
+     * @brief Called for each consumer group of a stream, with its last delivered ID
+     */
+    virtual void
+    on_stream_group(const rdb_key &, std::string_view, const stream_id &) {}
+
+    /**
+     * @brief Called with the module type name and the serialized module value
+     */
+    virtual void
+    on_module(const rdb_key &, std::string_view, std::string_view) {}
+
+    /**
+     * @brief Called after the value of a key, with its size in the file in bytes
+     */
+    virtual void
+    on_key_end(const rdb_key &, std::size_t) {}
+
+    /**
+     * @brief Called with the module type name and the serialized auxiliary data
+     */
+    virtual void
+    on_module_aux(std::string_view, std::string_view) {}
+
+    /**
+     * @brief Called with the code of each function library
+     */
+    virtual void
+    on_function(std::string_view) {}
+
+    /**
+     * @brief Called at the end of the file with its CRC64, 0 if disabled
+     */
+    virtual void
+    on_end(std::uint64_t) {}
+};
+
+/**
+ * @brief Decompresses an LZF block, as stored in RDB files
+ *
+ * @param in Compressed data
+ * @param size Size of the decompressed data
+ * @param out Buffer receiving the decompressed data
+ * @throws std::invalid_argument if the data is corrupted
+ */
+void lzf_decompress(std::string_view in, std::size_t size, std::string &out);
+
+/**
+ * @class rdb_parser
+ * @brief Streaming parser of RDB files (formats 1 to 12)
+ *
+ * Decodes every value encoding: plain, LZF compressed and integer strings,
+ * linked lists, ziplists, quicklists, listpacks, intsets, zipmaps, streams
+ * and module values. Compact encodings are walked in place and never turned
+ * into intermediate containers.
+ *
+ * A complete dump, e.g. a memory-mapped file, is parsed with parse() without
+ * copying. Bytes received in chunks, e.g. from replica::on_rdb(), are passed
+ * to feed(): only the key being received is buffered, so the memory used is
+ * bounded by the largest value and not by the size of the dump.
+ *
+ * The CRC64 of the file is passed to the visitor but not verified.
+ */
+class rdb_parser {
+public:
+    /**
+     * @brief Constructs a parser
+     * @param visitor Receiver of the content, must outlive the parser
+     */
+    explicit rdb_parser(rdb_visitor &visitor)
+        : _visitor(visitor) {}
+
+    /**
+     * @brief Parses a complete dump
+     * @param data Whole RDB file
+     * @throws std::invalid_argument if the dump is invalid or truncated
+     */
+    void parse(std::string_view data);
+
+    /**
+     * @brief Parses the next bytes of a dump
+     * @param chunk Bytes following the previous chunk
+     * @throws std::invalid_argument if the dump is invalid
+     */
+    void feed(std::string_view chunk);
+
+    /**
+     * @brief Checks that the fed dump is complete
+     * @throws std::invalid_argument if the end of the dump was not received
+     */
+    void finish() const;
+
+    /**
+     * @brief Checks whether the end of the dump was parsed
+     */
+    [[nodiscard]] bool
+    done() const {
+        return _done;
+    }
+
+    /**
+     * @brief Gets the RDB format version, 0 before the header
+     */
+    [[nodiscard]] int
+    version() const {
+        return _version;
+    }
+
+    /**
+     * @brief Parses an RDB file mapped in memory
+     * @param path Path of the file
+     * @param visitor Receiver of the content
+     * @throws std::runtime_error if the file can not be read
+     * @throws std::invalid_argument if the dump is invalid
+     */
+    static void parse_file(const std::string &path, rdb_visitor &visitor);
+
+    /**
+     * @brief Parses RDB files in parallel, one visitor per file
+     *
+     * Every file is parsed even if another one fails.
+     *
+     * @param paths Paths of the files
+     * @param visitors Receiver of each file, same size as paths
+     * @param threads Number of threads, 0 for the number of cores
+     * @throws the error of the first file that failed
+     */
+    static void parse_files(const std::vector<std::string> &paths,
+                            const std::vector<rdb_visitor *> &visitors,
+                            unsigned threads = 0);
+
+private:
+    struct reader;
+
+    rdb_visitor  &_visitor;
+    std::string   _buffer;
+    std::string   _scratch[3];
+    int           _version   = 0;
+    long long     _db        = 0;
+    long long     _expire_ms = -1;
+    std::size_t   _wanted    = 0; // Bytes needed by the pending item
+    // Where the measure of the pending item resumes, after its last element
+    std::size_t   _mark_pos   = 0;
+    std::uint64_t _mark_index = 0;
+    bool          _done       = false;
+
+    std::size_t   consume(const char *data, std::size_t size, bool complete);
+    std::uint64_t resume(reader &r) const;
+    void          checkpoint(const reader &r, std::uint64_t index);
+    void          item(reader &r);
+    void          value(reader &r, const rdb_key &key, bool decode);
+    void          stream(reader &r, const rdb_key &key, bool decode);
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_RDB_H
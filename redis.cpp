@@ -349,6 +349,19 @@ to_string(qb::redis::GeoUnit op) {
     return {};
 }
 
+std::string
+to_string(qb::redis::GeoSort op) {
+    switch (op) {
+        case qb::redis::GeoSort::ASC:
+            return "ASC";
+        case qb::redis::GeoSort::DESC:
+            return "DESC";
+        case qb::redis::GeoSort::NONE:
+            break;
+    }
+    return {};
+}
+
 std::string
 to_string(qb::redis::InsertPosition pos) {
     switch (pos) {
@@ -371,4 +384,15 @@ to_string(qb::redis::ListPosition pos) {
     return {};
 }
 
+std::string
+to_string(qb::redis::SortedSetPosition pos) {
+    switch (pos) {
+        case qb::redis::SortedSetPosition::MIN:
+            return "MIN";
+        case qb::redis::SortedSetPosition::MAX:
+            return "MAX";
+    }
+    return {};
+}
+
 } // namespace std
\ No newline at end of file
@@ -17,10 +17,12 @@
 
 #ifndef QBM_REDIS_H
 #define QBM_REDIS_H
+#include <memory>
 #include <queue>
 #include <utility>
 #include <qb/io/async.h>
 #include <qb/io/async/tcp/connector.h>
+#include "traffic.h"
 // commands trait
 #include "connection_commands.h"
 #include "server_commands.h"
@@ -103,6 +105,8 @@ public:
             this->not_ok();
             return 0;
         }
+        this->_io.on_traffic(qb::redis::traffic_direction::IN, this->_io.in().begin(),
+                             this->_io.in().size());
         return this->_io.in().size();
     }
 
@@ -116,11 +120,15 @@ public:
             return;
 
         message msg;
-        while (redisReaderGetReply(reader_, reinterpret_cast<void **>(&msg.reply)) ==
-                   REDIS_OK &&
+        int     status;
+        while ((status = redisReaderGetReply(
+                    reader_, reinterpret_cast<void **>(&msg.reply))) == REDIS_OK &&
                msg.reply != nullptr) {
             this->_io.on(msg);
         }
+        // A malformed reply leaves the reader in error, nothing can follow
+        if (qb__unlikely(status != REDIS_OK))
+            this->not_ok();
 
         reset();
     }
@@ -139,6 +147,18 @@ namespace qb::redis {
 namespace detail {
 using namespace qb::io;
 
+/**
+ * @struct connector_client
+ * @brief Selects the client class a connector derives from
+ *
+ * Socket transports use the qb TCP client, other transports such as
+ * loopback_transport specialize it.
+ */
+template <typename Derived, typename QB_IO_>
+struct connector_client {
+    using type = qb::io::async::tcp::client<Derived, QB_IO_, void>;
+};
+
 /**
  * @class connector
  * @brief Base class for Redis client connections
@@ -150,11 +170,11 @@ using namespace qb::io;
  * @tparam Derived The derived class (CRTP pattern)
  */
 template <typename QB_IO_, typename Derived>
-class connector
-    : public qb::io::async::tcp::client<connector<QB_IO_, Derived>, QB_IO_, void> {
+class connector : public connector_client<connector<QB_IO_, Derived>, QB_IO_>::type {
     friend class has_method_on<connector<QB_IO_, Derived>, void,
                                qb::io::async::event::disconnected>;
     friend class qb::io::async::io<connector<QB_IO_, Derived>>;
+    friend typename connector_client<connector<QB_IO_, Derived>, QB_IO_>::type;
     friend class qb::protocol::redis<connector<QB_IO_, Derived>>;
     constexpr Derived &
     derived() {
@@ -165,7 +185,8 @@ public:
     using redis_protocol = qb::protocol::redis<connector<QB_IO_, Derived>>;
 
 private:
-    qb::io::uri _uri;
+    qb::io::uri       _uri;
+    traffic_recorder *_recorder = nullptr;
 
     /**
      * @brief Starts the async communication
@@ -177,6 +198,7 @@ private:
 
         this->template switch_protocol<redis_protocol>(*this);
         this->start();
+        derived().handshake();
     }
 
     /**
@@ -199,6 +221,24 @@ private:
     }
 
 protected:
+    /**
+     * @brief Passes the bytes sent or received to the traffic recorder, if any
+     */
+    void
+    on_traffic(traffic_direction direction, const char *data, std::size_t size) {
+        if (qb__unlikely(_recorder != nullptr))
+            _recorder->record(direction, data, size);
+    }
+
+    /**
+     * @brief Sends the commands required when a connection is established
+     *
+     * Called once the protocol is started, before any user command. Does
+     * nothing by default, derived clients hide it to pipeline their setup.
+     */
+    void
+    handshake() {}
+
     connector() = default;
 
     /**
@@ -291,6 +331,18 @@ public:
     uri() {
         return _uri;
     }
+
+    /**
+     * @brief Records the commands sent and the replies received
+     * @param recorder Log receiving the traffic, must outlive the recording,
+     * nullptr to stop
+     * @return Reference to the derived class for chaining
+     */
+    Derived &
+    record_traffic(traffic_recorder *recorder) {
+        _recorder = recorder;
+        return derived();
+    }
 };
 
 /**
@@ -346,7 +398,10 @@ private:
     void
     _command(Args &&...args) {
         this->ready_to_write();
+        const auto offset = this->out().size();
         put_in_pipe(this->out(), std::forward<Args>(args)...);
+        this->on_traffic(traffic_direction::OUT, this->out().begin() + offset,
+                         this->out().size() - offset);
     }
 
     /**
@@ -372,6 +427,18 @@ private:
         }
     }
 
+    /**
+     * @brief Pipelines the connection setup commands
+     *
+     * Loads the registered Lua scripts so that EVALSHA never misses, and
+     * creates the registered function libraries absent from the server.
+     */
+    void
+    handshake() {
+        this->preload_scripts();
+        this->preload_libraries();
+    }
+
 public:
     /**
      * @brief Default constructor
@@ -523,7 +590,10 @@ private:
     void
     _command(Args &&...args) {
         this->ready_to_write();
+        const auto offset = this->out().size();
         put_in_pipe(this->out(), std::forward<Args>(args)...);
+        this->on_traffic(traffic_direction::OUT, this->out().begin() + offset,
+                         this->out().size() - offset);
     }
 
     /**
@@ -862,6 +932,66 @@ struct tcp {
  */
 const auto no_check = [](auto &&) {};
 
+/**
+ * @brief Runs an asynchronous operation and waits for its result
+ *
+ * Runs the event loop until the callback given to start is called. Used by the
+ * synchronous forms of operations spanning several commands or connections.
+ *
+ * @tparam T Result type of the operation
+ * @param start Callable starting the operation with the callback it receives
+ * @return The result of the operation
+ * @throws std::runtime_error if the operation failed
+ */
+template <typename T, typename Start>
+T
+sync_result(Start &&start) {
+    Reply<T> value{};
+    bool     done = false;
+    std::forward<Start>(start)([&value, &done](auto &&reply) {
+        value = std::forward<decltype(reply)>(reply);
+        done  = true;
+    });
+    while (!done)
+        qb::io::async::run(EVRUN_NOWAIT);
+    if (!value.ok())
+        throw std::runtime_error(std::string(value.error()));
+    return std::move(value.result());
+}
+
+/**
+ * @brief Calls func after a delay, unless the token was cleared meanwhile
+ * @param token Shared flag, set to false to cancel
+ * @param seconds Delay
+ * @param func Callable to run on the event loop
+ */
+template <typename Func>
+void
+call_later(std::shared_ptr<bool> token, double seconds, Func func) {
+    qb::io::async::callback(
+        [token = std::move(token), func = std::move(func)]() mutable {
+            if (*token)
+                func();
+        },
+        seconds);
+}
+
+/**
+ * @brief Calls func every period while the token is set
+ * @param token Shared flag, set to false to stop
+ * @param seconds Period
+ * @param func Callable to run on the event loop
+ */
+template <typename Func>
+void
+call_every(std::shared_ptr<bool> token, double seconds, Func func) {
+    call_later(token, seconds, [token, seconds, func = std::move(func)]() mutable {
+        func();
+        if (*token)
+            call_every(std::move(token), seconds, std::move(func));
+    });
+}
+
 } // namespace qb::redis
 
 #endif // QBM_REDIS_H
@@ -0,0 +1,723 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_REPLAY_H
+#define QBM_REDIS_REPLAY_H
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <charconv>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <qb/io/async.h>
+#include "mapped_file.h"
+#include "resp.h"
+#include "routing.h"
+
+namespace qb::redis {
+
+/**
+ * @class latency_histogram
+ * @brief Log-linear histogram of latencies in microseconds
+ *
+ * Values under 16 have their own bucket, larger ones are split in 8 buckets
+ * per power of two: percentiles are accurate to 12.5% with a fixed size and
+ * no allocation.
+ */
+class latency_histogram {
+public:
+    static constexpr std::size_t buckets = 496;
+
+    void
+    record(std::uint64_t us) {
+        ++_counts[index(us)];
+        ++_count;
+        _sum += us;
+        _min = _count == 1 ? us : std::min(_min, us);
+        _max = std::max(_max, us);
+    }
+
+    void
+    merge(const latency_histogram &other) {
+        if (!other._count)
+            return;
+        for (std::size_t i = 0; i < buckets; ++i)
+            _counts[i] += other._counts[i];
+        _min = _count ? std::min(_min, other._min) : other._min;
+        _max = std::max(_max, other._max);
+        _count += other._count;
+        _sum += other._sum;
+    }
+
+    [[nodiscard]] std::uint64_t
+    count() const {
+        return _count;
+    }
+
+    [[nodiscard]] std::uint64_t
+    min() const {
+        return _min;
+    }
+
+    [[nodiscard]] std::uint64_t
+    max() const {
+        return _max;
+    }
+
+    [[nodiscard]] double
+    mean() const {
+        return _count ? static_cast<double>(_sum) / _count : 0.;
+    }
+
+    /**
+     * @brief Gets the latency under which a percentage of the values fall
+     * @param p Percentage, e.g. 99.9
+     * @return Upper bound of the bucket of the value, 0 if empty
+     */
+    [[nodiscard]] std::uint64_t
+    percentile(double p) const {
+        if (!_count)
+            return 0;
+        const auto rank = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(p / 100. * _count + .5));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets; ++i) {
+            seen += _counts[i];
+            if (seen >= rank)
+                return std::clamp(upper(i), _min, _max);
+        }
+        return _max;
+    }
+
+private:
+    std::array<std::uint64_t, buckets> _counts{};
+    std::uint64_t                      _count = 0;
+    std::uint64_t                      _sum   = 0;
+    std::uint64_t                      _min   = 0;
+    std::uint64_t                      _max   = 0;
+
+    static std::size_t
+    index(std::uint64_t us) {
+        if (us < 16)
+            return us;
+        int e = 63;
+        while (!(us >> e))
+            --e;
+        return 16 + (e - 4) * 8 + ((us >> (e - 3)) & 7);
+    }
+
+    static std::uint64_t
+    upper(std::size_t i) {
+        if (i < 16)
+            return i;
+        const auto e   = (i - 16) / 8 + 4;
+        const auto sub = (i - 16) % 8;
+        return ((9 + sub) << (e - 3)) - 1;
+    }
+};
+
+/**
+ * @struct replay_stats
+ * @brief Replies received for a command type
+ */
+struct replay_stats {
+    std::uint64_t     errors = 0; ///< Error replies
+    latency_histogram latency;    ///< Round trip of every reply
+
+    void
+    record(std::uint64_t us, bool error) {
+        errors += error;
+        latency.record(us);
+    }
+};
+
+/**
+ * @struct replay_report
+ * @brief Result of a replay
+ */
+struct replay_report {
+    std::map<std::string, replay_stats, std::less<>> commands; ///< By upper case name
+    replay_stats              total;
+    std::size_t               skipped   = 0; ///< Commands that can not be replayed
+    std::size_t               truncated = 0; ///< Bytes of an incomplete last command
+    std::chrono::microseconds elapsed{0};
+    std::string               error; ///< Reason of the failure, empty on success
+
+    [[nodiscard]] bool
+    ok() const {
+        return error.empty();
+    }
+
+    /**
+     * @brief Gets the number of replies per second
+     */
+    [[nodiscard]] double
+    throughput() const {
+        return elapsed.count() ? total.latency.count() * 1e6 / elapsed.count() : 0.;
+    }
+};
+
+} // namespace qb::redis
+
+namespace qb::protocol {
+
+/**
+ * @class redis_replay
+ * @brief Splits the bytes received on a replay connection into replies
+ *
+ * Replies are only delimited with resp_reply_size() and never decoded.
+ *
+ * @tparam IO_ The I/O type used for communication
+ */
+template <typename IO_>
+class redis_replay final : public qb::io::async::AProtocol<IO_> {
+public:
+    /**
+     * @struct message
+     * @brief Encoded reply
+     */
+    struct message {
+        const char *data;
+        std::size_t size;
+    };
+
+    redis_replay() = delete;
+
+    /**
+     * @brief Constructs the protocol handler
+     * @param io The I/O object to use for communication
+     */
+    explicit redis_replay(IO_ &io) noexcept
+        : qb::io::async::AProtocol<IO_>(io) {}
+
+    std::size_t
+    getMessageSize() noexcept final {
+        try {
+            return qb::redis::resp_reply_size(
+                {this->_io.in().begin(), this->_io.in().size()});
+        } catch (const std::exception &) {
+            this->not_ok();
+            return 0;
+        }
+    }
+
+    void
+    onMessage(std::size_t size) noexcept final {
+        this->_io.on(message{this->_io.in().begin(), size});
+    }
+
+    void
+    reset() noexcept final {}
+};
+
+} // namespace qb::protocol
+
+namespace qb::redis {
+
+namespace detail {
+
+/**
+ * @class replay_connection
+ * @brief Connection of a replayer, timing each reply against its command
+ *
+ * @tparam QB_IO_ The QB I/O type to use
+ */
+template <typename QB_IO_>
+class replay_connection
+    : public qb::io::async::tcp::client<replay_connection<QB_IO_>, QB_IO_, void> {
+    friend class qb::io::async::io<replay_connection<QB_IO_>>;
+    friend class qb::protocol::redis_replay<replay_connection<QB_IO_>>;
+
+public:
+    using replay_protocol = qb::protocol::redis_replay<replay_connection<QB_IO_>>;
+    using clock           = std::chrono::steady_clock;
+
+private:
+    struct request {
+        clock::time_point sent;
+        replay_stats     *stats;
+    };
+
+    replay_stats         &_total;
+    std::deque<request>   _pending;
+    std::function<void()> _on_reply;
+    std::function<void()> _on_disconnected;
+
+    void
+    on(typename replay_protocol::message msg) {
+        // Out of band RESP3 pushes do not answer a command
+        if (*msg.data == '>' || _pending.empty())
+            return;
+        const auto req = _pending.front();
+        _pending.pop_front();
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                            clock::now() - req.sent)
+                            .count();
+        const bool error = *msg.data == '-' || *msg.data == '!';
+        req.stats->record(us, error);
+        _total.record(us, error);
+        _on_reply();
+    }
+
+    void
+    on(qb::io::async::event::disconnected &&) {
+        _on_disconnected();
+    }
+
+public:
+    replay_connection(replay_stats &total, std::function<void()> on_reply,
+                      std::function<void()> on_disconnected)
+        : _total(total)
+        , _on_reply(std::move(on_reply))
+        , _on_disconnected(std::move(on_disconnected)) {}
+
+    /**
+     * @brief Asynchronously connects to the server
+     * @param uri The server URI
+     * @param func Callback receiving true on success
+     * @param timeout Connection timeout in seconds
+     */
+    template <typename Func>
+    void
+    connect(const qb::io::uri &uri, Func &&func, double timeout) {
+        qb::io::async::tcp::connect<typename QB_IO_::transport_io_type>(
+            uri,
+            [this, func = std::forward<Func>(func)](auto &&raw_io) {
+                if (!raw_io.is_open()) {
+                    func(false);
+                    return;
+                }
+                this->transport() = std::forward<decltype(raw_io)>(raw_io);
+                this->template switch_protocol<replay_protocol>(*this);
+                this->start();
+                func(true);
+            },
+            timeout);
+    }
+
+    /**
+     * @brief Sends an encoded command, its reply is recorded in stats
+     */
+    void
+    send(std::string_view command, replay_stats &stats) {
+        this->ready_to_write();
+        this->out().write(command.data(), command.size());
+        _pending.push_back({clock::now(), &stats});
+    }
+
+    /**
+     * @brief Disconnects, the replies still expected are ignored
+     */
+    void
+    close() {
+        _pending.clear();
+        this->disconnect();
+    }
+
+    /**
+     * @brief Gets the number of commands waiting for their reply
+     */
+    [[nodiscard]] std::size_t
+    in_flight() const {
+        return _pending.size();
+    }
+};
+
+} // namespace detail
+
+/**
+ * @class replayer
+ * @brief Replays an AOF file or captured RESP traffic against a server
+ *
+ * The commands are located in place with resp_command_size(), e.g. in a
+ * memory-mapped file, and written as they are to the connections, up to
+ * pipeline commands in flight on each one. Replies are only delimited and
+ * timed, their round trips are reported per command type.
+ *
+ * Commands are spread over the connections in turn, or by the hash of their
+ * key, the first argument, with key_affinity: the order of the commands on a
+ * key is then kept. SELECT is sent on every connection and a MULTI block
+ * stays on one connection. Subscriptions, MONITOR, SYNC and PSYNC are
+ * skipped.
+ *
+ * With a speed, the #TS:<unix time> annotations written by Redis 7 with
+ * aof-timestamp-enabled pace the replay: 1 replays at the original rate, 2
+ * twice as fast. Without annotations or with a speed of 0, the commands are
+ * sent as fast as the server accepts them.
+ *
+ * AOF files with an RDB preamble are not supported: replay the incremental
+ * files of the AOF directory.
+ *
+ * @tparam QB_IO_ The QB I/O type to use
+ */
+template <typename QB_IO_>
+class replayer {
+public:
+    /**
+     * @struct options
+     * @brief Distribution and pacing of the commands
+     */
+    struct options {
+        std::size_t connections  = 1;     ///< Connections to the server
+        bool        key_affinity = false; ///< Same connection for the same key
+        double      speed        = 0;     ///< Multiple of the original rate, 0 for max
+        std::size_t pipeline     = 256;   ///< Commands in flight per connection
+    };
+
+    using cb_done_t = std::function<void(replay_report &&)>;
+
+private:
+    using connection = detail::replay_connection<QB_IO_>;
+    using clock      = std::chrono::steady_clock;
+
+    qb::io::uri                              _uri;
+    options                                  _opts;
+    std::vector<std::unique_ptr<connection>> _connections;
+    std::string_view                         _data;
+    std::size_t                              _pos = 0;
+    replay_report                            _report;
+    cb_done_t                                _on_done;
+    std::string                              _name; // Upper case command name
+    std::size_t                              _next  = 0;  // Round robin
+    long                                     _multi = -1; // Connection of a MULTI
+    bool                                     _running = false;
+    bool                                     _timed   = false;
+    double                                   _origin_ts = 0;
+    clock::time_point                        _origin;
+    clock::time_point                        _started;
+    clock::time_point                        _wait_until;
+    std::shared_ptr<bool>                    _alive = std::make_shared<bool>(true);
+
+    static bool
+    skipped(std::string_view name) {
+        for (const auto other : {"SUBSCRIBE", "PSUBSCRIBE", "SSUBSCRIBE", "UNSUBSCRIBE",
+                                 "PUNSUBSCRIBE", "SUNSUBSCRIBE", "MONITOR", "SYNC",
+                                 "PSYNC"})
+            if (detail::iequals(name, other))
+                return true;
+        return false;
+    }
+
+    replay_stats &
+    stats(std::string_view name) {
+        _name.assign(name);
+        for (auto &c : _name)
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        const auto it = _report.commands.find(_name);
+        if (it != _report.commands.end())
+            return it->second;
+        return _report.commands[_name];
+    }
+
+    std::size_t
+    pick(std::string_view key) {
+        if (_opts.key_affinity && !key.empty())
+            return detail::shard_hash(detail::shard_tag(key)) % _connections.size();
+        return _next++ % _connections.size();
+    }
+
+    /**
+     * @brief Gets the key of the first command after pos, to place a MULTI
+     */
+    std::string_view
+    next_key(std::size_t pos) const {
+        while (pos < _data.size() && _data[pos] == '#') {
+            const auto end = _data.find("\r\n", pos);
+            if (end == std::string_view::npos)
+                return {};
+            pos = end + 2;
+        }
+        resp_command cmd;
+        try {
+            if (pos < _data.size() && resp_command_size(_data.substr(pos), cmd))
+                return cmd.key;
+        } catch (const std::exception &) {
+        }
+        return {};
+    }
+
+    /**
+     * @brief Reads a #TS annotation, waiting until its time in the replay
+     * @return false if the replay must wait
+     */
+    bool
+    annotation(std::string_view line) {
+        if (_opts.speed <= 0 || line.substr(0, 4) != "#TS:")
+            return true;
+        double     ts  = 0;
+        const auto end = line.data() + line.size();
+        if (std::from_chars(line.data() + 4, end, ts).ptr != end)
+            return true;
+        const auto now = clock::now();
+        if (!_timed) {
+            _timed     = true;
+            _origin_ts = ts;
+            _origin    = now;
+            return true;
+        }
+        const auto due = _origin + std::chrono::duration_cast<clock::duration>(
+                                       std::chrono::duration<double>(
+                                           (ts - _origin_ts) / _opts.speed));
+        if (due <= now)
+            return true;
+        _wait_until = due;
+        qb::io::async::callback(
+            [this, alive = _alive]() {
+                if (!*alive || !_running)
+                    return;
+                _wait_until = {};
+                pump();
+            },
+            std::chrono::duration<double>(due - now).count());
+        return false;
+    }
+
+    void
+    dispatch(const resp_command &cmd) {
+        auto &s = stats(cmd.name);
+        if (detail::iequals(cmd.name, "SELECT")) {
+            for (auto &c : _connections)
+                c->send(cmd.raw, s);
+            return;
+        }
+        if (_multi >= 0) {
+            _connections[_multi]->send(cmd.raw, s);
+            if (detail::iequals(cmd.name, "EXEC") || detail::iequals(cmd.name, "DISCARD"))
+                _multi = -1;
+            return;
+        }
+        const auto index = pick(detail::iequals(cmd.name, "MULTI") ? next_key(_pos)
+                                                                    : cmd.key);
+        if (detail::iequals(cmd.name, "MULTI"))
+            _multi = static_cast<long>(index);
+        _connections[index]->send(cmd.raw, s);
+    }
+
+    /**
+     * @brief Checks that the connections receiving cmd can take it
+     */
+    bool
+    writable(const resp_command &cmd) {
+        if (detail::iequals(cmd.name, "SELECT")) {
+            for (const auto &c : _connections)
+                if (c->in_flight() >= _opts.pipeline)
+                    return false;
+            return true;
+        }
+        if (_multi >= 0)
+            return _connections[_multi]->in_flight() < _opts.pipeline;
+        // Placing the command must not advance the round robin
+        const auto next = _next;
+        const auto key  = detail::iequals(cmd.name, "MULTI")
+                              ? next_key(_pos + cmd.raw.size())
+                              : cmd.key;
+        const auto ok   = _connections[pick(key)]->in_flight() < _opts.pipeline;
+        _next           = next;
+        return ok;
+    }
+
+    /**
+     * @brief Sends the commands until a connection is full or a wait is due
+     */
+    void
+    pump() {
+        if (!_running || clock::now() < _wait_until)
+            return;
+        while (_pos < _data.size()) {
+            const auto rest = _data.substr(_pos);
+            if (rest[0] == '#') {
+                const auto end = rest.find("\r\n");
+                if (end == std::string_view::npos) {
+                    _report.truncated = rest.size();
+                    _pos              = _data.size();
+                    break;
+                }
+                _pos += end + 2;
+                if (!annotation(rest.substr(0, end)))
+                    return;
+                continue;
+            }
+            resp_command cmd;
+            std::size_t  size = 0;
+            try {
+                size = resp_command_size(rest, cmd);
+            } catch (const std::exception &e) {
+                finish(std::string(e.what()) + " at offset " + std::to_string(_pos));
+                return;
+            }
+            if (!size) {
+                _report.truncated = rest.size();
+                _pos              = _data.size();
+                break;
+            }
+            if (skipped(cmd.name)) {
+                ++_report.skipped;
+                _pos += size;
+                continue;
+            }
+            if (!writable(cmd))
+                return;
+            _pos += size;
+            dispatch(cmd);
+        }
+        for (const auto &c : _connections)
+            if (c->in_flight())
+                return;
+        finish({});
+    }
+
+    void
+    finish(std::string error) {
+        if (!_running)
+            return;
+        _running        = false;
+        _report.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            clock::now() - _started);
+        _report.error = std::move(error);
+        for (auto &c : _connections)
+            c->close();
+        auto on_done = std::move(_on_done);
+        on_done(std::move(_report));
+    }
+
+    void
+    begin() {
+        _started = clock::now();
+        pump();
+    }
+
+public:
+    /**
+     * @brief Constructs a replayer
+     * @param uri The URI of the target server
+     * @param opts Distribution and pacing of the commands
+     * @throws std::invalid_argument if there is no connection or no pipeline
+     */
+    explicit replayer(qb::io::uri uri, options opts = {})
+        : _uri(std::move(uri))
+        , _opts(opts) {
+        if (!_opts.connections || !_opts.pipeline)
+            throw std::invalid_argument("replayer needs connections and a pipeline");
+    }
+
+    ~replayer() {
+        *_alive = false;
+    }
+
+    replayer(const replayer &)            = delete;
+    replayer &operator=(const replayer &) = delete;
+
+    /**
+     * @brief Asynchronously replays commands
+     * @param data AOF or RESP commands, must outlive the replay
+     * @param func Callback receiving the report
+     * @param timeout Connection timeout in seconds
+     * @throws std::invalid_argument if data starts with an RDB preamble
+     * @throws std::logic_error if a replay is running
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, replay_report &&>, void>
+    replay(std::string_view data, Func &&func, double timeout = 3) {
+        if (_running)
+            throw std::logic_error("a replay is already running");
+        if (data.substr(0, 5) == "REDIS")
+            throw std::invalid_argument(
+                "AOF with an RDB preamble, replay its incremental files");
+        _data       = data;
+        _pos        = 0;
+        _report     = {};
+        _on_done    = std::forward<Func>(func);
+        _next       = 0;
+        _multi      = -1;
+        _timed      = false;
+        _wait_until = {};
+        _running    = true;
+
+        _connections.clear();
+        auto remaining = std::make_shared<std::size_t>(_opts.connections);
+        for (std::size_t i = 0; i < _opts.connections; ++i) {
+            _connections.push_back(std::make_unique<connection>(
+                _report.total, [this]() { pump(); },
+                [this]() { finish("connection lost"); }));
+            _connections.back()->connect(
+                _uri,
+                [this, remaining, alive = _alive](bool connected) {
+                    if (!*alive || !_running)
+                        return;
+                    if (!connected)
+                        finish("unable to connect");
+                    else if (!--*remaining)
+                        begin();
+                },
+                timeout);
+        }
+    }
+
+    /**
+     * @brief Replays commands
+     * @param data AOF or RESP commands
+     * @return The report, check ok()
+     * @throws std::invalid_argument if data starts with an RDB preamble
+     */
+    replay_report
+    replay(std::string_view data) {
+        replay_report report;
+        bool          done = false;
+        replay(data, [&](replay_report &&r) {
+            report = std::move(r);
+            done   = true;
+        });
+        while (!done)
+            qb::io::async::run(EVRUN_ONCE);
+        return report;
+    }
+
+    /**
+     * @brief Replays an AOF or RESP file mapped in memory
+     * @param path Path of the file
+     * @return The report, check ok()
+     * @throws std::runtime_error if the file can not be read
+     * @throws std::invalid_argument if the file starts with an RDB preamble
+     */
+    replay_report
+    replay_file(const std::string &path) {
+        const mapped_file file(path);
+        return replay(file.data());
+    }
+
+    /**
+     * @brief Checks whether a replay is running
+     */
+    [[nodiscard]] bool
+    running() const {
+        return _running;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_REPLAY_H
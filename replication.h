@@ -0,0 +1,791 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_REPLICATION_H
+#define QBM_REDIS_REPLICATION_H
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "redis.h"
+#include "routing.h"
+
+namespace qb::redis {
+
+/**
+ * @struct replication_event
+ * @brief Write command propagated by a master to its replicas
+ */
+struct replication_event {
+    long long                offset = 0; ///< Replication offset after the command
+    long long                db     = 0; ///< Database selected for the command
+    std::vector<std::string> args;       ///< Command name and arguments
+
+    /**
+     * @brief Gets the command name, as sent by the master
+     */
+    [[nodiscard]] const std::string &
+    name() const {
+        return args.front();
+    }
+
+    /**
+     * @brief Checks the command name, ignoring the case
+     */
+    [[nodiscard]] bool
+    is(std::string_view command) const {
+        return !args.empty() && detail::iequals(args.front(), command);
+    }
+};
+
+/**
+ * @class replication_parser
+ * @brief Incremental parser of the byte stream a master sends to a replica
+ *
+ * Parses the reply to PSYNC (+FULLRESYNC or +CONTINUE), the RDB payload that
+ * follows a full resynchronization, sized ($<length>) or delimited by an EOF
+ * mark ($EOF:<mark>) in diskless mode, then the propagated commands. RDB bytes
+ * are passed to the handler as they arrive and never buffered. Only an
+ * incomplete line or command is kept between two feeds.
+ *
+ * The handler is any object with the methods:
+ * - on_fullresync(std::string_view replid, long long offset)
+ * - on_continue(std::string_view replid)
+ * - on_rdb(std::string_view chunk) and on_rdb_end()
+ * - on_command(replication_event &&event)
+ * - on_error(std::string_view error)
+ */
+class replication_parser {
+    static constexpr std::size_t mark_size = 40;
+
+    enum class state { PSYNC, RDB_HEADER, RDB_SIZED, RDB_MARKED, COMMANDS, FAILED };
+
+    state       _state  = state::PSYNC;
+    long long   _offset = 0;
+    long long   _db     = 0;
+    long long   _remaining = 0;
+    std::string _mark;
+    std::string _tail;
+    std::string _buffer;
+
+    /**
+     * @brief Gets the line at data, without its CRLF
+     * @return false if the line is incomplete
+     */
+    static bool
+    line_at(const char *data, std::size_t size, std::string_view &line) {
+        std::string_view view(data, size);
+        const auto       end = view.find("\r\n");
+        if (end == std::string_view::npos)
+            return false;
+        line = view.substr(0, end);
+        return true;
+    }
+
+    static bool
+    to_integer(std::string_view text, long long &value) {
+        const auto end    = text.data() + text.size();
+        const auto result = std::from_chars(text.data(), end, value);
+        return !text.empty() && result.ec == std::errc{} && result.ptr == end;
+    }
+
+    template <typename Handler>
+    std::size_t
+    fail(Handler &handler, std::string_view error, std::size_t size) {
+        _state = state::FAILED;
+        handler.on_error(error);
+        return size;
+    }
+
+    /**
+     * @brief Parses the reply to PSYNC, skipping the replies to REPLCONF
+     */
+    template <typename Handler>
+    std::size_t
+    parse_psync(const char *data, std::size_t size, Handler &handler) {
+        std::string_view line;
+        if (!line_at(data, size, line))
+            return 0;
+        const auto used = line.size() + 2;
+        if (!line.empty() && line.front() == '-')
+            return fail(handler, line.substr(1), size);
+
+        if (line.rfind("+FULLRESYNC ", 0) == 0) {
+            const auto fields = line.substr(12);
+            const auto space  = fields.find(' ');
+            if (space == std::string_view::npos ||
+                !to_integer(fields.substr(space + 1), _offset))
+                return fail(handler, "invalid FULLRESYNC reply", size);
+            _state = state::RDB_HEADER;
+            handler.on_fullresync(fields.substr(0, space), _offset);
+        } else if (line.rfind("+CONTINUE", 0) == 0) {
+            _state = state::COMMANDS;
+            handler.on_continue(line.size() > 10 ? line.substr(10) : std::string_view{});
+        }
+        return used;
+    }
+
+    /**
+     * @brief Parses $<length> or $EOF:<mark> announcing the RDB payload
+     */
+    template <typename Handler>
+    std::size_t
+    parse_rdb_header(const char *data, std::size_t size, Handler &handler) {
+        std::string_view line;
+        if (!line_at(data, size, line))
+            return 0;
+        long long length = 0;
+        if (line.empty() || line.front() != '$')
+            return fail(handler, "invalid RDB header", size);
+        if (line.rfind("$EOF:", 0) == 0) {
+            _mark  = std::string(line.substr(5));
+            _state = state::RDB_MARKED;
+            if (_mark.size() != mark_size)
+                return fail(handler, "invalid RDB EOF mark", size);
+        } else if (to_integer(line.substr(1), length) && length > 0) {
+            _remaining = length;
+            _state     = state::RDB_SIZED;
+        } else if (length == 0 && line == "$0") {
+            _state = state::COMMANDS;
+            handler.on_rdb_end();
+        } else
+            return fail(handler, "invalid RDB length", size);
+        return line.size() + 2;
+    }
+
+    template <typename Handler>
+    std::size_t
+    parse_rdb_sized(const char *data, std::size_t size, Handler &handler) {
+        const auto chunk = std::min<std::size_t>(size, _remaining);
+        if (chunk)
+            handler.on_rdb(std::string_view(data, chunk));
+        _remaining -= chunk;
+        if (!_remaining) {
+            _state = state::COMMANDS;
+            handler.on_rdb_end();
+        }
+        return chunk;
+    }
+
+    /**
+     * @brief Streams a diskless payload, holding back the bytes that may be the
+     * start of the EOF mark
+     */
+    template <typename Handler>
+    std::size_t
+    parse_rdb_marked(const char *data, std::size_t size, Handler &handler) {
+        std::string_view input(data, size);
+
+        // Mark spanning the held back bytes and the new ones
+        std::string joined = _tail;
+        joined.append(input.substr(0, std::min(size, mark_size)));
+        auto at = joined.find(_mark);
+        if (at != std::string::npos) {
+            if (at)
+                handler.on_rdb(std::string_view(joined.data(), at));
+            _tail.clear();
+            _state = state::COMMANDS;
+            handler.on_rdb_end();
+            return at + mark_size - (joined.size() - std::min(size, mark_size));
+        }
+
+        at = input.find(_mark);
+        if (at != std::string_view::npos) {
+            if (!_tail.empty())
+                handler.on_rdb(_tail);
+            if (at)
+                handler.on_rdb(input.substr(0, at));
+            _tail.clear();
+            _state = state::COMMANDS;
+            handler.on_rdb_end();
+            return at + mark_size;
+        }
+
+        if (size >= mark_size) {
+            if (!_tail.empty())
+                handler.on_rdb(_tail);
+            if (size > mark_size)
+                handler.on_rdb(input.substr(0, size - mark_size));
+            _tail.assign(input.substr(size - mark_size));
+        } else {
+            _tail.append(input);
+            if (_tail.size() > mark_size) {
+                const auto extra = _tail.size() - mark_size;
+                handler.on_rdb(std::string_view(_tail.data(), extra));
+                _tail.erase(0, extra);
+            }
+        }
+        return size;
+    }
+
+    /**
+     * @brief Parses one propagated command, an array of bulk strings
+     */
+    template <typename Handler>
+    std::size_t
+    parse_command(const char *data, std::size_t size, Handler &handler) {
+        if (data[0] != '*')
+            return fail(handler, "invalid propagated command", size);
+        std::string_view line;
+        long long        count = 0;
+        if (!line_at(data, size, line))
+            return 0;
+        if (!to_integer(line.substr(1), count) || count < 0)
+            return fail(handler, "invalid propagated command", size);
+
+        std::size_t              used = line.size() + 2;
+        std::vector<std::string> args;
+        args.reserve(static_cast<std::size_t>(count));
+        for (long long i = 0; i < count; ++i) {
+            if (!line_at(data + used, size - used, line))
+                return 0;
+            long long length = 0;
+            if (line.empty() || line.front() != '$' ||
+                !to_integer(line.substr(1), length) || length < 0)
+                return fail(handler, "invalid propagated argument", size);
+            const auto start = used + line.size() + 2;
+            if (start + length + 2 > size)
+                return 0;
+            args.emplace_back(data + start, static_cast<std::size_t>(length));
+            used = start + length + 2;
+        }
+
+        _offset += static_cast<long long>(used);
+        replication_event event{_offset, _db, std::move(args)};
+        if (event.is("SELECT") && event.args.size() > 1)
+            to_integer(event.args[1], _db), event.db = _db;
+        handler.on_command(std::move(event));
+        return used;
+    }
+
+    template <typename Handler>
+    std::size_t
+    parse(const char *data, std::size_t size, Handler &handler) {
+        std::size_t used = 0;
+        while (used < size && _state != state::FAILED) {
+            const char *at   = data + used;
+            const auto  left = size - used;
+            // Keepalive newlines sent while the master prepares the payload
+            if (*at == '\n' && (_state == state::PSYNC || _state == state::RDB_HEADER)) {
+                ++used;
+                continue;
+            }
+
+            const auto  before = _state;
+            std::size_t step   = 0;
+            switch (_state) {
+            case state::PSYNC:
+                step = parse_psync(at, left, handler);
+                break;
+            case state::RDB_HEADER:
+                step = parse_rdb_header(at, left, handler);
+                break;
+            case state::RDB_SIZED:
+                step = parse_rdb_sized(at, left, handler);
+                break;
+            case state::RDB_MARKED:
+                step = parse_rdb_marked(at, left, handler);
+                break;
+            case state::COMMANDS:
+                step = parse_command(at, left, handler);
+                break;
+            case state::FAILED:
+                break;
+            }
+            // Nothing consumed: the item is incomplete
+            if (!step && _state == before)
+                break;
+            used += step;
+        }
+        return std::min(used, size);
+    }
+
+public:
+    /**
+     * @brief Feeds bytes received from the master
+     * @param data Received bytes
+     * @param size Number of bytes
+     * @param handler Object receiving the parsed items
+     */
+    template <typename Handler>
+    void
+    feed(const char *data, std::size_t size, Handler &handler) {
+        if (_buffer.empty()) {
+            const auto used = parse(data, size, handler);
+            if (_state != state::FAILED)
+                _buffer.assign(data + used, size - used);
+            return;
+        }
+        _buffer.append(data, size);
+        const auto used = parse(_buffer.data(), _buffer.size(), handler);
+        _buffer.erase(0, used);
+    }
+
+    /**
+     * @brief Resets the parser to wait for the reply to a new PSYNC
+     * @param offset Offset the replication resumes from
+     */
+    void
+    reset(long long offset = 0) {
+        _state     = state::PSYNC;
+        _offset    = offset;
+        _remaining = 0;
+        _mark.clear();
+        _tail.clear();
+        _buffer.clear();
+    }
+
+    /**
+     * @brief Gets the offset of the last byte of replication stream processed
+     */
+    [[nodiscard]] long long
+    offset() const {
+        return _offset;
+    }
+
+    /**
+     * @brief Checks whether the parser receives propagated commands
+     */
+    [[nodiscard]] bool
+    streaming() const {
+        return _state == state::COMMANDS;
+    }
+
+    /**
+     * @brief Checks whether the stream was invalid or refused
+     */
+    [[nodiscard]] bool
+    failed() const {
+        return _state == state::FAILED;
+    }
+};
+
+} // namespace qb::redis
+
+namespace qb::protocol {
+
+/**
+ * @class redis_replication
+ * @brief Passes the raw bytes received on a replica connection to the I/O
+ *
+ * The replication stream does not follow the request and reply pattern, so
+ * the bytes are handed over as they arrive and parsed by replication_parser.
+ *
+ * @tparam IO_ The I/O type used for communication
+ */
+template <typename IO_>
+class redis_replication final : public qb::io::async::AProtocol<IO_> {
+public:
+    /**
+     * @struct message
+     * @brief Bytes received from the master
+     */
+    struct message {
+        const char *data;
+        std::size_t size;
+    };
+
+    redis_replication() = delete;
+
+    /**
+     * @brief Constructs the protocol handler
+     * @param io The I/O object to use for communication
+     */
+    explicit redis_replication(IO_ &io) noexcept
+        : qb::io::async::AProtocol<IO_>(io) {}
+
+    std::size_t
+    getMessageSize() noexcept final {
+        return this->_io.in().size();
+    }
+
+    void
+    onMessage(std::size_t size) noexcept final {
+        this->_io.on(message{this->_io.in().begin(), size});
+    }
+
+    void
+    reset() noexcept final {}
+};
+
+} // namespace qb::protocol
+
+namespace qb::redis {
+
+/**
+ * @class replica
+ * @brief Connection consuming the replication stream of a master, for change
+ * data capture
+ *
+ * Connects as a replica with REPLCONF capa eof psync2 and PSYNC, then:
+ * - on +FULLRESYNC, streams the RDB snapshot to the on_rdb() sink chunk by
+ *   chunk, without holding it in memory;
+ * - passes every propagated write to on_event() with its offset and database.
+ *   SELECT, PING and REPLCONF only update the state and are not passed.
+ *
+ * REPLCONF ACK <offset> is sent every ack_interval and on REPLCONF GETACK.
+ * After a disconnection, the replica reconnects after reconnect_delay and
+ * resumes with PSYNC <replid> <offset + 1>: the master answers +CONTINUE
+ * while its backlog still holds the missed commands, and a full
+ * resynchronization otherwise. Persist replication_id() and offset() with
+ * the consumed data and pass them to resume_from() to resume after a restart.
+ *
+ * @tparam QB_IO_ The QB I/O type to use
+ */
+template <typename QB_IO_>
+class replica : public qb::io::async::tcp::client<replica<QB_IO_>, QB_IO_, void> {
+    friend class qb::io::async::io<replica<QB_IO_>>;
+    friend class qb::protocol::redis_replication<replica<QB_IO_>>;
+    friend class replication_parser;
+
+public:
+    using replication_protocol = qb::protocol::redis_replication<replica<QB_IO_>>;
+
+    /**
+     * @struct options
+     * @brief Acknowledgment and reconnection policy
+     */
+    struct options {
+        std::chrono::milliseconds ack_interval{1000};    ///< Period of REPLCONF ACK
+        std::chrono::milliseconds reconnect_delay{1000}; ///< 0 disables reconnection
+        int listening_port = 0; ///< Announced with REPLCONF, 0 to skip
+    };
+
+    using cb_sync_t  = std::function<void(std::string_view replid, long long offset)>;
+    using cb_rdb_t   = std::function<void(std::string_view chunk)>;
+    using cb_end_t   = std::function<void()>;
+    using cb_event_t = std::function<void(replication_event &&)>;
+    using cb_err_t   = std::function<void(std::string_view error)>;
+
+private:
+    qb::io::uri           _uri;
+    options               _opts;
+    replication_parser    _parser;
+    std::string           _replid = "?";
+    long long             _offset = -1;
+    std::string           _loading_replid; // Committed once the RDB is loaded
+    long long             _loading_offset = -1;
+    bool                  _stopped = false;
+    std::shared_ptr<bool> _timer;
+    std::shared_ptr<bool> _alive = std::make_shared<bool>(true);
+
+    cb_sync_t  _on_fullresync;
+    cb_sync_t  _on_continue;
+    cb_rdb_t   _on_rdb;
+    cb_end_t   _on_rdb_end;
+    cb_event_t _on_event;
+    cb_err_t   _on_error;
+
+    template <typename... Args>
+    void
+    send(Args &&...args) {
+        this->ready_to_write();
+        put_in_pipe(this->out(), std::forward<Args>(args)...);
+    }
+
+    void
+    ack() {
+        send("REPLCONF", "ACK", _parser.offset());
+    }
+
+    /**
+     * @brief Sends REPLCONF ACK every ack_interval while the token is valid
+     */
+    void
+    arm(std::shared_ptr<bool> token) {
+        call_every(std::move(token),
+                   std::chrono::duration<double>(_opts.ack_interval).count(), [this]() {
+                       if (_parser.streaming())
+                           ack();
+                   });
+    }
+
+    void
+    stop_timer() {
+        if (_timer) {
+            *_timer = false;
+            _timer.reset();
+        }
+    }
+
+    void
+    start_async() {
+        if (this->protocol())
+            this->clear_protocols();
+        this->template switch_protocol<replication_protocol>(*this);
+        this->start();
+
+        _parser.reset(_offset);
+        if (_opts.listening_port)
+            send("REPLCONF", "listening-port", _opts.listening_port);
+        send("REPLCONF", "capa", "eof", "capa", "psync2");
+        send("PSYNC", _replid, _offset < 0 ? -1 : _offset + 1);
+
+        stop_timer();
+        _timer = std::make_shared<bool>(true);
+        arm(_timer);
+    }
+
+    void
+    reconnect() {
+        if (_stopped || !_opts.reconnect_delay.count())
+            return;
+        qb::io::async::callback(
+            [this, alive = _alive]() {
+                if (!*alive || _stopped)
+                    return;
+                connect([this](bool connected) {
+                    if (!connected)
+                        reconnect();
+                });
+            },
+            std::chrono::duration<double>(_opts.reconnect_delay).count());
+    }
+
+    void
+    on(typename replication_protocol::message msg) {
+        _parser.feed(msg.data, msg.size, *this);
+        // A refused PSYNC is retried on the next connection
+        if (_parser.failed())
+            this->disconnect();
+    }
+
+    void
+    on(qb::io::async::event::disconnected &&) {
+        LOG_WARN("[qbm][redis] replica has been disconnected");
+        stop_timer();
+        reconnect();
+    }
+
+    // Handler of replication_parser
+    void
+    on_fullresync(std::string_view replid, long long offset) {
+        // Resuming from this offset is only valid once the RDB is loaded
+        _loading_replid = std::string(replid);
+        _loading_offset = offset;
+        if (_on_fullresync)
+            _on_fullresync(replid, offset);
+    }
+
+    void
+    on_continue(std::string_view replid) {
+        if (!replid.empty())
+            _replid = std::string(replid);
+        if (_on_continue)
+            _on_continue(_replid, _offset);
+    }
+
+    void
+    on_rdb(std::string_view chunk) {
+        if (_on_rdb)
+            _on_rdb(chunk);
+    }
+
+    void
+    on_rdb_end() {
+        _replid = std::move(_loading_replid);
+        _offset = _loading_offset;
+        if (_on_rdb_end)
+            _on_rdb_end();
+    }
+
+    void
+    on_command(replication_event &&event) {
+        _offset = event.offset;
+        if (event.is("REPLCONF")) {
+            if (event.args.size() > 1 && detail::iequals(event.args[1], "GETACK"))
+                ack();
+            return;
+        }
+        if (event.is("PING") || event.is("SELECT"))
+            return;
+        if (_on_event)
+            _on_event(std::move(event));
+    }
+
+    void
+    on_error(std::string_view error) {
+        LOG_WARN("[qbm][redis] replication failed -> " << error);
+        if (_on_error)
+            _on_error(error);
+    }
+
+public:
+    /**
+     * @brief Constructs a replica of the master at uri
+     * @param uri The master URI
+     * @param opts Acknowledgment and reconnection policy
+     */
+    explicit replica(qb::io::uri uri = {}, options opts = {})
+        : _uri(std::move(uri))
+        , _opts(opts) {}
+
+    ~replica() {
+        *_alive  = false;
+        _stopped = true;
+        stop_timer();
+    }
+
+    /**
+     * @brief Sets the position to resume from on the next connection
+     * @param replid Replication ID saved with the consumed data
+     * @param offset Offset of the last consumed byte
+     * @return Reference to the replica for chaining
+     */
+    replica &
+    resume_from(std::string replid, long long offset) {
+        _replid = std::move(replid);
+        _offset = offset;
+        return *this;
+    }
+
+    /**
+     * @brief Connects to the master and starts the replication
+     * @return true on success
+     */
+    bool
+    connect() {
+        _stopped = false;
+        if (!this->transport().connect(_uri)) {
+            start_async();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Asynchronously connects to the master and starts the replication
+     * @param func Callback receiving true on success
+     * @param timeout Connection timeout in seconds
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, bool>, void>
+    connect(Func &&func, double timeout = 3) {
+        _stopped = false;
+        qb::io::async::tcp::connect<typename QB_IO_::transport_io_type>(
+            _uri,
+            [this, func = std::forward<Func>(func)](auto &&raw_io) {
+                if (!raw_io.is_open()) {
+                    func(false);
+                    return;
+                }
+                this->transport() = std::forward<decltype(raw_io)>(raw_io);
+                start_async();
+                func(true);
+            },
+            timeout);
+    }
+
+    /**
+     * @brief Stops the replication and disables the reconnection
+     */
+    void
+    stop() {
+        _stopped = true;
+        stop_timer();
+        this->disconnect();
+    }
+
+    /**
+     * @brief Sets the handler of a full resynchronization, called before the
+     * RDB payload
+     */
+    replica &
+    on_fullresync(cb_sync_t &&cb) {
+        _on_fullresync = std::move(cb);
+        return *this;
+    }
+
+    /**
+     * @brief Sets the handler of a partial resynchronization
+     */
+    replica &
+    on_continue(cb_sync_t &&cb) {
+        _on_continue = std::move(cb);
+        return *this;
+    }
+
+    /**
+     * @brief Sets the sink receiving the RDB payload chunk by chunk
+     */
+    replica &
+    on_rdb(cb_rdb_t &&cb) {
+        _on_rdb = std::move(cb);
+        return *this;
+    }
+
+    /**
+     * @brief Sets the handler called once the RDB payload is complete
+     */
+    replica &
+    on_rdb_end(cb_end_t &&cb) {
+        _on_rdb_end = std::move(cb);
+        return *this;
+    }
+
+    /**
+     * @brief Sets the handler of the propagated write commands
+     */
+    replica &
+    on_event(cb_event_t &&cb) {
+        _on_event = std::move(cb);
+        return *this;
+    }
+
+    /**
+     * @brief Sets the handler of a refused PSYNC or an invalid stream
+     */
+    replica &
+    on_error(cb_err_t &&cb) {
+        _on_error = std::move(cb);
+        return *this;
+    }
+
+    /**
+     * @brief Gets the replication ID of the master, "?" before the first sync
+     */
+    [[nodiscard]] const std::string &
+    replication_id() const {
+        return _replid;
+    }
+
+    /**
+     * @brief Gets the offset of the last byte of stream processed, -1 before the
+     * first sync
+     */
+    [[nodiscard]] long long
+    offset() const {
+        return _offset;
+    }
+
+    /**
+     * @brief Checks whether the replica receives propagated commands
+     */
+    [[nodiscard]] bool
+    streaming() const {
+        return _parser.streaming();
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_REPLICATION_H
@@ -15,6 +15,8 @@
  *         limitations under the License.
  */
 
+#include <cstdlib>
+#include <cstdlib>
 #include <stdexcept>
 #include <sstream>
 #include "reply.h"
@@ -386,6 +388,77 @@ parse(ParseTag<qb::redis::geo_pos>, redisReply &reply) {
                               parse<double>(*latitude_reply)};
 }
 
+namespace {
+
+double
+parse_geo_double(redisReply *reply) {
+    if (reply == nullptr || !qb::redis::is_string(*reply))
+        throw ProtoError("Invalid GEO coordinate or distance reply");
+    return std::strtod(reply->str, nullptr);
+}
+
+} // namespace
+
+/**
+ * @brief Parses a GEOSEARCH reply into a structure-of-arrays result
+ *
+ * Accepts both the plain member list and the nested WITHDIST/WITHHASH/WITHCOORD
+ * layout. The extra fields of each entry are recognized by their reply type:
+ * string for the distance, integer for the hash and array for the position.
+ *
+ * @param tag Parse tag type (unused, for template specialization)
+ * @param reply The Redis reply to parse
+ * @return geo_search_result holding all the entries
+ * @throws ParseError if the reply is not an array
+ * @throws ProtoError if an entry is malformed
+ */
+qb::redis::geo_search_result
+parse(ParseTag<qb::redis::geo_search_result>, redisReply &reply) {
+    if (!qb::redis::is_array(reply)) {
+        throw ParseError("ARRAY", reply);
+    }
+
+    auto member_of = [](redisReply *entry) -> redisReply * {
+        if (entry != nullptr && qb::redis::is_array(*entry))
+            entry = entry->elements ? entry->element[0] : nullptr;
+        if (entry == nullptr || !qb::redis::is_string(*entry))
+            throw ProtoError("Invalid GEO search entry");
+        return entry;
+    };
+
+    qb::redis::geo_search_result result;
+    std::size_t                  total = 0;
+    for (std::size_t i = 0; i < reply.elements; ++i)
+        total += member_of(reply.element[i])->len;
+
+    result.members.reserve(reply.elements, total);
+    for (std::size_t i = 0; i < reply.elements; ++i) {
+        auto *entry  = reply.element[i];
+        auto *member = member_of(entry);
+        result.members.push_back({member->str, member->len});
+
+        if (!qb::redis::is_array(*entry))
+            continue;
+        for (std::size_t j = 1; j < entry->elements; ++j) {
+            auto *field = entry->element[j];
+            if (field == nullptr)
+                throw ProtoError("Null GEO search field");
+            if (qb::redis::is_integer(*field)) {
+                result.hashes.push_back(field->integer);
+            } else if (qb::redis::is_array(*field)) {
+                if (field->elements != 2)
+                    throw ProtoError("Invalid GEO position reply");
+                result.longitudes.push_back(parse_geo_double(field->element[0]));
+                result.latitudes.push_back(parse_geo_double(field->element[1]));
+            } else {
+                result.distances.push_back(parse_geo_double(field));
+            }
+        }
+    }
+
+    return result;
+}
+
 qb::redis::stream_id
 parse(ParseTag<qb::redis::stream_id>, redisReply &reply) {
     if (!qb::redis::is_string(reply)) {
@@ -987,6 +1060,173 @@ parse(ParseTag<std::vector<qb::redis::score_member>>, redisReply &reply) {
     return result;
 }
 
+/**
+ * @brief Parses a sorted set reply into a structure-of-arrays list
+ *
+ * Accepts the flat member/score layout and the array of pairs layout.
+ * Member names are copied into one buffer owned by the result and string
+ * scores are converted in place, without temporary strings.
+ *
+ * @param tag Parse tag type (unused, for template specialization)
+ * @param reply The Redis reply to parse
+ * @return score_member_list holding all the entries
+ * @throws ParseError if the reply is not an array
+ * @throws ProtoError if an entry is malformed
+ */
+qb::redis::score_member_list
+parse(ParseTag<qb::redis::score_member_list>, redisReply &reply) {
+    if (!qb::redis::is_array(reply)) {
+        throw ParseError("ARRAY", reply);
+    }
+
+    const bool  nested = reply.elements && reply.element[0] != nullptr &&
+                        qb::redis::is_array(*reply.element[0]);
+    std::size_t count  = nested ? reply.elements : reply.elements / 2;
+    if (!nested && reply.elements % 2) {
+        throw ProtoError("Invalid array length for member-score pairs");
+    }
+
+    auto entry = [&](std::size_t i, std::size_t field) -> redisReply * {
+        redisReply *item = nullptr;
+        if (!nested) {
+            item = reply.element[i * 2 + field];
+        } else if (auto *pair = reply.element[i];
+                   pair != nullptr && qb::redis::is_array(*pair) && pair->elements == 2) {
+            item = pair->element[field];
+        }
+        if (item == nullptr)
+            throw ProtoError("Invalid member-score reply");
+        return item;
+    };
+
+    qb::redis::score_member_list result;
+    std::size_t                  total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto *member = entry(i, 0);
+        if (!qb::redis::is_string(*member))
+            throw ParseError("STRING", *member);
+        total += member->len;
+    }
+
+    result.members.reserve(count, total);
+    result.scores.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto *member = entry(i, 0);
+        result.members.push_back({member->str, member->len});
+        auto *score = entry(i, 1);
+        result.scores.push_back(qb::redis::is_string(*score)
+                                    ? std::strtod(score->str, nullptr)
+                                    : parse<double>(*score));
+    }
+
+    return result;
+}
+
+/**
+ * @brief Parses a ZMPOP/BZMPOP reply
+ * @param tag Parse tag type (unused, for template specialization)
+ * @param reply The Redis reply to parse, a key and its popped members
+ * @return sorted_set_pop_result holding the key and the members
+ * @throws ParseError if the reply is not an array
+ * @throws ProtoError if the reply does not have 2 elements
+ */
+qb::redis::sorted_set_pop_result
+parse(ParseTag<qb::redis::sorted_set_pop_result>, redisReply &reply) {
+    if (!qb::redis::is_array(reply)) {
+        throw ParseError("ARRAY", reply);
+    }
+
+    if (reply.elements != 2 || reply.element[0] == nullptr ||
+        reply.element[1] == nullptr) {
+        throw ProtoError("Invalid pop reply, expect array with 2 elements");
+    }
+
+    return {parse<std::string>(*reply.element[0]),
+            parse<qb::redis::score_member_list>(*reply.element[1])};
+}
+
+/**
+ * @brief Parses a LMPOP/BLMPOP reply
+ * @param tag Parse tag type (unused, for template specialization)
+ * @param reply The Redis reply to parse, a key and its popped elements
+ * @return list_pop_result holding the key and the elements
+ * @throws ParseError if the reply is not an array
+ * @throws ProtoError if the reply does not have 2 elements
+ */
+qb::redis::list_pop_result
+parse(ParseTag<qb::redis::list_pop_result>, redisReply &reply) {
+    if (!qb::redis::is_array(reply)) {
+        throw ParseError("ARRAY", reply);
+    }
+
+    if (reply.elements != 2 || reply.element[0] == nullptr ||
+        reply.element[1] == nullptr) {
+        throw ProtoError("Invalid pop reply, expect array with 2 elements");
+    }
+
+    return {parse<std::string>(*reply.element[0]),
+            parse<std::vector<std::string>>(*reply.element[1])};
+}
+
+/**
+ * @brief Parses field value pairs into a structure-of-arrays list
+ *
+ * Accepts the flat field/value layout and the array of pairs layout.
+ *
+ * @param tag Parse tag type (unused, for template specialization)
+ * @param reply The Redis reply to parse
+ * @return field_value_list holding all the pairs
+ * @throws ParseError if the reply is not an array
+ * @throws ProtoError if an entry is malformed
+ */
+qb::redis::field_value_list
+parse(ParseTag<qb::redis::field_value_list>, redisReply &reply) {
+    if (!qb::redis::is_array(reply)) {
+        throw ParseError("ARRAY", reply);
+    }
+
+    const bool  nested = reply.elements && reply.element[0] != nullptr &&
+                        qb::redis::is_array(*reply.element[0]);
+    std::size_t count  = nested ? reply.elements : reply.elements / 2;
+    if (!nested && reply.elements % 2) {
+        throw ProtoError("Invalid array length for field-value pairs");
+    }
+
+    auto entry = [&](std::size_t i, std::size_t field) -> redisReply & {
+        redisReply *item = nullptr;
+        if (!nested) {
+            item = reply.element[i * 2 + field];
+        } else if (auto *pair = reply.element[i];
+                   pair != nullptr && qb::redis::is_array(*pair) && pair->elements == 2) {
+            item = pair->element[field];
+        }
+        if (item == nullptr)
+            throw ProtoError("Invalid field-value reply");
+        if (!qb::redis::is_string(*item))
+            throw ParseError("STRING", *item);
+        return *item;
+    };
+
+    qb::redis::field_value_list result;
+    std::size_t                 fields = 0;
+    std::size_t                 values = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        fields += entry(i, 0).len;
+        values += entry(i, 1).len;
+    }
+
+    result.fields.reserve(count, fields);
+    result.values.reserve(count, values);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto &field = entry(i, 0);
+        auto &value = entry(i, 1);
+        result.fields.push_back({field.str, field.len});
+        result.values.push_back({value.str, value.len});
+    }
+
+    return result;
+}
+
 /**
  * @brief Parses a Redis reply into a vector of string-double pairs
  * @param tag Parse tag type (unused, for template specialization)
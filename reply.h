@@ -19,6 +19,7 @@
 #define QBM_REDIS_REPLY_H
 
 #include <cassert>
+#include <charconv>
 #include <string>
 #include <string_view>
 #include <optional>
@@ -154,6 +155,8 @@ std::vector<char>         parse(ParseTag<std::vector<char>>, redisReply &reply);
 std::chrono::milliseconds parse(ParseTag<std::chrono::milliseconds>, redisReply &reply);
 std::chrono::seconds      parse(ParseTag<std::chrono::seconds>, redisReply &reply);
 qb::redis::geo_pos        parse(ParseTag<qb::redis::geo_pos>, redisReply &reply);
+qb::redis::geo_search_result parse(ParseTag<qb::redis::geo_search_result>,
+                                   redisReply &reply);
 qb::redis::stream_id      parse(ParseTag<qb::redis::stream_id>, redisReply &reply);
 qb::redis::stream_entry   parse(ParseTag<qb::redis::stream_entry>, redisReply &reply);
 stream_entry_list         parse(ParseTag<stream_entry_list>, redisReply &reply);
@@ -162,6 +165,14 @@ qb::redis::score          parse(ParseTag<qb::redis::score>, redisReply &reply);
 qb::redis::score_member   parse(ParseTag<qb::redis::score_member>, redisReply &reply);
 std::vector<qb::redis::score_member>
 parse(ParseTag<std::vector<qb::redis::score_member>>, redisReply &reply);
+qb::redis::score_member_list
+parse(ParseTag<qb::redis::score_member_list>, redisReply &reply);
+qb::redis::sorted_set_pop_result
+parse(ParseTag<qb::redis::sorted_set_pop_result>, redisReply &reply);
+qb::redis::list_pop_result
+parse(ParseTag<qb::redis::list_pop_result>, redisReply &reply);
+qb::redis::field_value_list
+parse(ParseTag<qb::redis::field_value_list>, redisReply &reply);
 qb::redis::search_result   parse(ParseTag<qb::redis::search_result>, redisReply &reply);
 qb::redis::cluster_node    parse(ParseTag<qb::redis::cluster_node>, redisReply &reply);
 qb::redis::memory_info     parse(ParseTag<qb::redis::memory_info>, redisReply &reply);
@@ -549,6 +560,16 @@ redis_count(const char* ) {
     return 1;
 }
 
+/**
+ * @brief Counts the number of elements in a string view for Redis protocol
+ * @param Unused string view parameter
+ * @return Always returns 1, as a string view is a single element
+ */
+inline std::size_t
+redis_count(std::string_view const &) {
+    return 1;
+}
+
 /**
  * @brief Counts the number of elements in a string for Redis protocol
  * @param Unused string parameter
@@ -684,6 +705,38 @@ to_redis_string(qb::allocator::pipe<char> &pipe, std::string const &val) {
     return true;
 }
 
+/**
+ * @brief Converts a string view to Redis protocol format and writes it to a pipe
+ * @param pipe Output pipe to write to
+ * @param val String view to convert
+ * @return Always returns true
+ */
+inline bool
+to_redis_string(qb::allocator::pipe<char> &pipe, std::string_view const &val) {
+    pipe << '$' << val.size() << "\r\n";
+    pipe.write(val.data(), val.size());
+    pipe << "\r\n";
+    return true;
+}
+
+/**
+ * @brief Writes a double as a Redis bulk string
+ *
+ * Uses the shortest representation that reads back to the same value, so
+ * scores and coordinates keep their full precision and no temporary string
+ * is allocated.
+ *
+ * @param pipe Output pipe to write to
+ * @param value Value to write
+ * @return Always returns true
+ */
+inline bool
+to_redis_double(qb::allocator::pipe<char> &pipe, double value) {
+    char buffer[32];
+    auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return to_redis_string(pipe, std::string_view(buffer, res.ptr - buffer));
+}
+
 /**
  * @brief Converts an arithmetic value to Redis protocol format and writes it to a pipe
  * @param pipe Output pipe to write to
@@ -693,7 +746,10 @@ to_redis_string(qb::allocator::pipe<char> &pipe, std::string const &val) {
 template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
 inline bool
 to_redis_string(qb::allocator::pipe<char> &pipe, T const &val) {
-    return to_redis_string(pipe, std::to_string(val));
+    if constexpr (std::is_floating_point_v<T>)
+        return to_redis_double(pipe, static_cast<double>(val));
+    else
+        return to_redis_string(pipe, std::to_string(val));
 }
 
 /**
@@ -820,6 +876,169 @@ to_redis_string(qb::allocator::pipe<char> &pipe, qb::redis::geo_pos const &pos)
     return true;
 }
 
+/**
+ * @brief Writes an integer as a bulk string, without string temporaries
+ * @param pipe Output pipe to write to
+ * @param value Integer to write
+ * @param prefix Optional character written before the digits (0 for none)
+ * @return Always returns true
+ */
+inline bool
+to_redis_integer(qb::allocator::pipe<char> &pipe, long long value, char prefix = 0) {
+    std::size_t        len = (prefix != 0) + (value < 0);
+    unsigned long long abs = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                       : static_cast<unsigned long long>(value);
+    do {
+        ++len;
+        abs /= 10;
+    } while (abs);
+
+    pipe << '$' << len << "\r\n";
+    if (prefix)
+        pipe << prefix;
+    pipe << value << "\r\n";
+    return true;
+}
+
+/**
+ * @brief Converts BITFIELD operations to Redis protocol format
+ * @param pipe Output pipe to write to
+ * @param ops Operations to convert
+ * @return Always returns true
+ */
+inline bool
+to_redis_string(qb::allocator::pipe<char> &pipe, qb::redis::bitfield_ops const &ops) {
+    using Kind = qb::redis::bitfield_ops::Kind;
+
+    for (const auto &op : ops.operations()) {
+        switch (op.kind) {
+            case Kind::GET:
+                to_redis_string(pipe, "GET");
+                break;
+            case Kind::SET:
+                to_redis_string(pipe, "SET");
+                break;
+            case Kind::INCRBY:
+                to_redis_string(pipe, "INCRBY");
+                break;
+            case Kind::OVERFLOW_POLICY:
+                to_redis_string(pipe, "OVERFLOW");
+                switch (op.overflow) {
+                    case qb::redis::BitfieldOverflow::WRAP:
+                        to_redis_string(pipe, "WRAP");
+                        break;
+                    case qb::redis::BitfieldOverflow::SAT:
+                        to_redis_string(pipe, "SAT");
+                        break;
+                    case qb::redis::BitfieldOverflow::FAIL:
+                        to_redis_string(pipe, "FAIL");
+                        break;
+                }
+                continue;
+        }
+        to_redis_integer(pipe, op.type.bits, op.type.is_signed ? 'i' : 'u');
+        to_redis_integer(pipe, op.offset.value, op.offset.indexed ? '#' : 0);
+        if (op.kind != Kind::GET)
+            to_redis_integer(pipe, op.value);
+    }
+    return true;
+}
+
+/**
+ * @brief Converts a geo_points batch to longitude latitude member triplets
+ * @param pipe Output pipe to write to
+ * @param points Points to convert
+ * @return Always returns true
+ */
+template <typename Member>
+bool
+to_redis_string(qb::allocator::pipe<char> &pipe, qb::redis::geo_points<Member> const &points) {
+    for (std::size_t i = 0; i < points.size; ++i) {
+        to_redis_string(pipe, points.longitudes[i]);
+        to_redis_string(pipe, points.latitudes[i]);
+        to_redis_string(pipe, points.members[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief Converts a score_members batch to score member pairs
+ * @param pipe Output pipe to write to
+ * @param entries Entries to convert
+ * @return Always returns true
+ */
+template <typename Member>
+bool
+to_redis_string(qb::allocator::pipe<char> &pipe,
+                qb::redis::score_members<Member> const &entries) {
+    for (std::size_t i = 0; i < entries.size; ++i) {
+        to_redis_double(pipe, entries.scores[i]);
+        to_redis_string(pipe, entries.members[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief Converts a geo_origin to FROMMEMBER or FROMLONLAT arguments
+ * @param pipe Output pipe to write to
+ * @param origin Search center to convert
+ * @return Always returns true
+ */
+inline bool
+to_redis_string(qb::allocator::pipe<char> &pipe, qb::redis::geo_origin const &origin) {
+    if (!origin.member.empty()) {
+        to_redis_string(pipe, "FROMMEMBER");
+        return to_redis_string(pipe, origin.member);
+    }
+    to_redis_string(pipe, "FROMLONLAT");
+    return to_redis_string(pipe, origin.position);
+}
+
+/**
+ * @brief Converts a geo_shape to BYRADIUS or BYBOX arguments
+ * @param pipe Output pipe to write to
+ * @param shape Search area to convert
+ * @return Always returns true
+ */
+inline bool
+to_redis_string(qb::allocator::pipe<char> &pipe, qb::redis::geo_shape const &shape) {
+    if (shape.is_box()) {
+        to_redis_string(pipe, "BYBOX");
+        to_redis_string(pipe, shape.width);
+        to_redis_string(pipe, shape.height);
+    } else {
+        to_redis_string(pipe, "BYRADIUS");
+        to_redis_string(pipe, shape.width);
+    }
+    return to_redis_string(pipe, std::to_string(shape.unit));
+}
+
+/**
+ * @brief Converts geo_search_options to GEOSEARCH optional arguments
+ * @param pipe Output pipe to write to
+ * @param opts Search options to convert
+ * @return Always returns true
+ */
+inline bool
+to_redis_string(qb::allocator::pipe<char> &pipe,
+                qb::redis::geo_search_options const &opts) {
+    if (opts.sort != qb::redis::GeoSort::NONE)
+        to_redis_string(pipe, std::to_string(opts.sort));
+    if (opts.count > 0) {
+        to_redis_string(pipe, "COUNT");
+        to_redis_string(pipe, opts.count);
+        if (opts.any)
+            to_redis_string(pipe, "ANY");
+    }
+    if (opts.with_coord)
+        to_redis_string(pipe, "WITHCOORD");
+    if (opts.with_dist)
+        to_redis_string(pipe, "WITHDIST");
+    if (opts.with_hash)
+        to_redis_string(pipe, "WITHHASH");
+    return true;
+}
+
 /**
  * @brief Converts a stream_id to Redis protocol format and writes it to a pipe
  * @param pipe Output pipe to write to
@@ -1019,6 +1238,75 @@ redis_count(qb::redis::geo_pos const &) {
     return 2;
 }
 
+/**
+ * @brief Counts the number of elements in BITFIELD operations for Redis protocol
+ * @param ops Operations to count
+ * @return Number of tokens written by to_redis_string
+ */
+inline std::size_t
+redis_count(qb::redis::bitfield_ops const &ops) {
+    using Kind = qb::redis::bitfield_ops::Kind;
+
+    std::size_t count = 0;
+    for (const auto &op : ops.operations())
+        count += op.kind == Kind::OVERFLOW_POLICY ? 2 : op.kind == Kind::GET ? 3 : 4;
+    return count;
+}
+
+/**
+ * @brief Counts the number of elements in a geo_points batch for Redis protocol
+ * @param points Points to count
+ * @return Three elements per point
+ */
+template <typename Member>
+std::size_t
+redis_count(qb::redis::geo_points<Member> const &points) {
+    return points.size * 3;
+}
+
+/**
+ * @brief Counts the number of elements in a score_members batch for Redis protocol
+ * @param entries Entries to count
+ * @return Two elements per entry
+ */
+template <typename Member>
+std::size_t
+redis_count(qb::redis::score_members<Member> const &entries) {
+    return entries.size * 2;
+}
+
+/**
+ * @brief Counts the number of elements in a geo_origin for Redis protocol
+ * @param origin Search center
+ * @return 2 for FROMMEMBER, 3 for FROMLONLAT
+ */
+inline std::size_t
+redis_count(qb::redis::geo_origin const &origin) {
+    return origin.member.empty() ? 3 : 2;
+}
+
+/**
+ * @brief Counts the number of elements in a geo_shape for Redis protocol
+ * @param shape Search area
+ * @return 3 for BYRADIUS, 4 for BYBOX
+ */
+inline std::size_t
+redis_count(qb::redis::geo_shape const &shape) {
+    return shape.is_box() ? 4 : 3;
+}
+
+/**
+ * @brief Counts the number of elements in geo_search_options for Redis protocol
+ * @param opts Search options
+ * @return Number of arguments written by to_redis_string
+ */
+inline std::size_t
+redis_count(qb::redis::geo_search_options const &opts) {
+    return (opts.sort != qb::redis::GeoSort::NONE) +
+           (opts.count > 0 ? 2 + opts.any : 0) + opts.with_coord + opts.with_dist +
+           opts.with_hash;
+}
+
 /**
  * @brief Counts the number of elements in a stream_id for Redis protocol
  * @param Unused stream_id parameter
@@ -1068,6 +1356,54 @@ redis_count(qb::redis::json_value const &json) {
     }
 }
 
+/**
+ * @struct encoded_args
+ * @brief Command arguments already encoded as RESP bulk strings
+ *
+ * Lets callers encode the constant part of a hot command once, it is then
+ * written to the pipe with a single copy on every call.
+ */
+struct encoded_args {
+    std::string bytes;   ///< Encoded bulk strings
+    std::size_t count{}; ///< Number of bulk strings in bytes
+};
+
+/**
+ * @brief Counts the number of elements in pre-encoded arguments
+ * @param args The pre-encoded arguments
+ * @return Number of bulk strings they contain
+ */
+inline std::size_t
+redis_count(encoded_args const &args) {
+    return args.count;
+}
+
+/**
+ * @brief Writes pre-encoded arguments to a pipe
+ * @param pipe Output pipe to write to
+ * @param args Pre-encoded arguments
+ * @return Always returns true
+ */
+inline bool
+to_redis_string(qb::allocator::pipe<char> &pipe, encoded_args const &args) {
+    pipe.write(args.bytes.data(), args.bytes.size());
+    return true;
+}
+
+/**
+ * @brief Encodes arguments once for reuse in many commands
+ * @param args Arguments to encode
+ * @return The encoded arguments
+ */
+template <typename... Args>
+encoded_args
+encode_args(Args const &...args) {
+    qb::allocator::pipe<char> pipe;
+    (to_redis_string(pipe, args) && ...);
+    return {std::string(pipe.begin(), pipe.size()),
+            (std::size_t{0} + ... + redis_count(args))};
+}
+
 /**
  * @brief Formats and writes Redis commands to a pipe
  *
@@ -1118,6 +1454,68 @@ struct Reply {
     }
 };
 
+/**
+ * @brief Merges the replies of several commands into one reply
+ *
+ * The first error is kept in the merged reply. The fan-in starts with one
+ * reference held by the sender, so that replies arriving while the commands
+ * are queued do not complete it: call hold() before each command and done()
+ * in its callback, then done() once every command is queued.
+ *
+ * @tparam T Result type of the merged reply
+ * @tparam Func Callback receiving the merged reply
+ */
+template <typename T, typename Func>
+struct fan_in {
+    Reply<T>           reply;
+    std::decay_t<Func> func;
+    std::size_t        pending = 1;
+
+    /**
+     * @brief Counts a command whose reply is awaited
+     */
+    void
+    hold(std::size_t count = 1) {
+        pending += count;
+    }
+
+    /**
+     * @brief Keeps the first error of the replies
+     * @return true if the reply failed
+     */
+    template <typename Reply_>
+    bool
+    failed(Reply_ &reply_) {
+        if (!reply_.ok() && reply.ok()) {
+            reply.ok()    = false;
+            reply.raw()   = std::move(reply_.raw());
+            reply.error() = reply_.error();
+        }
+        return !reply_.ok();
+    }
+
+    /**
+     * @brief Releases a reference, the last one passes the merged reply
+     */
+    void
+    done() {
+        if (!--pending)
+            std::move(func)(std::move(reply));
+    }
+};
+
+/**
+ * @brief Creates a fan-in holding the reference of the sender
+ * @param func Callback receiving the merged reply
+ * @param result Initial result of the merged reply
+ */
+template <typename T, typename Func>
+std::shared_ptr<fan_in<T, Func>>
+make_fan_in(Func &&func, T result = {}) {
+    return std::make_shared<fan_in<T, Func>>(
+        fan_in<T, Func>{{true, std::move(result), {}, {}}, std::forward<Func>(func)});
+}
+
 /**
  * @class IReply
  * @brief Interface for Redis reply handlers
@@ -1167,6 +1565,11 @@ public:
      */
     void
     operator()(redisReply *raw) final {
+        // No reply is received when the connection is lost
+        if (!raw) {
+            func(Reply<T>{false, {}, {}, "connection lost"});
+            return;
+        }
         try {
             func(Reply<T>{true, qb::redis::reply::parse<T>(*raw), reply_ptr(raw)});
         } catch (const ProtoError &) {
@@ -0,0 +1,153 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include "resp.h"
+
+namespace {
+
+/**
+ * @brief Reads the header line at pos, without its type byte and CRLF
+ * @return false if the line is incomplete
+ */
+bool
+header(std::string_view data, std::size_t &pos, std::string_view &line) {
+    const auto end = data.find("\r\n", pos);
+    if (end == std::string_view::npos)
+        return false;
+    line = data.substr(pos + 1, end - pos - 1);
+    pos  = end + 2;
+    return true;
+}
+
+long long
+integer(std::string_view text) {
+    long long  value = 0;
+    const auto end   = text.data() + text.size();
+    const auto result = std::from_chars(text.data(), end, value);
+    if (text.empty() || result.ec != std::errc{} || result.ptr != end)
+        throw std::invalid_argument("invalid RESP length");
+    return value;
+}
+
+/**
+ * @brief Skips a payload of size bytes followed by CRLF
+ * @return false if the payload is incomplete
+ */
+bool
+payload(std::string_view data, std::size_t &pos, long long size) {
+    if (static_cast<std::size_t>(size) + 2 > data.size() - pos)
+        return false;
+    pos += size;
+    if (data[pos] != '\r' || data[pos + 1] != '\n')
+        throw std::invalid_argument("invalid RESP payload");
+    pos += 2;
+    return true;
+}
+
+} // namespace
+
+namespace qb::redis {
+
+std::size_t
+resp_reply_size(std::string_view data) {
+    std::size_t      pos     = 0;
+    std::size_t      pending = 1; // Elements left, nested ones included
+    std::string_view line;
+    while (pending--) {
+        if (pos == data.size())
+            return 0;
+        const char type = data[pos];
+        if (!header(data, pos, line))
+            return 0;
+        switch (type) {
+        case '+': // Simple string
+        case '-': // Error
+        case ':': // Integer
+        case '_': // Null
+        case ',': // Double
+        case '#': // Boolean
+        case '(': // Big number
+            break;
+        case '$': // Bulk string
+        case '!': // Bulk error
+        case '=': { // Verbatim string
+            const auto size = integer(line);
+            if (size >= 0 && !payload(data, pos, size))
+                return 0;
+            break;
+        }
+        case '*': // Array
+        case '~': // Set
+        case '>': { // Push
+            const auto count = integer(line);
+            if (count > 0)
+                pending += count;
+            break;
+        }
+        case '%': // Map
+        case '|': { // Attributes, followed by the reply they describe
+            const auto count = integer(line);
+            if (count < 0)
+                throw std::invalid_argument("negative RESP map size");
+            pending += 2 * static_cast<std::size_t>(count) + (type == '|');
+            break;
+        }
+        default:
+            throw std::invalid_argument("invalid RESP type");
+        }
+    }
+    return pos;
+}
+
+std::size_t
+resp_command_size(std::string_view data, resp_command &command) {
+    if (data.empty())
+        return 0;
+    if (data[0] != '*')
+        throw std::invalid_argument("RESP command is not an array");
+    std::size_t      pos = 0;
+    std::string_view line;
+    if (!header(data, pos, line))
+        return 0;
+    const auto argc = integer(line);
+    if (argc <= 0)
+        throw std::invalid_argument("empty RESP command");
+
+    std::string_view args[2];
+    for (long long i = 0; i < argc; ++i) {
+        if (pos == data.size())
+            return 0;
+        if (data[pos] != '$')
+            throw std::invalid_argument("RESP argument is not a bulk string");
+        if (!header(data, pos, line))
+            return 0;
+        const auto size = integer(line);
+        if (size < 0)
+            throw std::invalid_argument("null RESP argument");
+        if (i < 2)
+            args[i] = data.substr(pos, std::min<std::size_t>(size, data.size() - pos));
+        if (!payload(data, pos, size))
+            return 0;
+    }
+    command = {data.substr(0, pos), args[0], args[1], static_cast<std::size_t>(argc)};
+    return pos;
+}
+
+} // namespace qb::redis
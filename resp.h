@@ -0,0 +1,63 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_RESP_H
+#define QBM_REDIS_RESP_H
+#include <cstddef>
+#include <string_view>
+
+namespace qb::redis {
+
+/**
+ * @struct resp_command
+ * @brief Command located in a RESP buffer, as views on the buffer
+ */
+struct resp_command {
+    std::string_view raw;  ///< Whole encoded command
+    std::string_view name; ///< First argument
+    std::string_view key;  ///< Second argument, empty if none
+    std::size_t      argc = 0;
+};
+
+/**
+ * @brief Finds the end of the reply at the start of data
+ *
+ * Only scans the reply, nothing is decoded or allocated. RESP2 and RESP3
+ * types are supported, aggregates included.
+ *
+ * @param data Received bytes
+ * @return Size of the reply, 0 if it is incomplete
+ * @throws std::invalid_argument if data does not start with a valid reply
+ */
+std::size_t resp_reply_size(std::string_view data);
+
+/**
+ * @brief Locates the command at the start of data
+ *
+ * The command must be an array of bulk strings, as sent by clients and
+ * written in AOF files.
+ *
+ * @param data Encoded commands
+ * @param command Set to the located command
+ * @return Size of the command, 0 if it is incomplete
+ * @throws std::invalid_argument if data does not start with a valid command
+ */
+std::size_t resp_command_size(std::string_view data, resp_command &command);
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_RESP_H
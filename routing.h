@@ -0,0 +1,78 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_ROUTING_H
+#define QBM_REDIS_ROUTING_H
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string_view>
+
+namespace qb::redis {
+
+namespace detail {
+
+/**
+ * @brief Compares two command names, ignoring the case
+ */
+inline bool
+iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::toupper(static_cast<unsigned char>(x)) ==
+                      std::toupper(static_cast<unsigned char>(y));
+           });
+}
+
+/**
+ * @brief 64 bits FNV-1a hash with a final avalanche
+ */
+inline std::uint64_t
+shard_hash(std::string_view data) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * @brief Gets the part of a key that is hashed, the content of the first
+ * non empty {hash tag} as in Redis Cluster
+ */
+inline std::string_view
+shard_tag(std::string_view key) {
+    const auto open = key.find('{');
+    if (open == std::string_view::npos)
+        return key;
+    const auto close = key.find('}', open + 1);
+    if (close == std::string_view::npos || close == open + 1)
+        return key;
+    return key.substr(open + 1, close - open - 1);
+}
+
+} // namespace detail
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_ROUTING_H
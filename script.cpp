@@ -0,0 +1,115 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include "script.h"
+
+namespace {
+
+inline uint32_t
+rol(uint32_t value, unsigned bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+/**
+ * @brief Processes one 64 bytes block of a SHA1 message
+ * @param state Current hash state
+ * @param block Block to process
+ */
+void
+sha1_block(uint32_t state[5], const unsigned char *block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+               (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 80; ++i)
+        w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t tmp = rol(a, 5) + f + e + k + w[i];
+        e            = d;
+        d            = c;
+        c            = rol(b, 30);
+        b            = a;
+        a            = tmp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+} // namespace
+
+namespace qb::redis {
+
+std::string
+sha1_hex(std::string_view data) {
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    auto        bytes = reinterpret_cast<const unsigned char *>(data.data());
+    std::size_t size  = data.size();
+    std::size_t off   = 0;
+    for (; off + 64 <= size; off += 64)
+        sha1_block(state, bytes + off);
+
+    // Padding: 0x80, zeros, then the message length in bits (big endian)
+    unsigned char tail[128] = {};
+    std::size_t   rest      = size - off;
+    std::memcpy(tail, bytes + off, rest);
+    tail[rest]           = 0x80;
+    std::size_t tail_len = rest < 56 ? 64 : 128;
+    uint64_t    bits     = uint64_t(size) * 8;
+    for (int i = 0; i < 8; ++i)
+        tail[tail_len - 1 - i] = static_cast<unsigned char>(bits >> (i * 8));
+    for (std::size_t i = 0; i < tail_len; i += 64)
+        sha1_block(state, tail + i);
+
+    static constexpr char hex[] = "0123456789abcdef";
+    std::string           digest(40, '0');
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 8; ++j)
+            digest[i * 8 + j] = hex[(state[i] >> (28 - j * 4)) & 0xF];
+    }
+    return digest;
+}
+
+script::script(std::string source) {
+    auto digest = sha1_hex(source);
+    _data = std::make_shared<const data>(data{std::move(source), std::move(digest)});
+}
+
+} // namespace qb::redis
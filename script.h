@@ -0,0 +1,82 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_SCRIPT_H
+#define QBM_REDIS_SCRIPT_H
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace qb::redis {
+
+/**
+ * @brief Computes the SHA1 digest of a buffer as Redis does for scripts
+ *
+ * @param data Buffer to hash
+ * @return 40 characters lowercase hexadecimal digest
+ */
+std::string sha1_hex(std::string_view data);
+
+/**
+ * @class script
+ * @brief Lua script with its SHA1 digest computed client side
+ *
+ * The digest is the one Redis returns from SCRIPT LOAD, so a script can be
+ * executed with EVALSHA without ever asking the server for it. Copies share
+ * the same source buffer, so a script is cheap to capture in callbacks.
+ */
+class script {
+    struct data {
+        std::string source;
+        std::string sha1;
+    };
+    std::shared_ptr<const data> _data;
+
+public:
+    /**
+     * @brief Constructs a script and computes its SHA1 digest
+     * @param source Lua source of the script
+     */
+    explicit script(std::string source);
+
+    /**
+     * @brief Gets the Lua source of the script
+     * @return The script source
+     */
+    [[nodiscard]] const std::string &
+    source() const {
+        return _data->source;
+    }
+
+    /**
+     * @brief Gets the SHA1 digest of the script
+     * @return 40 characters hexadecimal digest
+     */
+    [[nodiscard]] const std::string &
+    sha1() const {
+        return _data->sha1;
+    }
+
+    bool
+    operator==(const script &other) const {
+        return sha1() == other.sha1();
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_SCRIPT_H
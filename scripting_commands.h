@@ -17,7 +17,9 @@
 
 #ifndef QBM_REDIS_SCRIPTING_COMMANDS_H
 #define QBM_REDIS_SCRIPTING_COMMANDS_H
+#include <algorithm>
 #include "reply.h"
+#include "script.h"
 
 namespace qb::redis {
 
@@ -38,6 +40,41 @@ private:
     derived() {
         return static_cast<Derived &>(*this);
     }
+    std::vector<script> scripts_;
+
+    /**
+     * @brief Checks if a failed reply is a NOSCRIPT error
+     * @param reply The failed reply
+     * @return true if the server does not know the requested script
+     */
+    template <typename Ret>
+    static bool
+    is_noscript(Reply<Ret> &reply) {
+        return !reply.ok() && reply.error().compare(0, 8, "NOSCRIPT") == 0;
+    }
+
+    /**
+     * @brief Pipelines a SCRIPT LOAD of a script, ignoring the reply
+     * @param s Script to load
+     */
+    void
+    load_script(const script &s) {
+        derived().template command<std::string>([](auto &&) {}, "SCRIPT", "LOAD",
+                                                s.source());
+    }
+
+protected:
+    /**
+     * @brief Loads all registered scripts in the server script cache
+     *
+     * Called by the client when the connection is established, so that the
+     * first EVALSHA of a registered script does not hit a NOSCRIPT error.
+     */
+    void
+    preload_scripts() {
+        for (const auto &s : scripts_)
+            load_script(s);
+    }
 
 public:
     /**
@@ -116,6 +153,107 @@ public:
                                                script, keys.size(), keys, args);
     }
 
+    /**
+     * @brief Executes a script by its locally computed SHA1 hash
+     *
+     * Only the 40 bytes digest is sent. If the server replies NOSCRIPT (script
+     * cache flushed, failover, ...) the call is retried once with EVAL, which
+     * also caches the script again on the server.
+     *
+     * @tparam Ret Return type of the script execution
+     * @param s Script to execute
+     * @param keys Vector of key names that the script will access
+     * @param args Vector of additional arguments to the script
+     * @return Result of the script execution, typed as Ret
+     * @throws std::runtime_error if the script fails
+     */
+    template <typename Ret>
+    Ret
+    evalsha(const script &s, const std::vector<std::string> &keys = {},
+            const std::vector<std::string> &args = {}) {
+        Reply<Ret> value{};
+        evalsha<Ret>([&value](auto &&reply) { value = std::move(reply); }, s, keys,
+                     args);
+        derived().await();
+
+        if (!value.ok())
+            throw std::runtime_error(std::string(value.error()));
+
+        return std::move(value.result());
+    }
+
+    /**
+     * @brief Asynchronous version of evalsha with NOSCRIPT fallback
+     *
+     * The callback is invoked once, with the EVAL reply if a fallback was needed.
+     * The EVAL is queued when the NOSCRIPT error is received, so it runs after
+     * the commands pipelined behind the EVALSHA.
+     *
+     * @tparam Func Callback function type
+     * @tparam Ret Return type of the script execution
+     * @param func Callback function
+     * @param s Script to execute
+     * @param keys Vector of key names that the script will access
+     * @param args Vector of additional arguments to the script
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Ret, typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<Ret> &&>, Derived &>
+    evalsha(Func &&func, const script &s, const std::vector<std::string> &keys = {},
+            const std::vector<std::string> &args = {}) {
+        return derived().template command<Ret>(
+            [this, s, keys, args, func = std::forward<Func>(func)](auto &&reply) mutable {
+                if (is_noscript(reply)) {
+                    derived().template command<Ret>(std::move(func), "EVAL", s.source(),
+                                                    keys.size(), keys, args);
+                    return;
+                }
+                std::move(func)(std::forward<decltype(reply)>(reply));
+            },
+            "EVALSHA", s.sha1(), keys.size(), keys, args);
+    }
+
+    /**
+     * @brief Registers a script to be loaded on every connection
+     *
+     * Registered scripts are loaded with SCRIPT LOAD during the connection
+     * handshake, so EVALSHA calls made right after connecting find them. A
+     * script registered on a connected client is also loaded at once, ahead
+     * of the commands sent after the registration.
+     *
+     * @param source Lua source of the script
+     * @return The script object to use with evalsha
+     */
+    script
+    register_script(std::string source) {
+        return register_script(script{std::move(source)});
+    }
+
+    /**
+     * @brief Registers a script to be loaded on every connection
+     *
+     * @param s Script to register
+     * @return The registered script
+     */
+    script
+    register_script(const script &s) {
+        if (std::find(scripts_.begin(), scripts_.end(), s) != scripts_.end())
+            return s;
+        scripts_.push_back(s);
+        if (derived().is_alive())
+            load_script(s);
+        return s;
+    }
+
+    /**
+     * @brief Gets the scripts registered for preloading
+     * @return Vector of registered scripts
+     */
+    const std::vector<script> &
+    registered_scripts() const {
+        return scripts_;
+    }
+
     /**
      * @brief Checks if scripts exist in the script cache by their SHA1 hashes
      *
@@ -1025,6 +1025,9 @@ public:
     /**
      * @brief Synchronizes with a master
      *
+     * @note The master answers with the RDB payload and the replication stream,
+     * which the client can not parse: use qb::redis::replica from replication.h
+     * to consume them.
      * @return status object with the result
      * @see https://redis.io/commands/sync
      */
@@ -1049,6 +1052,9 @@ public:
     /**
      * @brief Partially synchronizes with a master
      *
+     * @note The master answers with the RDB payload and the replication stream,
+     * which the client can not parse: use qb::redis::replica from replication.h
+     * to consume them.
      * @param replication_id Replication ID
      * @param offset Replication offset
      * @return status object with the result
@@ -0,0 +1,608 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_SHARDED_CLIENT_H
+#define QBM_REDIS_SHARDED_CLIENT_H
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "redis.h"
+#include "routing.h"
+
+namespace qb::redis {
+
+/**
+ * @enum ShardingAlgorithm
+ * @brief Consistent hashing used to map keys to nodes
+ */
+enum class ShardingAlgorithm {
+    KETAMA, ///< Ring of virtual points, any node can be added or removed
+    JUMP    ///< Jump consistent hash, nodes are added or removed at the end
+};
+
+namespace detail {
+
+/**
+ * @brief Jump consistent hash of Lamping and Veach
+ */
+inline std::size_t
+jump_hash(std::uint64_t key, std::size_t buckets) {
+    std::int64_t b = -1;
+    std::int64_t j = 0;
+    while (j < static_cast<std::int64_t>(buckets)) {
+        b   = j;
+        key = key * 2862933555777941757ULL + 1;
+        j   = static_cast<std::int64_t>((b + 1) * (double(1LL << 31) /
+                                                 double((key >> 33) + 1)));
+    }
+    return static_cast<std::size_t>(b);
+}
+
+template <typename T>
+constexpr bool is_shard_key_v = std::is_convertible_v<const T &, std::string_view>;
+
+template <typename T>
+constexpr bool is_shard_key_list_v =
+    is_shard_key_v<T> || std::is_same_v<T, std::vector<std::string>>;
+
+} // namespace detail
+
+/**
+ * @class sharded_client
+ * @brief Client spreading keys over independent Redis instances
+ *
+ * Exposes the key, string, list, hash, set, sorted set, geo and bitmap command
+ * traits. Each command is sent to the node owning its key, chosen by
+ * consistent hashing of the key or of its {hash tag}. Other commands on
+ * several keys (RENAME, LMOVE, SINTERSTORE...) fail with a CROSSSLOT error
+ * unless all their keys are on one node: use hash tags to keep such keys
+ * together.
+ *
+ * DEL, EXISTS, TOUCH and UNLINK are split per node and their counts summed,
+ * MGET and MSET are split and merged in key order, SINTER and SUNION are
+ * split and their members merged, and KEYS is sent to every node. The per
+ * node commands are all written before any reply is read, so the nodes work
+ * in parallel. RANDOMKEY, SCAN and the other commands without key go to the
+ * first node; use nodes() to reach the others.
+ *
+ * With KETAMA each node owns points * weight points of a hash ring, and
+ * adding or removing a node only moves the keys of its points. With JUMP each
+ * unit of weight is a bucket; only nodes added or removed last keep the other
+ * keys in place.
+ *
+ * The nodes are owned by the caller and must share the event loop of the
+ * sharded client.
+ *
+ * @tparam QB_IO_ The QB I/O type of the nodes
+ */
+template <typename QB_IO_>
+class sharded_client
+    : public key_commands<sharded_client<QB_IO_>>
+    , public string_commands<sharded_client<QB_IO_>>
+    , public list_commands<sharded_client<QB_IO_>>
+    , public hash_commands<sharded_client<QB_IO_>>
+    , public set_commands<sharded_client<QB_IO_>>
+    , public sorted_set_commands<sharded_client<QB_IO_>>
+    , public geo_commands<sharded_client<QB_IO_>>
+    , public bitmap_commands<sharded_client<QB_IO_>> {
+public:
+    using client_type = detail::Redis<QB_IO_>;
+
+    /**
+     * @struct options
+     * @brief Hashing policy of a sharded client
+     */
+    struct options {
+        ShardingAlgorithm algorithm = ShardingAlgorithm::KETAMA;
+        std::size_t       points    = 160; ///< Ring points per unit of weight
+    };
+
+    /**
+     * @struct node
+     * @brief Instance of the shard set
+     */
+    struct node {
+        std::string  name;   ///< Stable identifier hashed on the ring, host:port
+        client_type *client; ///< Connection to the instance
+        unsigned     weight; ///< Relative share of the keys
+    };
+
+private:
+    options                                             _opts;
+    std::vector<node>                                   _nodes;
+    std::vector<std::pair<std::uint64_t, std::size_t>> _ring;
+    std::vector<std::size_t>                            _buckets;
+
+    /**
+     * @brief Rebuilds the ring or the buckets after a change of the nodes
+     */
+    void
+    rebuild() {
+        _ring.clear();
+        _buckets.clear();
+        for (std::size_t i = 0; i < _nodes.size(); ++i) {
+            const auto &n = _nodes[i];
+            if (_opts.algorithm == ShardingAlgorithm::JUMP) {
+                _buckets.insert(_buckets.end(), n.weight, i);
+                continue;
+            }
+            const auto points = _opts.points * n.weight;
+            for (std::size_t p = 0; p < points; ++p)
+                _ring.emplace_back(
+                    detail::shard_hash(n.name + "-" + std::to_string(p)), i);
+        }
+        std::sort(_ring.begin(), _ring.end());
+    }
+
+    /**
+     * @brief Gets the index of the node owning a key
+     */
+    [[nodiscard]] std::size_t
+    index_of(std::string_view key) const {
+        if (_nodes.empty())
+            throw std::logic_error("sharded_client: no node");
+        const auto hash = detail::shard_hash(detail::shard_tag(key));
+        if (_opts.algorithm == ShardingAlgorithm::JUMP)
+            return _buckets[detail::jump_hash(hash, _buckets.size())];
+        auto it = std::lower_bound(_ring.begin(), _ring.end(),
+                                   std::make_pair(hash, std::size_t{0}));
+        return (it == _ring.end() ? _ring.front() : *it).second;
+    }
+
+    /**
+     * @brief Gets the positions of the keys among the arguments of a command
+     * @return First and past the last position, empty for commands without key
+     */
+    static std::pair<std::size_t, std::size_t>
+    key_span(const std::string &name) {
+        constexpr auto all = std::numeric_limits<std::size_t>::max();
+        if (name == "RANDOMKEY" || name == "SCAN" || name == "WAIT")
+            return {0, 0};
+        if (name == "DEL" || name == "EXISTS" || name == "TOUCH" || name == "UNLINK" ||
+            name == "MGET" || name == "MSETNX" || name == "WATCH" || name == "SINTER" ||
+            name == "SUNION" || name == "SDIFF" || name == "BLPOP" || name == "BRPOP" ||
+            name == "BZPOPMIN" || name == "BZPOPMAX" || name == "PFCOUNT" ||
+            name == "PFMERGE")
+            return {0, all};
+        if (name == "RENAME" || name == "RENAMENX" || name == "COPY" || name == "SMOVE" ||
+            name == "LMOVE" || name == "BLMOVE" || name == "RPOPLPUSH" ||
+            name == "BRPOPLPUSH" || name == "LCS" || name == "SINTERSTORE" ||
+            name == "SUNIONSTORE" || name == "SDIFFSTORE" || name == "ZRANGESTORE" ||
+            name == "GEOSEARCHSTORE")
+            return {0, 2};
+        if (name == "ZUNIONSTORE" || name == "ZINTERSTORE" || name == "ZDIFFSTORE")
+            return {0, 3};
+        if (name == "BITOP")
+            return {1, 3};
+        if (name == "SINTERCARD" || name == "LMPOP" || name == "ZMPOP" ||
+            name == "ZUNION" || name == "ZINTER" || name == "ZDIFF" ||
+            name == "ZINTERCARD")
+            return {1, 2};
+        if (name == "BLMPOP" || name == "BZMPOP")
+            return {2, 3};
+        return {0, 1};
+    }
+
+    template <typename T>
+    static void
+    key_arguments(std::vector<std::string_view> &keys, const T &arg) {
+        using type = std::decay_t<T>;
+        if constexpr (detail::is_shard_key_v<type>)
+            keys.emplace_back(std::string_view(arg));
+        else if constexpr (std::is_same_v<type, std::vector<std::string>>)
+            keys.insert(keys.end(), arg.begin(), arg.end());
+        else if constexpr (std::is_same_v<
+                               type, std::vector<std::pair<std::string, std::string>>>) {
+            for (const auto &pair : arg)
+                keys.emplace_back(pair.first);
+        }
+    }
+
+    /**
+     * @brief Gets the node owning every key of a command
+     * @return The index of the node, nullopt if the keys are on several nodes
+     */
+    template <typename... Args>
+    std::optional<std::size_t>
+    route(const std::string &name, const Args &...args) const {
+        const auto [first, last] = key_span(name);
+        std::vector<std::string_view> keys;
+        std::size_t                   i = 0;
+        ((i >= first && i < last ? key_arguments(keys, args) : (void)0, ++i), ...);
+        if (keys.empty())
+            return 0;
+        const auto owner = index_of(keys.front());
+        for (const auto &key : keys) {
+            if (index_of(key) != owner)
+                return std::nullopt;
+        }
+        return owner;
+    }
+
+    template <typename T>
+    static void
+    collect(std::vector<std::string> &keys, const T &arg) {
+        if constexpr (detail::is_shard_key_v<T>)
+            keys.emplace_back(std::string_view(arg));
+        else
+            keys.insert(keys.end(), arg.begin(), arg.end());
+    }
+
+    /**
+     * @brief Sends DEL, EXISTS, TOUCH or UNLINK per node and sums the counts
+     */
+    template <typename Func>
+    void
+    split_count(Func &&func, const std::string &name,
+                const std::vector<std::string> &keys) {
+        std::vector<std::vector<std::string>> groups(_nodes.size());
+        for (const auto &key : keys)
+            groups[index_of(key)].push_back(key);
+
+        auto state = make_fan_in<long long>(std::forward<Func>(func));
+        for (std::size_t i = 0; i < groups.size(); ++i) {
+            if (groups[i].empty())
+                continue;
+            state->hold();
+            _nodes[i].client->template command<long long>(
+                [state](auto &&reply) {
+                    if (!state->failed(reply))
+                        state->reply.result() += reply.result();
+                    state->done();
+                },
+                name, groups[i]);
+        }
+        state->done();
+    }
+
+    /**
+     * @brief Sends SINTER or SUNION per node and merges the members
+     */
+    template <typename Func>
+    void
+    split_sets(Func &&func, const std::string &name,
+               const std::vector<std::string> &keys) {
+        using members = std::vector<std::string>;
+        std::vector<std::vector<std::string>> groups(_nodes.size());
+        for (const auto &key : keys)
+            groups[index_of(key)].push_back(key);
+
+        auto       state = make_fan_in<members>(std::forward<Func>(func));
+        auto       first = std::make_shared<bool>(true);
+        const bool inter = name == "SINTER";
+        for (std::size_t i = 0; i < groups.size(); ++i) {
+            if (groups[i].empty())
+                continue;
+            state->hold();
+            _nodes[i].client->template command<members>(
+                [state, first, inter](auto &&reply) {
+                    if (!state->failed(reply)) {
+                        auto &part   = reply.result();
+                        auto &result = state->reply.result();
+                        std::sort(part.begin(), part.end());
+                        members merged;
+                        if (*first)
+                            merged = std::move(part);
+                        else if (inter)
+                            std::set_intersection(result.begin(), result.end(),
+                                                  part.begin(), part.end(),
+                                                  std::back_inserter(merged));
+                        else
+                            std::set_union(result.begin(), result.end(), part.begin(),
+                                           part.end(), std::back_inserter(merged));
+                        result = std::move(merged);
+                        *first = false;
+                    }
+                    state->done();
+                },
+                name, groups[i]);
+        }
+        state->done();
+    }
+
+    /**
+     * @brief Sends MGET per node and merges the values in key order
+     */
+    template <typename Func>
+    void
+    split_mget(Func &&func, const std::vector<std::string> &keys) {
+        using values = std::vector<std::optional<std::string>>;
+        std::vector<std::vector<std::string>> groups(_nodes.size());
+        std::vector<std::vector<std::size_t>> positions(_nodes.size());
+        for (std::size_t k = 0; k < keys.size(); ++k) {
+            const auto i = index_of(keys[k]);
+            groups[i].push_back(keys[k]);
+            positions[i].push_back(k);
+        }
+
+        auto state = make_fan_in<values>(std::forward<Func>(func), values(keys.size()));
+        for (std::size_t i = 0; i < groups.size(); ++i) {
+            if (groups[i].empty())
+                continue;
+            state->hold();
+            _nodes[i].client->template command<values>(
+                [state, at = std::move(positions[i])](auto &&reply) {
+                    if (!state->failed(reply)) {
+                        auto &result = reply.result();
+                        for (std::size_t k = 0; k < at.size() && k < result.size(); ++k)
+                            state->reply.result()[at[k]] = std::move(result[k]);
+                    }
+                    state->done();
+                },
+                "MGET", groups[i]);
+        }
+        state->done();
+    }
+
+    /**
+     * @brief Sends MSET per node
+     */
+    template <typename Func>
+    void
+    split_mset(Func &&func, const std::vector<std::pair<std::string, std::string>> &kv) {
+        std::vector<std::vector<std::pair<std::string, std::string>>> groups(
+            _nodes.size());
+        for (const auto &pair : kv)
+            groups[index_of(pair.first)].push_back(pair);
+
+        auto state = make_fan_in<status>(std::forward<Func>(func), status("OK"));
+        for (std::size_t i = 0; i < groups.size(); ++i) {
+            if (groups[i].empty())
+                continue;
+            state->hold();
+            _nodes[i].client->template command<status>(
+                [state](auto &&reply) {
+                    state->failed(reply);
+                    state->done();
+                },
+                "MSET", groups[i]);
+        }
+        state->done();
+    }
+
+    /**
+     * @brief Sends KEYS to every node and concatenates the keys
+     */
+    template <typename Func>
+    void
+    broadcast_keys(Func &&func, const std::string &pattern) {
+        using keys_type = std::vector<std::string>;
+        auto state      = make_fan_in<keys_type>(std::forward<Func>(func));
+        for (auto &n : _nodes) {
+            state->hold();
+            n.client->template command<keys_type>(
+                [state](auto &&reply) {
+                    if (!state->failed(reply)) {
+                        auto &keys = state->reply.result();
+                        keys.insert(keys.end(),
+                                    std::make_move_iterator(reply.result().begin()),
+                                    std::make_move_iterator(reply.result().end()));
+                    }
+                    state->done();
+                },
+                "KEYS", pattern);
+        }
+        state->done();
+    }
+
+public:
+    /**
+     * @brief Constructs an empty sharded client
+     * @param opts Hashing policy
+     */
+    explicit sharded_client(options opts = {})
+        : _opts(opts) {}
+
+    /**
+     * @brief Constructs a sharded client on nodes of weight 1
+     * @param nodes Pairs of stable node name and client
+     * @param opts Hashing policy
+     */
+    sharded_client(std::vector<std::pair<std::string, client_type *>> nodes,
+                   options opts = {})
+        : _opts(opts) {
+        for (auto &[name, client] : nodes)
+            _nodes.push_back({std::move(name), client, 1});
+        rebuild();
+    }
+
+    sharded_client(const sharded_client &) = delete;
+    sharded_client &operator=(const sharded_client &) = delete;
+
+    /**
+     * @brief Adds a node, remapping only the keys it now owns
+     * @param client Connection to the instance
+     * @param name Stable identifier of the instance, host:port
+     * @param weight Relative share of the keys
+     * @return Reference to the sharded client for chaining
+     */
+    sharded_client &
+    add_node(client_type &client, std::string name, unsigned weight = 1) {
+        if (!weight)
+            throw std::invalid_argument("sharded_client: weight must be positive");
+        _nodes.push_back({std::move(name), &client, weight});
+        rebuild();
+        return *this;
+    }
+
+    /**
+     * @brief Removes a node, its keys are remapped to the other nodes
+     * @param name Identifier of the node
+     * @return true if the node was found
+     */
+    bool
+    remove_node(const std::string &name) {
+        auto it = std::find_if(_nodes.begin(), _nodes.end(),
+                               [&](const node &n) { return n.name == name; });
+        if (it == _nodes.end())
+            return false;
+        _nodes.erase(it);
+        rebuild();
+        return true;
+    }
+
+    /**
+     * @brief Gets the nodes
+     */
+    [[nodiscard]] const std::vector<node> &
+    nodes() const {
+        return _nodes;
+    }
+
+    /**
+     * @brief Gets the client of the node owning a key
+     * @param key Key, or key with a {hash tag}
+     * @return The client of the node
+     */
+    client_type &
+    client_of(std::string_view key) {
+        return *_nodes[index_of(key)].client;
+    }
+
+    /**
+     * @brief Gets the name of the node owning a key
+     * @param key Key, or key with a {hash tag}
+     * @return The name of the node
+     */
+    [[nodiscard]] const std::string &
+    name_of(std::string_view key) const {
+        return _nodes[index_of(key)].name;
+    }
+
+    /**
+     * @brief Sends a command to the node owning its key
+     *
+     * DEL, EXISTS, TOUCH, UNLINK, MGET, MSET, SINTER, SUNION and KEYS are split
+     * over the nodes and their replies merged. The other commands fail with a
+     * CROSSSLOT error when their keys are on several nodes.
+     *
+     * @tparam Ret Return type of the command
+     * @param func Callback receiving the reply
+     * @param name Command name
+     * @param args Command arguments
+     * @return Reference to the sharded client for chaining
+     */
+    template <typename Ret, typename Func, typename... Args>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<Ret> &&>, sharded_client &>
+    command(Func &&func, const std::string &name, Args &&...args) {
+        using values = std::vector<std::optional<std::string>>;
+        using pairs  = std::vector<std::pair<std::string, std::string>>;
+
+        if (_nodes.empty())
+            throw std::logic_error("sharded_client: no node");
+        if constexpr (std::is_same_v<Ret, long long> && sizeof...(Args) > 0 &&
+                      (detail::is_shard_key_list_v<std::decay_t<Args>> && ...)) {
+            if (name == "DEL" || name == "EXISTS" || name == "TOUCH" ||
+                name == "UNLINK") {
+                std::vector<std::string> keys;
+                (collect(keys, args), ...);
+                split_count(std::forward<Func>(func), name, keys);
+                return *this;
+            }
+        }
+        if constexpr (std::is_same_v<Ret, std::vector<std::string>> &&
+                      sizeof...(Args) > 0 &&
+                      (detail::is_shard_key_list_v<std::decay_t<Args>> && ...)) {
+            if (name == "SINTER" || name == "SUNION") {
+                std::vector<std::string> keys;
+                (collect(keys, args), ...);
+                split_sets(std::forward<Func>(func), name, keys);
+                return *this;
+            }
+        }
+        if constexpr (sizeof...(Args) == 1) {
+            using arg_type = std::decay_t<std::tuple_element_t<0, std::tuple<Args...>>>;
+            if constexpr (std::is_same_v<Ret, values> &&
+                          std::is_same_v<arg_type, std::vector<std::string>>) {
+                if (name == "MGET") {
+                    split_mget(std::forward<Func>(func), args...);
+                    return *this;
+                }
+            } else if constexpr (std::is_same_v<Ret, status> &&
+                                 std::is_same_v<arg_type, pairs>) {
+                if (name == "MSET") {
+                    split_mset(std::forward<Func>(func), args...);
+                    return *this;
+                }
+            } else if constexpr (std::is_same_v<Ret, std::vector<std::string>> &&
+                                 detail::is_shard_key_v<arg_type>) {
+                if (name == "KEYS") {
+                    broadcast_keys(std::forward<Func>(func), std::string(args...));
+                    return *this;
+                }
+            }
+        }
+        const auto owner = route(name, args...);
+        if (!owner) {
+            std::forward<Func>(func)(Reply<Ret>{
+                false, {}, {}, "CROSSSLOT Keys in request don't hash to the same node"});
+            return *this;
+        }
+        _nodes[*owner].client->template command<Ret>(std::forward<Func>(func), name,
+                                                     std::forward<Args>(args)...);
+        return *this;
+    }
+
+    /**
+     * @brief Sends a command to the node owning its key and waits for the reply
+     *
+     * @tparam Ret Return type of the command
+     * @param name Command name
+     * @param args Command arguments
+     * @return Reply containing the command result
+     * @throws std::runtime_error if the command failed
+     */
+    template <typename Ret, typename... Args>
+    Reply<Ret>
+    command(const std::string &name, Args &&...args) {
+        Reply<Ret> value{};
+
+        command<Ret>([&value](auto &&reply) { value = std::move(reply); }, name,
+                     std::forward<Args>(args)...);
+        await();
+
+        if (!value.ok())
+            throw std::runtime_error(std::string(value.error()));
+
+        return value;
+    }
+
+    /**
+     * @brief Waits for the replies of every node
+     * @return Reference to the sharded client for chaining
+     */
+    sharded_client &
+    await() {
+        for (auto &n : _nodes)
+            n.client->await();
+        return *this;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_SHARDED_CLIENT_H
@@ -0,0 +1,298 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_SINGLE_FLIGHT_H
+#define QBM_REDIS_SINGLE_FLIGHT_H
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+#include "redis.h"
+
+namespace qb::redis {
+
+/**
+ * @class single_flight
+ * @brief Shares one round trip between identical in-flight reads
+ *
+ * A command sent while an identical one is still waiting for its reply does
+ * not reach the server: its callback joins the pending one. Commands are
+ * identical when their name, encoded arguments and result type match. The
+ * reply is parsed once, waiters receive a copy of the result and the last
+ * one receives the raw reply.
+ *
+ * Only use it for reads. Two writes must reach the server even when equal.
+ * The error() of a shared reply is valid until the callback returns. The
+ * layer must be used on the event loop thread of its client, and outlive its
+ * pending commands.
+ *
+ * @tparam QB_IO_ The QB I/O type of the client
+ */
+template <typename QB_IO_>
+class single_flight {
+public:
+    using client_type = detail::Redis<QB_IO_>;
+
+private:
+    struct flight_key {
+        std::type_index type;
+        std::string     name;
+        std::string     args;
+
+        bool
+        operator==(const flight_key &other) const {
+            return type == other.type && name == other.name && args == other.args;
+        }
+    };
+
+    struct flight_key_hash {
+        std::size_t
+        operator()(const flight_key &key) const {
+            std::size_t seed = key.type.hash_code();
+            for (auto hash : {std::hash<std::string>{}(key.name),
+                              std::hash<std::string>{}(key.args)})
+                seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
+
+    struct flight_base {
+        virtual ~flight_base() = default;
+    };
+
+    template <typename Ret>
+    struct waiter {
+        virtual ~waiter() = default;
+        virtual void
+        operator()(Reply<Ret> &&reply) = 0;
+    };
+
+    template <typename Ret, typename Func>
+    struct twaiter final : waiter<Ret> {
+        Func func;
+
+        explicit twaiter(Func &&f)
+            : func(std::forward<Func>(f)) {}
+
+        void
+        operator()(Reply<Ret> &&reply) final {
+            func(std::move(reply));
+        }
+    };
+
+    template <typename Ret>
+    struct flight final : flight_base {
+        std::vector<std::unique_ptr<waiter<Ret>>> waiters;
+    };
+
+    using flight_map =
+        qb::unordered_map<flight_key, std::unique_ptr<flight_base>, flight_key_hash>;
+
+    client_type  &_redis;
+    flight_map    _flights;
+    std::uint64_t _sent   = 0;
+    std::uint64_t _shared = 0;
+
+    /**
+     * @brief Delivers a reply to all the waiters of a flight
+     */
+    template <typename Ret>
+    void
+    land(const flight_key &key, Reply<Ret> &&reply) {
+        auto it = _flights.find(key);
+        if (it == _flights.end())
+            return;
+        auto waiters = std::move(static_cast<flight<Ret> &>(*it->second).waiters);
+        _flights.erase(it);
+
+        const auto last = waiters.size() - 1;
+        for (std::size_t i = 0; i < last; ++i)
+            (*waiters[i])(Reply<Ret>{reply.ok(), reply.result(), {}, reply.error()});
+        (*waiters[last])(std::move(reply));
+    }
+
+public:
+    /**
+     * @brief Constructs a single-flight layer
+     * @param redis Client sending the commands
+     */
+    explicit single_flight(client_type &redis)
+        : _redis(redis) {}
+
+    single_flight(const single_flight &) = delete;
+    single_flight &operator=(const single_flight &) = delete;
+
+    /**
+     * @brief Sends a read command, or joins an identical one in flight
+     *
+     * @tparam Ret Return type of the command
+     * @param func Callback receiving the reply
+     * @param name Command name
+     * @param args Command arguments
+     * @return Reference to the layer for chaining
+     */
+    template <typename Ret, typename Func, typename... Args>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<Ret> &&>, single_flight &>
+    command(Func &&func, const std::string &name, Args &&...args) {
+        auto       encoded = encode_args(args...);
+        flight_key key{typeid(Ret), name, std::move(encoded.bytes)};
+        auto       joined = std::make_unique<twaiter<Ret, std::decay_t<Func>>>(
+            std::decay_t<Func>(std::forward<Func>(func)));
+
+        auto it = _flights.find(key);
+        if (it != _flights.end()) {
+            static_cast<flight<Ret> &>(*it->second).waiters.push_back(std::move(joined));
+            ++_shared;
+            return *this;
+        }
+
+        auto pending = std::make_unique<flight<Ret>>();
+        pending->waiters.push_back(std::move(joined));
+        _flights.emplace(key, std::move(pending));
+        ++_sent;
+        encoded.bytes = key.args;
+        _redis.template command<Ret>(
+            [this, key = std::move(key)](auto &&reply) {
+                land<Ret>(key, std::forward<decltype(reply)>(reply));
+            },
+            name, encoded);
+        return *this;
+    }
+
+    /**
+     * @brief Sends a read command, or joins an identical one in flight, and waits
+     *
+     * @tparam Ret Return type of the command
+     * @param name Command name
+     * @param args Command arguments
+     * @return The command result
+     * @throws std::runtime_error if the command failed
+     */
+    template <typename Ret, typename... Args>
+    Ret
+    command(const std::string &name, Args &&...args) {
+        return sync_result<Ret>([&](auto &&func) {
+            command<Ret>(func, name, std::forward<Args>(args)...);
+        });
+    }
+
+    /**
+     * @brief Gets the value of a key
+     * @param key Key to get
+     * @return The value, nullopt if the key does not exist
+     */
+    std::optional<std::string>
+    get(const std::string &key) {
+        return command<std::optional<std::string>>("GET", key);
+    }
+
+    /**
+     * @brief Gets the value of a key asynchronously
+     * @param func Callback receiving the value
+     * @param key Key to get
+     * @return Reference to the layer for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<std::string>> &&>,
+                     single_flight &>
+    get(Func &&func, const std::string &key) {
+        return command<std::optional<std::string>>(std::forward<Func>(func), "GET", key);
+    }
+
+    /**
+     * @brief Gets the value of a hash field
+     * @param key Key of the hash
+     * @param field Field to get
+     * @return The value, nullopt if the field does not exist
+     */
+    std::optional<std::string>
+    hget(const std::string &key, const std::string &field) {
+        return command<std::optional<std::string>>("HGET", key, field);
+    }
+
+    /**
+     * @brief Gets the value of a hash field asynchronously
+     * @param func Callback receiving the value
+     * @param key Key of the hash
+     * @param field Field to get
+     * @return Reference to the layer for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<std::string>> &&>,
+                     single_flight &>
+    hget(Func &&func, const std::string &key, const std::string &field) {
+        return command<std::optional<std::string>>(std::forward<Func>(func), "HGET", key,
+                                                   field);
+    }
+
+    /**
+     * @brief Gets all the fields and values of a hash
+     * @param key Key of the hash
+     * @return Map of the fields and their values
+     */
+    qb::unordered_map<std::string, std::string>
+    hgetall(const std::string &key) {
+        return command<qb::unordered_map<std::string, std::string>>("HGETALL", key);
+    }
+
+    /**
+     * @brief Gets all the fields and values of a hash asynchronously
+     * @param func Callback receiving the map of the fields and their values
+     * @param key Key of the hash
+     * @return Reference to the layer for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<
+                         Func, Reply<qb::unordered_map<std::string, std::string>> &&>,
+                     single_flight &>
+    hgetall(Func &&func, const std::string &key) {
+        return command<qb::unordered_map<std::string, std::string>>(
+            std::forward<Func>(func), "HGETALL", key);
+    }
+
+    /**
+     * @brief Gets the number of distinct commands waiting for their reply
+     */
+    [[nodiscard]] std::size_t
+    in_flight() const {
+        return _flights.size();
+    }
+
+    /**
+     * @brief Gets the number of commands sent to the server
+     */
+    [[nodiscard]] std::uint64_t
+    sent() const {
+        return _sent;
+    }
+
+    /**
+     * @brief Gets the number of commands that joined one in flight
+     */
+    [[nodiscard]] std::uint64_t
+    shared() const {
+        return _shared;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_SINGLE_FLIGHT_H
@@ -18,6 +18,8 @@
 #ifndef QBM_REDIS_SORTED_SET_COMMANDS_H
 #define QBM_REDIS_SORTED_SET_COMMANDS_H
 #include <chrono>
+#include <iterator>
+#include <stdexcept>
 #include <utility>
 #include "reply.h"
 
@@ -44,6 +46,13 @@ private:
         return static_cast<Derived &>(*this);
     }
 
+    static std::optional<std::string>
+    rev_option(bool rev) {
+        if (rev)
+            return "REV";
+        return std::nullopt;
+    }
+
     /**
      * @class scanner
      * @brief Helper class for implementing incremental scanning of sorted sets
@@ -239,6 +248,49 @@ public:
         return bzpopmin(std::forward<Func>(func), keys, timeout.count());
     }
 
+    /**
+     * @brief Pops members from the first non-empty sorted set, blocking if they are
+     * all empty
+     *
+     * @param keys Keys where sorted sets are stored
+     * @param position End to pop from (MIN or MAX)
+     * @param timeout Timeout in seconds, 0 means block forever
+     * @param count Maximum number of members to pop
+     * @return Key and popped members, or nullopt on timeout
+     * @see https://redis.io/commands/bzmpop
+     */
+    std::optional<sorted_set_pop_result>
+    bzmpop(const std::vector<std::string> &keys, SortedSetPosition position,
+           double timeout = 0, long long count = 1) {
+        return derived()
+            .template command<std::optional<sorted_set_pop_result>>(
+                "BZMPOP", timeout, keys.size(), keys, std::to_string(position), "COUNT",
+                count)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of bzmpop
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param keys Keys where sorted sets are stored
+     * @param position End to pop from (MIN or MAX)
+     * @param timeout Timeout in seconds, 0 means block forever
+     * @param count Maximum number of members to pop
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<
+        std::is_invocable_v<Func, Reply<std::optional<sorted_set_pop_result>> &&>,
+        Derived &>
+    bzmpop(Func &&func, const std::vector<std::string> &keys, SortedSetPosition position,
+           double timeout = 0, long long count = 1) {
+        return derived().template command<std::optional<sorted_set_pop_result>>(
+            std::forward<Func>(func), "BZMPOP", timeout, keys.size(), keys,
+            std::to_string(position), "COUNT", count);
+    }
+
     /**
      * @brief Adds one or more members to a sorted set, or updates the score if member
      * already exists
@@ -291,6 +343,79 @@ public:
                                                      key, opt_up, opt_ch, members);
     }
 
+    /**
+     * @brief Adds members from parallel arrays of scores and member names
+     *
+     * The arrays can be any contiguous containers (std::vector, std::array, C
+     * arrays, ...). Entries are encoded straight from the caller buffers, with
+     * the shortest round-trip representation of each score.
+     *
+     * @param key Key where the sorted set is stored
+     * @param scores Scores of the members
+     * @param members Member names
+     * @param type Update type (ALWAYS, EXIST, or NOT_EXIST)
+     * @param changed If true, return number of changed elements, not just new elements
+     * @return Number of elements added to the sorted set
+     * @throws std::invalid_argument if the array sizes differ
+     */
+    template <typename Scores, typename Members>
+    std::enable_if_t<
+        std::is_convertible_v<decltype(std::data(std::declval<const Scores &>())),
+                              const double *>,
+        long long>
+    zadd(const std::string &key, const Scores &scores, const Members &members,
+         UpdateType type = UpdateType::ALWAYS, bool changed = false) {
+        Reply<long long> value{};
+        zadd([&value](auto &&reply) { value = std::move(reply); }, key, scores, members,
+             type, changed);
+        derived().await();
+
+        if (!value.ok())
+            throw std::runtime_error(std::string(value.error()));
+        return value.result();
+    }
+
+    /**
+     * @brief Asynchronous version of zadd from parallel arrays
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the sorted set is stored
+     * @param scores Scores of the members
+     * @param members Member names
+     * @param type Update type (ALWAYS, EXIST, or NOT_EXIST)
+     * @param changed If true, return number of changed elements, not just new elements
+     * @return Reference to the Redis handler for chaining
+     * @throws std::invalid_argument if the array sizes differ
+     */
+    template <typename Func, typename Scores, typename Members>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&> &&
+                         std::is_convertible_v<
+                             decltype(std::data(std::declval<const Scores &>())),
+                             const double *>,
+                     Derived &>
+    zadd(Func &&func, const std::string &key, const Scores &scores,
+         const Members &members, UpdateType type = UpdateType::ALWAYS,
+         bool changed = false) {
+        using member_type =
+            std::remove_cv_t<std::remove_pointer_t<decltype(std::data(members))>>;
+
+        if (std::size(scores) != std::size(members))
+            throw std::invalid_argument("zadd: array sizes differ");
+
+        std::optional<std::string> opt_up, opt_ch;
+
+        if (type != UpdateType::ALWAYS)
+            opt_up = std::to_string(type);
+
+        if (changed)
+            opt_ch = "CH";
+        return derived().template command<long long>(
+            std::forward<Func>(func), "ZADD", key, opt_up, opt_ch,
+            score_members<member_type>{std::data(scores), std::data(members),
+                                       std::size(members)});
+    }
+
     /**
      * @brief Gets the number of members in a sorted set
      *
@@ -547,6 +672,40 @@ public:
             std::forward<Func>(func), "ZPOPMAX", key, count);
     }
 
+    /**
+     * @brief Removes and returns members with the highest scores, as a structure of
+     * arrays
+     *
+     * Same as zpopmax, but scores are returned in a contiguous array and member
+     * names as views on a single buffer.
+     *
+     * @param key Key where the sorted set is stored
+     * @param count Number of members to pop (default is 1)
+     * @return Members and scores that were removed
+     */
+    score_member_list
+    zpopmax_list(const std::string &key, long long count = 1) {
+        return derived()
+            .template command<score_member_list>("ZPOPMAX", key, count)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zpopmax_list
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the sorted set is stored
+     * @param count Number of members to pop (default is 1)
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<score_member_list> &&>, Derived &>
+    zpopmax_list(Func &&func, const std::string &key, long long count = 1) {
+        return derived().template command<score_member_list>(
+            std::forward<Func>(func), "ZPOPMAX", key, count);
+    }
+
     /**
      * @brief Removes and returns members with the lowest scores from a sorted set
      *
@@ -578,6 +737,79 @@ public:
             std::forward<Func>(func), "ZPOPMIN", key, count);
     }
 
+    /**
+     * @brief Removes and returns members with the lowest scores, as a structure of
+     * arrays
+     *
+     * Same as zpopmin, but scores are returned in a contiguous array and member
+     * names as views on a single buffer.
+     *
+     * @param key Key where the sorted set is stored
+     * @param count Number of members to pop (default is 1)
+     * @return Members and scores that were removed
+     */
+    score_member_list
+    zpopmin_list(const std::string &key, long long count = 1) {
+        return derived()
+            .template command<score_member_list>("ZPOPMIN", key, count)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zpopmin_list
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the sorted set is stored
+     * @param count Number of members to pop (default is 1)
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<score_member_list> &&>, Derived &>
+    zpopmin_list(Func &&func, const std::string &key, long long count = 1) {
+        return derived().template command<score_member_list>(
+            std::forward<Func>(func), "ZPOPMIN", key, count);
+    }
+
+    /**
+     * @brief Pops members from the first non-empty sorted set
+     *
+     * @param keys Keys where sorted sets are stored
+     * @param position End to pop from (MIN or MAX)
+     * @param count Maximum number of members to pop
+     * @return Key and popped members, or nullopt if all the sorted sets are empty
+     * @see https://redis.io/commands/zmpop
+     */
+    std::optional<sorted_set_pop_result>
+    zmpop(const std::vector<std::string> &keys, SortedSetPosition position,
+          long long count = 1) {
+        return derived()
+            .template command<std::optional<sorted_set_pop_result>>(
+                "ZMPOP", keys.size(), keys, std::to_string(position), "COUNT", count)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zmpop
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param keys Keys where sorted sets are stored
+     * @param position End to pop from (MIN or MAX)
+     * @param count Maximum number of members to pop
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<
+        std::is_invocable_v<Func, Reply<std::optional<sorted_set_pop_result>> &&>,
+        Derived &>
+    zmpop(Func &&func, const std::vector<std::string> &keys, SortedSetPosition position,
+          long long count = 1) {
+        return derived().template command<std::optional<sorted_set_pop_result>>(
+            std::forward<Func>(func), "ZMPOP", keys.size(), keys,
+            std::to_string(position), "COUNT", count);
+    }
+
     /**
      * @brief Gets members in a sorted set with their scores within a specified range of
      * indices
@@ -613,6 +845,135 @@ public:
             std::forward<Func>(func), "ZRANGE", key, start, stop, "WITHSCORES");
     }
 
+    /**
+     * @brief Gets members with their scores within a range of indices, as a structure
+     * of arrays
+     *
+     * Same as zrange, but scores are returned in a contiguous array and member
+     * names as views on a single buffer.
+     *
+     * @param key Key where the sorted set is stored
+     * @param start Start index (0-based, can be negative to count from the end)
+     * @param stop Stop index (inclusive, can be negative to count from the end)
+     * @return Members and scores within the range
+     */
+    score_member_list
+    zrange_list(const std::string &key, long long start, long long stop) {
+        return derived()
+            .template command<score_member_list>("ZRANGE", key, start, stop,
+                                                 "WITHSCORES")
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zrange_list
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the sorted set is stored
+     * @param start Start index (0-based, can be negative to count from the end)
+     * @param stop Stop index (inclusive, can be negative to count from the end)
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<score_member_list> &&>, Derived &>
+    zrange_list(Func &&func, const std::string &key, long long start, long long stop) {
+        return derived().template command<score_member_list>(
+            std::forward<Func>(func), "ZRANGE", key, start, stop, "WITHSCORES");
+    }
+
+    /**
+     * @brief Stores a range of members, by index, in another sorted set
+     *
+     * @param destination Key where the result is stored
+     * @param source Key where the source sorted set is stored
+     * @param start Start index (0-based, can be negative to count from the end)
+     * @param stop Stop index (inclusive, can be negative to count from the end)
+     * @param rev If true, indices are counted from the highest score
+     * @return Number of members in the resulting sorted set
+     * @see https://redis.io/commands/zrangestore
+     */
+    long long
+    zrangestore(const std::string &destination, const std::string &source,
+                long long start, long long stop, bool rev = false) {
+        return derived()
+            .template command<long long>("ZRANGESTORE", destination, source, start, stop,
+                                         rev_option(rev))
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zrangestore
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param destination Key where the result is stored
+     * @param source Key where the source sorted set is stored
+     * @param start Start index (0-based, can be negative to count from the end)
+     * @param stop Stop index (inclusive, can be negative to count from the end)
+     * @param rev If true, indices are counted from the highest score
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, Derived &>
+    zrangestore(Func &&func, const std::string &destination, const std::string &source,
+                long long start, long long stop, bool rev = false) {
+        return derived().template command<long long>(std::forward<Func>(func),
+                                                     "ZRANGESTORE", destination, source,
+                                                     start, stop, rev_option(rev));
+    }
+
+    /**
+     * @brief Stores the members within a score range in another sorted set
+     *
+     * @tparam Interval Type of the score interval
+     * @param destination Key where the result is stored
+     * @param source Key where the source sorted set is stored
+     * @param interval Interval object with lower() and upper() methods
+     * @param opts Limit options for pagination
+     * @param rev If true, members are taken from the highest score
+     * @return Number of members in the resulting sorted set
+     * @see https://redis.io/commands/zrangestore
+     */
+    template <typename Interval>
+    long long
+    zrangestorebyscore(const std::string &destination, const std::string &source,
+                       Interval const &interval, const LimitOptions &opts = {},
+                       bool rev = false) {
+        return derived()
+            .template command<long long>("ZRANGESTORE", destination, source,
+                                         rev ? interval.upper() : interval.lower(),
+                                         rev ? interval.lower() : interval.upper(),
+                                         "BYSCORE", rev_option(rev), "LIMIT",
+                                         opts.offset, opts.count)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zrangestorebyscore
+     *
+     * @tparam Func Callback function type
+     * @tparam Interval Type of the score interval
+     * @param func Callback function
+     * @param destination Key where the result is stored
+     * @param source Key where the source sorted set is stored
+     * @param interval Interval object with lower() and upper() methods
+     * @param opts Limit options for pagination
+     * @param rev If true, members are taken from the highest score
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func, typename Interval>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, Derived &>
+    zrangestorebyscore(Func &&func, const std::string &destination,
+                       const std::string &source, Interval const &interval,
+                       const LimitOptions &opts = {}, bool rev = false) {
+        return derived().template command<long long>(
+            std::forward<Func>(func), "ZRANGESTORE", destination, source,
+            rev ? interval.upper() : interval.lower(),
+            rev ? interval.lower() : interval.upper(), "BYSCORE", rev_option(rev),
+            "LIMIT", opts.offset, opts.count);
+    }
+
     /**
      * @brief Gets members in a sorted set that have scores within a lexicographical
      * range
@@ -701,6 +1062,50 @@ public:
             opts.offset >= 0 ? std::to_string(opts.count) : "", "WITHSCORES");
     }
 
+    /**
+     * @brief Gets members with their scores within a score range, as a structure of
+     * arrays
+     *
+     * Same as zrangebyscore, but scores are returned in a contiguous array and member
+     * names as views on a single buffer.
+     *
+     * @tparam Interval Type of the score interval
+     * @param key Key where the sorted set is stored
+     * @param interval Interval object with lower() and upper() methods
+     * @param opts Limit options for pagination
+     * @return Members and scores within the score range
+     */
+    template <typename Interval>
+    score_member_list
+    zrangebyscore_list(const std::string &key, Interval const &interval,
+                       const LimitOptions &opts = {}) {
+        return derived()
+            .template command<score_member_list>("ZRANGEBYSCORE", key, interval.lower(),
+                                                 interval.upper(), "WITHSCORES", "LIMIT",
+                                                 opts.offset, opts.count)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zrangebyscore_list
+     *
+     * @tparam Func Callback function type
+     * @tparam Interval Type of the score interval
+     * @param func Callback function
+     * @param key Key where the sorted set is stored
+     * @param interval Interval object with lower() and upper() methods
+     * @param opts Limit options for pagination
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func, typename Interval>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<score_member_list> &&>, Derived &>
+    zrangebyscore_list(Func &&func, const std::string &key, Interval const &interval,
+                       const LimitOptions &opts = {}) {
+        return derived().template command<score_member_list>(
+            std::forward<Func>(func), "ZRANGEBYSCORE", key, interval.lower(),
+            interval.upper(), "WITHSCORES", "LIMIT", opts.offset, opts.count);
+    }
+
     /**
      * @brief Gets the rank of a member in a sorted set, with scores ordered from low to
      * high
@@ -899,6 +1304,43 @@ public:
             std::forward<Func>(func), "ZREVRANGE", key, start, stop, "WITHSCORES");
     }
 
+    /**
+     * @brief Gets members with their scores within a range of indices, ordered from
+     * high to low, as a structure of arrays
+     *
+     * Same as zrevrange, but scores are returned in a contiguous array and member
+     * names as views on a single buffer.
+     *
+     * @param key Key where the sorted set is stored
+     * @param start Start index (0-based, can be negative to count from the end)
+     * @param stop Stop index (inclusive, can be negative to count from the end)
+     * @return Members and scores within the range
+     */
+    score_member_list
+    zrevrange_list(const std::string &key, long long start, long long stop) {
+        return derived()
+            .template command<score_member_list>("ZREVRANGE", key, start, stop,
+                                                 "WITHSCORES")
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zrevrange_list
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @param key Key where the sorted set is stored
+     * @param start Start index (0-based, can be negative to count from the end)
+     * @param stop Stop index (inclusive, can be negative to count from the end)
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<score_member_list> &&>, Derived &>
+    zrevrange_list(Func &&func, const std::string &key, long long start, long long stop) {
+        return derived().template command<score_member_list>(
+            std::forward<Func>(func), "ZREVRANGE", key, start, stop, "WITHSCORES");
+    }
+
     /**
      * @brief Gets members in a sorted set that have scores within a lexicographical
      * range, ordered from high to low
@@ -983,6 +1425,51 @@ public:
             interval.lower(), "WITHSCORES", "LIMIT", opt.offset, opt.count);
     }
 
+    /**
+     * @brief Gets members with their scores within a score range, ordered from high to
+     * low, as a structure of arrays
+     *
+     * Same as zrevrangebyscore, but scores are returned in a contiguous array and member
+     * names as views on a single buffer.
+     *
+     * @tparam Interval Type of the score interval
+     * @param key Key where the sorted set is stored
+     * @param interval Interval object with lower() and upper() methods
+     * @param opts Limit options for pagination
+     * @return Members and scores within the score range
+     */
+    template <typename Interval>
+    score_member_list
+    zrevrangebyscore_list(const std::string &key, Interval const &interval,
+                          const LimitOptions &opts = {}) {
+        return derived()
+            .template command<score_member_list>("ZREVRANGEBYSCORE", key,
+                                                 interval.upper(), interval.lower(),
+                                                 "WITHSCORES", "LIMIT", opts.offset,
+                                                 opts.count)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zrevrangebyscore_list
+     *
+     * @tparam Func Callback function type
+     * @tparam Interval Type of the score interval
+     * @param func Callback function
+     * @param key Key where the sorted set is stored
+     * @param interval Interval object with lower() and upper() methods
+     * @param opts Limit options for pagination
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func, typename Interval>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<score_member_list> &&>, Derived &>
+    zrevrangebyscore_list(Func &&func, const std::string &key, Interval const &interval,
+                          const LimitOptions &opts = {}) {
+        return derived().template command<score_member_list>(
+            std::forward<Func>(func), "ZREVRANGEBYSCORE", key, interval.upper(),
+            interval.lower(), "WITHSCORES", "LIMIT", opts.offset, opts.count);
+    }
+
     /**
      * @brief Gets the rank of a member in a sorted set, with scores ordered from high to
      * low
@@ -1115,6 +1602,43 @@ public:
         return derived().template command<std::optional<double>>(
             std::forward<Func>(func), "ZSCORE", key, member);
     }
+
+    /**
+     * @brief Gets the scores of several members in one round trip
+     *
+     * @tparam Members Variadic types for members (strings or containers of strings)
+     * @param key Key where the sorted set is stored
+     * @param members Members whose scores are requested
+     * @return Scores in the order of the members, nullopt for missing members
+     * @see https://redis.io/commands/zmscore
+     */
+    template <typename... Members>
+    std::vector<std::optional<double>>
+    zmscore(const std::string &key, Members &&...members) {
+        return derived()
+            .template command<std::vector<std::optional<double>>>(
+                "ZMSCORE", key, std::forward<Members>(members)...)
+            .result();
+    }
+
+    /**
+     * @brief Asynchronous version of zmscore
+     *
+     * @tparam Func Callback function type
+     * @tparam Members Variadic types for members (strings or containers of strings)
+     * @param func Callback function
+     * @param key Key where the sorted set is stored
+     * @param members Members whose scores are requested
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func, typename... Members>
+    std::enable_if_t<
+        std::is_invocable_v<Func, Reply<std::vector<std::optional<double>>> &&>,
+        Derived &>
+    zmscore(Func &&func, const std::string &key, Members &&...members) {
+        return derived().template command<std::vector<std::optional<double>>>(
+            std::forward<Func>(func), "ZMSCORE", key, std::forward<Members>(members)...);
+    }
 };
 
 } // namespace qb::redis
@@ -199,6 +199,97 @@ TEST_F(RedisTest, SYNC_BITMAP_COMMANDS_GETBIT_SETBIT) {
     EXPECT_FALSE(redis.getbit(key, 8)); // Bit out of bounds
 }
 
+// Test local bitmap analytics against the server
+TEST_F(RedisTest, SYNC_BITMAP_COMMANDS_LOCAL_BITMAP) {
+    std::string key1 = test_key("local1");
+    std::string key2 = test_key("local2");
+    std::string dest = test_key("local_dest");
+
+    for (long long i = 0; i < 100000; i += 3)
+        redis.setbit(key1, i, true);
+    for (long long i = 0; i < 50000; i += 5)
+        redis.setbit(key2, i, true);
+
+    auto a = redis.bitmap_get(key1);
+    auto b = redis.bitmap_get(key2, 1024);
+    EXPECT_TRUE(a == redis.bitmap_get(key1, 1000));
+    EXPECT_EQ(a.size(), static_cast<std::size_t>(redis.strlen(key1)));
+
+    EXPECT_EQ(a.count(), static_cast<std::uint64_t>(redis.bitcount(key1)));
+    EXPECT_EQ(a.count(10, -10), static_cast<std::uint64_t>(redis.bitcount(key1, 10, -10)));
+    EXPECT_EQ(a.pos(false), redis.bitpos(key1, false));
+    EXPECT_EQ(b.pos(true, 3, -1), redis.bitpos(key2, true, 3, -1));
+
+    for (auto op : {qb::redis::BitOp::AND, qb::redis::BitOp::OR, qb::redis::BitOp::XOR}) {
+        auto local = qb::redis::bitmap::bitop(op, {&a, &b});
+        redis.bitop(std::to_string(op), dest, {key1, key2});
+        EXPECT_TRUE(local == redis.bitmap_get(dest));
+    }
+
+    auto inverted = qb::redis::bitmap::bitop(qb::redis::BitOp::NOT, {&a});
+    EXPECT_EQ(inverted.count(), a.size() * 8 - a.count());
+
+    // Results can be written back
+    EXPECT_TRUE(redis.bitmap_set(dest, inverted));
+    EXPECT_EQ(redis.bitcount(dest), static_cast<long long>(inverted.count()));
+
+    // Missing keys are empty bitmaps
+    EXPECT_TRUE(redis.bitmap_get(test_key("missing"), 64).empty());
+    EXPECT_TRUE(redis.bitmap_get(test_key("missing")).empty());
+}
+
+// Test typed BITFIELD operations
+TEST_F(RedisTest, SYNC_BITMAP_COMMANDS_BITFIELD_TYPED) {
+    using namespace qb::redis;
+    std::string key = test_key("bitfield_typed");
+
+    // Packed array of u8 counters, updated in one command
+    bitfield_ops ops;
+    ops.overflow(BitfieldOverflow::SAT);
+    for (long long i = 0; i < 100; ++i)
+        ops.incrby(bitfield::u8, bitfield_offset::index(i), i * 3);
+    EXPECT_EQ(ops.size(), 100);
+    EXPECT_FALSE(ops.read_only());
+
+    auto results = redis.bitfield(key, ops);
+    EXPECT_EQ(results.size(), 100);
+    EXPECT_EQ(*results[10], 30);
+    EXPECT_EQ(*results[99], 255); // Saturated
+    EXPECT_EQ(redis.strlen(key), 100);
+
+    // Read only operations, sent as BITFIELD_RO
+    bitfield_ops reads;
+    reads.get(bitfield::u8, bitfield_offset::index(10)).get(bitfield::u16, 0);
+    EXPECT_TRUE(reads.read_only());
+    results = redis.bitfield(key, reads);
+    EXPECT_EQ(results.size(), 2);
+    EXPECT_EQ(*results[0], 30);
+    EXPECT_EQ(*results[1], 3); // Bytes 0 and 1 are 0 and 3
+
+    // OVERFLOW is not accepted by BITFIELD_RO, even with GET only
+    bitfield_ops overflow_reads;
+    overflow_reads.overflow(BitfieldOverflow::WRAP).get(bitfield::u8, 0);
+    EXPECT_FALSE(overflow_reads.read_only());
+    results = redis.bitfield(key, overflow_reads);
+    EXPECT_EQ(results.size(), 1);
+    EXPECT_EQ(*results[0], 0);
+
+    // Signed fields, SET returns the old value, FAIL returns nil
+    bitfield_ops ops2;
+    ops2.set(bitfield::i16, 800, -5)
+        .overflow(BitfieldOverflow::FAIL)
+        .incrby(bitfield_type::i(4), 0, 100)
+        .get(bitfield::i16, 800);
+    results = redis.bitfield(key, ops2);
+    EXPECT_EQ(results.size(), 3);
+    EXPECT_EQ(*results[0], 0);
+    EXPECT_FALSE(results[1].has_value());
+    EXPECT_EQ(*results[2], -5);
+
+    EXPECT_THROW(bitfield_type::u(64), std::invalid_argument);
+    EXPECT_TRUE(redis.bitfield(key, bitfield_ops{}).empty());
+}
+
 /*
  * TESTS ASYNCHRONES
  */
@@ -288,4 +379,42 @@ TEST_F(RedisTest, ASYNC_BITMAP_COMMANDS_GETBIT_SETBIT) {
 
     EXPECT_TRUE(setbit_result);
     EXPECT_TRUE(getbit_result);
-}
\ No newline at end of file
+}
+
+// Test asynchrone du chargement et de l'écriture d'un bitmap local
+TEST_F(RedisTest, ASYNC_BITMAP_COMMANDS_LOCAL_BITMAP) {
+    std::string       key  = test_key("async_local");
+    std::string       copy = test_key("async_local_copy");
+    qb::redis::bitmap fetched;
+    bool              stored = false;
+
+    for (long long i = 0; i < 4096; i += 7)
+        redis.setbit(key, i, true);
+
+    redis.bitmap_get([&](auto &&reply) { fetched = std::move(reply.result()); }, key,
+                     100);
+    redis.await();
+    EXPECT_EQ(fetched.count(), static_cast<std::uint64_t>(redis.bitcount(key)));
+
+    redis.bitmap_set([&](auto &&reply) { stored = reply.ok(); }, copy, fetched);
+    redis.await();
+    EXPECT_TRUE(stored);
+    EXPECT_TRUE(fetched == redis.bitmap_get(copy));
+}
+
+// Test asynchrone BITFIELD typé
+TEST_F(RedisTest, ASYNC_BITMAP_COMMANDS_BITFIELD_TYPED) {
+    using namespace qb::redis;
+    std::string                           key = test_key("async_bitfield_typed");
+    std::vector<std::optional<long long>> results;
+
+    bitfield_ops ops;
+    ops.incrby(bitfield::u32, bitfield_offset::index(2), 42)
+        .get(bitfield::u32, bitfield_offset::index(2));
+    redis.bitfield([&](auto &&reply) { results = reply.result(); }, key, ops);
+
+    redis.await();
+    EXPECT_EQ(results.size(), 2);
+    EXPECT_EQ(*results[0], 42);
+    EXPECT_EQ(*results[1], 42);
+}
@@ -0,0 +1,182 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include <thread>
+#include "../counter_aggregator.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using aggregator_type = qb::redis::counter_aggregator<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::counter-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return "{" + key_prefix() + "}::" + k;
+}
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test summing increments into one command per counter
+TEST_F(RedisTest, SYNC_COUNTER_AGGREGATOR_FLUSH) {
+    std::string     counter = test_key("counter");
+    std::string     hash    = test_key("hash");
+    std::string     zset    = test_key("zset");
+    aggregator_type aggregator{redis};
+
+    for (int i = 0; i < 1000; ++i) {
+        aggregator.incr(counter);
+        aggregator.hincrby(hash, "hits", 2);
+        aggregator.zincrby(zset, "member", 0.5);
+    }
+    aggregator.incrby(test_key("zero"), 5);
+    aggregator.incrby(test_key("zero"), -5);
+    EXPECT_EQ(aggregator.size(), 4u);
+
+    // Deltas summing to zero are not sent
+    EXPECT_EQ(aggregator.flush(), 3);
+    EXPECT_EQ(aggregator.size(), 0u);
+    EXPECT_EQ(redis.get(counter), "1000");
+    EXPECT_EQ(redis.hget(hash, "hits"), "2000");
+    EXPECT_EQ(redis.zscore(zset, "member"), 500);
+    EXPECT_FALSE(redis.exists(test_key("zero")));
+
+    const auto &stats = aggregator.stats();
+    EXPECT_EQ(stats.flushes, 1u);
+    EXPECT_EQ(stats.commands, 3u);
+    EXPECT_EQ(stats.last_batch, 3u);
+    EXPECT_EQ(stats.errors, 0u);
+
+    // Nothing pending
+    EXPECT_EQ(aggregator.flush(), 0);
+    EXPECT_EQ(aggregator.stats().flushes, 1u);
+}
+
+// Test the size and interval thresholds
+TEST_F(RedisTest, SYNC_COUNTER_AGGREGATOR_DUE) {
+    aggregator_type::options opts;
+    opts.max_entries = 3;
+    opts.interval    = milliseconds(50);
+    aggregator_type aggregator{redis, opts};
+
+    EXPECT_FALSE(aggregator.due());
+    aggregator.incr(test_key("a"));
+    EXPECT_FALSE(aggregator.poll());
+    aggregator.incr(test_key("b"));
+    aggregator.incr(test_key("c"));
+    EXPECT_TRUE(aggregator.due());
+    EXPECT_TRUE(aggregator.poll());
+    redis.await();
+    EXPECT_EQ(aggregator.stats().last_batch, 3u);
+
+    aggregator.incr(test_key("a"));
+    EXPECT_FALSE(aggregator.due());
+    std::this_thread::sleep_for(milliseconds(60));
+    EXPECT_TRUE(aggregator.due());
+}
+
+// Test increments from several threads
+TEST_F(RedisTest, SYNC_COUNTER_AGGREGATOR_THREADS) {
+    std::string     counter = test_key("counter");
+    aggregator_type aggregator{redis};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i)
+                aggregator.incr(counter);
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(aggregator.flush(), 1);
+    EXPECT_EQ(redis.get(counter), "40000");
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the asynchronous flush
+TEST_F(RedisTest, ASYNC_COUNTER_AGGREGATOR_FLUSH) {
+    std::string     hash = test_key("hash");
+    aggregator_type aggregator{redis};
+    long long       sent = -1;
+
+    aggregator.hincrby(hash, "a", 1);
+    aggregator.hincrby(hash, "b", 2);
+    aggregator.flush([&](auto &&reply) {
+        EXPECT_TRUE(reply.ok());
+        sent = reply.result();
+    });
+    redis.await();
+    EXPECT_EQ(sent, 2);
+    EXPECT_EQ(redis.hget(hash, "b"), "2");
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,208 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include <thread>
+#include "../distributed_lock.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using lock_type = qb::redis::distributed_lock<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::distributed-lock-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return "{" + key_prefix() + "}::" + k;
+}
+
+// Builds lock options without background extension
+inline lock_type::options
+manual(milliseconds ttl) {
+    lock_type::options opts;
+    opts.ttl         = ttl;
+    opts.auto_extend = false;
+    return opts;
+}
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test mutual exclusion and fencing tokens
+TEST_F(RedisTest, SYNC_DISTRIBUTED_LOCK_ACQUIRE_RELEASE) {
+    std::string name = test_key("lock");
+    lock_type   first{redis, name, manual(seconds(10))};
+    lock_type   second{redis, name, manual(seconds(10))};
+
+    auto fence = first.acquire();
+    ASSERT_TRUE(fence.has_value());
+    EXPECT_EQ(*fence, first.fencing_token());
+    EXPECT_TRUE(first.held());
+    EXPECT_EQ(redis.get(name), first.token());
+
+    EXPECT_FALSE(second.acquire().has_value());
+    EXPECT_FALSE(second.held());
+
+    // Releasing a lock that is not held does not touch the key
+    EXPECT_FALSE(second.release());
+    EXPECT_TRUE(redis.exists(name));
+
+    EXPECT_TRUE(first.release());
+    EXPECT_FALSE(first.held());
+    EXPECT_FALSE(redis.exists(name));
+
+    auto next = second.acquire();
+    ASSERT_TRUE(next.has_value());
+    EXPECT_GT(*next, *fence);
+    EXPECT_NE(second.token(), first.token());
+}
+
+// Test extending the lease and losing the lock
+TEST_F(RedisTest, SYNC_DISTRIBUTED_LOCK_EXTEND) {
+    std::string name = test_key("lock");
+    lock_type   lock{redis, name, manual(milliseconds(1000))};
+    bool        lost = false;
+    lock.on_lost([&] { lost = true; });
+
+    ASSERT_TRUE(lock.acquire());
+    std::this_thread::sleep_for(milliseconds(500));
+    EXPECT_TRUE(lock.extend());
+    EXPECT_GT(redis.pttl(name), 800);
+    EXPECT_GT(lock.validity(), milliseconds(800));
+
+    // Another owner took the key over
+    redis.set(name, "other");
+    EXPECT_FALSE(lock.extend());
+    EXPECT_TRUE(lost);
+    EXPECT_FALSE(lock.held());
+    EXPECT_EQ(redis.get(name), "other");
+}
+
+// Test the background extension
+TEST_F(RedisTest, SYNC_DISTRIBUTED_LOCK_AUTO_EXTEND) {
+    std::string        name = test_key("lock");
+    lock_type::options opts;
+    opts.ttl = milliseconds(300);
+    lock_type lock{redis, name, opts};
+
+    ASSERT_TRUE(lock.acquire());
+    const auto end = steady_clock::now() + milliseconds(900);
+    while (steady_clock::now() < end)
+        async::run(EVRUN_ONCE);
+
+    EXPECT_TRUE(lock.held());
+    EXPECT_EQ(redis.get(name), lock.token());
+    EXPECT_TRUE(lock.release());
+}
+
+// Test the quorum acquisition on independent instances
+TEST_F(RedisTest, SYNC_DISTRIBUTED_LOCK_REDLOCK) {
+    qb::redis::tcp::client db1{REDIS_URI};
+    qb::redis::tcp::client db2{REDIS_URI};
+    ASSERT_TRUE(db1.connect() && db1.select(1));
+    ASSERT_TRUE(db2.connect() && db2.select(2));
+
+    std::string name = test_key("lock");
+    lock_type   lock{{&redis, &db1, &db2}, name, manual(seconds(10))};
+
+    // One instance held by another owner, the majority is still reached
+    db1.set(name, "other");
+    ASSERT_TRUE(lock.acquire());
+    EXPECT_EQ(redis.get(name), lock.token());
+    EXPECT_EQ(db2.get(name), lock.token());
+    EXPECT_TRUE(lock.release());
+    EXPECT_EQ(db1.get(name), "other");
+
+    // Two instances held by another owner, the acquired one is released
+    db2.set(name, "other");
+    EXPECT_FALSE(lock.acquire().has_value());
+    EXPECT_FALSE(redis.exists(name));
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the asynchronous acquire and release
+TEST_F(RedisTest, ASYNC_DISTRIBUTED_LOCK_ACQUIRE_RELEASE) {
+    lock_type lock{redis, test_key("lock"), manual(seconds(10))};
+
+    std::optional<long long> fence;
+    bool                     released = false;
+    lock.acquire([&](auto &&reply) {
+        EXPECT_TRUE(reply.ok());
+        fence = reply.result();
+    });
+    redis.await();
+    ASSERT_TRUE(fence.has_value());
+
+    // Acquiring again passes the current fencing token
+    lock.acquire([&](auto &&reply) { EXPECT_EQ(reply.result(), fence); });
+    lock.release([&](auto &&reply) { released = reply.result(); });
+    redis.await();
+    EXPECT_TRUE(released);
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
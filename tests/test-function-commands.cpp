@@ -232,6 +232,53 @@ TEST_F(RedisTest, SYNC_FUNCTION_COMMANDS_HELP) {
     }
 }
 
+// Library used by the FCALL tests
+static const std::string TEST_LIBRARY = R"(#!lua name=qbm_test
+redis.register_function('qbm_incrby', function(keys, args)
+    return redis.call('INCRBY', keys[1], args[1])
+end)
+redis.register_function{
+    function_name = 'qbm_get',
+    callback = function(keys) return redis.call('GET', keys[1]) end,
+    flags = { 'no-writes' }
+})";
+
+// Test FCALL and FCALL_RO on a library loaded during the handshake
+TEST_F(RedisTest, SYNC_FUNCTION_COMMANDS_FCALL) {
+    std::string key = test_key("fcall");
+    redis.function_flush();
+
+    qb::redis::tcp::client client{REDIS_URI};
+    EXPECT_EQ(client.register_library(TEST_LIBRARY), "qbm_test");
+    ASSERT_TRUE(client.connect());
+    client.await();
+
+    EXPECT_EQ(client.fcall<long long>("qbm_incrby", {key}, {"5"}), 5);
+    EXPECT_EQ(client.fcall_ro<std::string>("qbm_get", {key}), "5");
+}
+
+// Test typed function bindings
+TEST_F(RedisTest, SYNC_FUNCTION_COMMANDS_BINDING) {
+    std::string key = test_key("binding");
+    redis.function_flush();
+    redis.register_library(TEST_LIBRARY);
+
+    auto incrby = redis.function<long long(std::string, long long)>("qbm_test",
+                                                                    "qbm_incrby", 1);
+    auto get    = redis.function_ro<std::string(std::string)>("qbm_test", "qbm_get", 1);
+
+    // The library is absent, the first call loads it and is retried
+    EXPECT_EQ(incrby(key, 3), 3);
+    EXPECT_EQ(incrby(key, 4), 7);
+    EXPECT_EQ(get(key), "7");
+
+    // Unknown function of an unregistered library is reported
+    auto unknown = redis.function<long long()>("qbm_none", "qbm_none");
+    EXPECT_THROW(unknown(), std::runtime_error);
+    EXPECT_THROW((redis.function<long long(std::string)>("qbm_test", "qbm_incrby", 2)),
+                 std::invalid_argument);
+}
+
 /*
  * ASYNCHRONOUS TESTS
  */
@@ -470,6 +517,31 @@ TEST_F(RedisTest, ASYNC_FUNCTION_COMMANDS_HELP) {
     EXPECT_TRUE(help_completed);
 }
 
+// Test async typed function bindings
+TEST_F(RedisTest, ASYNC_FUNCTION_COMMANDS_BINDING) {
+    std::string key = test_key("async_binding");
+    redis.function_flush();
+    redis.register_library(TEST_LIBRARY);
+
+    auto incrby = redis.function<long long(std::string, long long)>("qbm_test",
+                                                                    "qbm_incrby", 1);
+    long long last      = 0;
+    int       completed = 0;
+    for (int i = 0; i < 3; ++i) {
+        incrby(
+            [&](auto &&reply) {
+                EXPECT_TRUE(reply.ok());
+                last = reply.result();
+                ++completed;
+            },
+            key, 2);
+    }
+
+    redis.await();
+    EXPECT_EQ(completed, 3);
+    EXPECT_EQ(*redis.get(key), "6");
+}
+
 // Main function to run the tests
 int
 main(int argc, char **argv) {
@@ -338,6 +338,109 @@ TEST_F(RedisGeoTest, SYNC_GEO_COMMANDS_DISTANCE_UNITS) {
     EXPECT_NEAR(*dist_ft * 0.3048, *dist_m, 1.0); // Convert ft to m for comparison
 }
 
+// Test GEOSEARCH with a structure-of-arrays result
+TEST_F(RedisGeoTest, SYNC_GEO_COMMANDS_GEOSEARCH_RESULT) {
+    using namespace qb::redis;
+    std::string key = test_key("geosearch_result");
+
+    redis.geoadd(key, 13.361389, 38.115556, "Palermo", 15.087269, 37.502669, "Catania");
+
+    geo_search_options options;
+    options.sort       = GeoSort::ASC;
+    options.with_dist  = true;
+    options.with_coord = true;
+    options.with_hash  = true;
+    auto result = redis.geosearch(key, geo_origin::from_lonlat(15, 37),
+                                  geo_shape::radius(200, GeoUnit::KM), options);
+    EXPECT_EQ(result.size(), 2);
+    EXPECT_EQ(result.members[0], "Catania");
+    EXPECT_EQ(result.members[1], "Palermo");
+    EXPECT_EQ(result.distances.size(), 2);
+    EXPECT_NEAR(result.distances[0], 56.4413, 0.01);
+    EXPECT_NEAR(result.distances[1], 190.4424, 0.01);
+    EXPECT_EQ(result.hashes.size(), 2);
+    EXPECT_EQ(result.hashes[1], 3479099956230698);
+    EXPECT_NEAR(result.position(1).longitude, 13.361389, 1e-5);
+    EXPECT_NEAR(result.latitudes[1], 38.115556, 1e-5);
+
+    // Copies keep valid member views
+    auto copy = result;
+    result    = {};
+    EXPECT_EQ(copy.members[1], "Palermo");
+
+    // Plain BYBOX search from a member with COUNT
+    options = {};
+    options.count = 1;
+    auto box = redis.geosearch(key, geo_origin::from_member("Palermo"),
+                               geo_shape::box(400, 400, GeoUnit::KM), options);
+    EXPECT_EQ(box.size(), 1);
+    EXPECT_TRUE(box.distances.empty());
+
+    // GEOSEARCHSTORE
+    EXPECT_EQ(redis.geosearchstore(test_key("geosearch_store"), key,
+                                   geo_origin::from_lonlat(15, 37),
+                                   geo_shape::radius(100, GeoUnit::KM)),
+              1);
+}
+
+// Test batched GEOADD from parallel arrays
+TEST_F(RedisGeoTest, SYNC_GEO_COMMANDS_GEOADD_BATCH) {
+    std::string key = test_key("geoadd_batch");
+
+    std::vector<double>      longitudes;
+    std::vector<double>      latitudes;
+    std::vector<std::string> members;
+    for (int i = 0; i < 1000; ++i) {
+        longitudes.push_back(-10 + i * 0.02);
+        latitudes.push_back(40 + i * 0.01);
+        members.push_back("point" + std::to_string(i));
+    }
+
+    EXPECT_EQ(redis.geoadd_batch(key, longitudes, latitudes, members), 1000);
+    EXPECT_EQ(redis.zcard(key), 1000);
+
+    // NX does not update, CH counts changes
+    longitudes[0] = 0;
+    EXPECT_EQ(redis.geoadd_batch(key, longitudes, latitudes, members,
+                                 qb::redis::UpdateType::NOT_EXIST, true, 100),
+              0);
+    EXPECT_EQ(redis.geoadd_batch(key, longitudes, latitudes, members,
+                                 qb::redis::UpdateType::EXIST, true, 100),
+              1);
+
+    // Sizes must match
+    latitudes.pop_back();
+    EXPECT_THROW(redis.geoadd_batch(key, longitudes, latitudes, members),
+                 std::invalid_argument);
+}
+
+// Test local geohash against the server
+TEST_F(RedisGeoTest, SYNC_GEO_COMMANDS_LOCAL_GEOHASH) {
+    namespace geohash = qb::redis::geohash;
+    std::string key   = test_key("local_geohash");
+
+    redis.geoadd(key, 13.361389, 38.115556, "Palermo", 15.087269, 37.502669, "Catania");
+
+    auto score = redis.zscore(key, "Palermo");
+    EXPECT_TRUE(score.has_value());
+    EXPECT_EQ(geohash::encode(13.361389, 38.115556),
+              static_cast<std::uint64_t>(*score));
+
+    auto pos = redis.geopos(key, "Palermo");
+    auto local = geohash::decode(geohash::encode(13.361389, 38.115556));
+    EXPECT_DOUBLE_EQ(local.longitude, pos[0]->longitude);
+    EXPECT_DOUBLE_EQ(local.latitude, pos[0]->latitude);
+
+    auto hashes = redis.geohash(key, "Palermo", "Catania");
+    EXPECT_EQ(geohash::to_string(13.361389, 38.115556), *hashes[0]);
+    EXPECT_EQ(geohash::to_string(15.087269, 37.502669), *hashes[1]);
+
+    // Coarse cells for pre-bucketing
+    EXPECT_EQ(geohash::cell(geohash::encode(13.361389, 38.115556), 10),
+              geohash::encode(13.361389, 38.115556, 10));
+    EXPECT_THROW(geohash::encode(0, 86), std::invalid_argument);
+}
+
 /*
  * ASYNCHRONOUS TESTS
  */
@@ -449,4 +552,50 @@ TEST_F(RedisGeoTest, ASYNC_GEO_COMMANDS_GEOSEARCH) {
     redis.await();
     EXPECT_FALSE(results.empty());
     EXPECT_TRUE(std::find(results.begin(), results.end(), "Palermo") != results.end());
-}
\ No newline at end of file
+}
+
+// Test async GEOSEARCH with a structure-of-arrays result
+TEST_F(RedisGeoTest, ASYNC_GEO_COMMANDS_GEOSEARCH_RESULT) {
+    using namespace qb::redis;
+    std::string       key = test_key("async_geosearch_result");
+    geo_search_result result;
+
+    redis.geoadd(key, 13.361389, 38.115556, "Palermo", 15.087269, 37.502669, "Catania");
+
+    geo_search_options options;
+    options.sort      = GeoSort::DESC;
+    options.with_dist = true;
+    redis.geosearch([&](auto &&reply) { result = std::move(reply.result()); }, key,
+                    geo_origin::from_member("Catania"),
+                    geo_shape::radius(200, GeoUnit::KM), options);
+
+    redis.await();
+    EXPECT_EQ(result.size(), 2);
+    EXPECT_EQ(result.members[0], "Palermo");
+    EXPECT_EQ(result.members[1], "Catania");
+    EXPECT_NEAR(result.distances[1], 0, 1e-6);
+    EXPECT_TRUE(result.longitudes.empty());
+}
+
+// Test async batched GEOADD
+TEST_F(RedisGeoTest, ASYNC_GEO_COMMANDS_GEOADD_BATCH) {
+    std::string key     = test_key("async_geoadd_batch");
+    long long   added   = 0;
+    int         replies = 0;
+
+    double      longitudes[] = {13.361389, 15.087269, 13.583333};
+    double      latitudes[]  = {38.115556, 37.502669, 37.316667};
+    const char *members[]    = {"Palermo", "Catania", "Agrigento"};
+
+    redis.geoadd_batch(
+        [&](auto &&reply) {
+            EXPECT_TRUE(reply.ok());
+            added = reply.result();
+            ++replies;
+        },
+        key, longitudes, latitudes, members, qb::redis::UpdateType::ALWAYS, false, 2);
+
+    redis.await();
+    EXPECT_EQ(replies, 1);
+    EXPECT_EQ(added, 3);
+}
@@ -237,6 +237,90 @@ TEST_F(RedisTest, SYNC_HASH_COMMANDS_HSCAN) {
     redis.del(key);
 }
 
+// Structure stored as a hash through its field table
+enum class AccountLevel { BASIC = 1, GOLD = 2 };
+
+struct Account {
+    std::string          name;
+    long long            balance{};
+    double               ratio{};
+    bool                 active{};
+    AccountLevel         level{AccountLevel::BASIC};
+    std::optional<int>   referrer;
+};
+
+template <>
+struct qb::redis::hash_mapping<Account> {
+    static constexpr auto fields = std::make_tuple(
+        hash_field{"name", &Account::name}, hash_field{"balance", &Account::balance},
+        hash_field{"ratio", &Account::ratio}, hash_field{"active", &Account::active},
+        hash_field{"level", &Account::level}, hash_field{"referrer", &Account::referrer});
+};
+
+// Test struct to hash mapping with HSET/HMGET
+TEST_F(RedisTest, SYNC_HASH_COMMANDS_OBJECT_MAPPING) {
+    std::string key = test_key("object");
+
+    Account account{"alice", -42, 0.125, true, AccountLevel::GOLD, std::nullopt};
+    // Empty optional members are not written
+    EXPECT_EQ(redis.hset_object(key, account), 5);
+    EXPECT_EQ(redis.hlen(key), 5);
+    EXPECT_EQ(redis.hget(key, "balance"), "-42");
+    EXPECT_EQ(redis.hget(key, "active"), "1");
+    EXPECT_EQ(redis.hget(key, "level"), "2");
+
+    auto loaded = redis.hget_object<Account>(key);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->name, "alice");
+    EXPECT_EQ(loaded->balance, -42);
+    EXPECT_EQ(loaded->ratio, 0.125);
+    EXPECT_TRUE(loaded->active);
+    EXPECT_EQ(loaded->level, AccountLevel::GOLD);
+    EXPECT_FALSE(loaded->referrer.has_value());
+
+    // Partial load fetches only the given members
+    account.referrer = 7;
+    account.balance  = 100;
+    redis.hset_object(key, account);
+    auto partial = redis.hget_object<Account>(key, &Account::balance, &Account::referrer);
+    ASSERT_TRUE(partial.has_value());
+    EXPECT_TRUE(partial->name.empty());
+    EXPECT_EQ(partial->balance, 100);
+    EXPECT_EQ(partial->referrer, 7);
+
+    // Missing hash and invalid values
+    EXPECT_FALSE(redis.hget_object<Account>(test_key("missing")).has_value());
+    redis.hset(key, "balance", "not a number");
+    EXPECT_THROW(redis.hget_object<Account>(key), std::runtime_error);
+}
+
+// Test HRANDFIELD operations
+TEST_F(RedisTest, SYNC_HASH_COMMANDS_HRANDFIELD) {
+    std::string key = test_key("hrandfield");
+
+    EXPECT_FALSE(redis.hrandfield(key).has_value());
+    EXPECT_TRUE(redis.hrandfield_withvalues(key, 3).empty());
+
+    redis.hset(key, "f1", "v1");
+    redis.hset(key, "f2", "v2");
+    redis.hset(key, "f3", "v3");
+
+    auto field = redis.hrandfield(key);
+    ASSERT_TRUE(field.has_value());
+    EXPECT_EQ(field->size(), 2);
+
+    EXPECT_EQ(redis.hrandfield(key, 2).size(), 2);
+    EXPECT_EQ(redis.hrandfield(key, 10).size(), 3);
+    // Negative counts allow repetitions
+    EXPECT_EQ(redis.hrandfield(key, -10).size(), 10);
+
+    auto pairs = redis.hrandfield_withvalues(key, -6);
+    ASSERT_EQ(pairs.size(), 6);
+    ASSERT_EQ(pairs.values.size(), 6);
+    for (std::size_t i = 0; i < pairs.size(); ++i)
+        EXPECT_EQ(pairs.values[i], "v" + std::string(pairs.fields[i].substr(1)));
+}
+
 /*
  * ASYNCHRONOUS TESTS
  */
@@ -514,6 +598,41 @@ TEST_F(RedisTest, ASYNC_HASH_COMMANDS_CHAINING) {
     redis.del(key);
 }
 
+// Test struct to hash mapping asynchronously
+TEST_F(RedisTest, ASYNC_HASH_COMMANDS_OBJECT_MAPPING) {
+    std::string                 key = test_key("async_object");
+    long long                   added = 0;
+    std::optional<Account>      loaded;
+
+    Account account{"bob", 1000, 2.5, false, AccountLevel::BASIC, 3};
+    redis.hset_object([&](auto &&reply) { added = reply.result(); }, key, account);
+    redis.hget_object<Account>([&](auto &&reply) { loaded = std::move(reply.result()); },
+                               key, &Account::name, &Account::ratio);
+
+    redis.await();
+    EXPECT_EQ(added, 6);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->name, "bob");
+    EXPECT_EQ(loaded->ratio, 2.5);
+    EXPECT_EQ(loaded->balance, 0);
+    EXPECT_FALSE(loaded->referrer.has_value());
+}
+
+// Test HRANDFIELD WITHVALUES asynchronously
+TEST_F(RedisTest, ASYNC_HASH_COMMANDS_HRANDFIELD) {
+    std::string                 key = test_key("async_hrandfield");
+    qb::redis::field_value_list pairs;
+
+    redis.hset(key, "field", "value");
+    redis.hrandfield_withvalues([&](auto &&reply) { pairs = std::move(reply.result()); },
+                                key, 1);
+
+    redis.await();
+    ASSERT_EQ(pairs.size(), 1);
+    EXPECT_EQ(pairs.fields[0], "field");
+    EXPECT_EQ(pairs.values[0], "value");
+}
+
 // Main function to run the tests
 int
 main(int argc, char **argv) {
@@ -122,6 +122,49 @@ TEST_F(RedisHyperLogLogTest, SYNC_HYPERLOGLOG_PFMERGE) {
     EXPECT_EQ(redis.pfcount(destkey), 5);
 }
 
+// Test local sketch against the server encoding
+TEST_F(RedisHyperLogLogTest, SYNC_HYPERLOGLOG_LOCAL_SKETCH) {
+    std::string key = test_key("local_sketch");
+
+    qb::redis::hyperloglog sketch;
+    for (int i = 0; i < 5000; ++i) {
+        auto element = "element" + std::to_string(i);
+        sketch.add(element);
+        if (i < 10)
+            redis.pfadd(key, element);
+    }
+
+    // A sparse server sketch decodes to the same registers as a local one
+    auto sparse = redis.pfget_sketch(key);
+    EXPECT_TRUE(sparse.has_value());
+    qb::redis::hyperloglog local_small;
+    for (int i = 0; i < 10; ++i)
+        local_small.add("element" + std::to_string(i));
+    EXPECT_TRUE(*sparse == local_small);
+
+    // Merging the local sketch gives the server count of the union
+    EXPECT_TRUE(redis.pfmerge_sketch(key, sketch));
+    EXPECT_EQ(redis.pfcount(key), static_cast<long long>(sketch.count()));
+    EXPECT_FALSE(redis.exists(key + ":pfmerge-sketch"));
+
+    // A destination without hash tag becomes the tag of the temporary key
+    const std::string plain = key_prefix("plain");
+    EXPECT_TRUE(redis.pfmerge_sketch(plain, sketch));
+    EXPECT_EQ(redis.pfcount(plain), static_cast<long long>(sketch.count()));
+    EXPECT_FALSE(redis.exists("{" + plain + "}:pfmerge-sketch"));
+
+    // PFADD of known elements does not alter the merged registers
+    EXPECT_FALSE(redis.pfadd(key, "element42"));
+
+    auto dense = redis.pfget_sketch(key);
+    EXPECT_TRUE(dense.has_value());
+    EXPECT_TRUE(*dense == sketch);
+    EXPECT_FALSE(redis.pfget_sketch(test_key("missing")).has_value());
+
+    redis.set(test_key("string"), "value");
+    EXPECT_THROW(redis.pfget_sketch(test_key("string")), std::invalid_argument);
+}
+
 /*
  * ASYNCHRONOUS TESTS
  */
@@ -176,4 +219,23 @@ TEST_F(RedisHyperLogLogTest, ASYNC_HYPERLOGLOG_PFMERGE) {
 
     redis.await();
     EXPECT_EQ(count, 5);
-}
\ No newline at end of file
+}
+
+// Test async local sketch merge and fetch
+TEST_F(RedisHyperLogLogTest, ASYNC_HYPERLOGLOG_LOCAL_SKETCH) {
+    std::string                           key    = test_key("async_local_sketch");
+    bool                                  merged = false;
+    std::optional<qb::redis::hyperloglog> fetched;
+
+    qb::redis::hyperloglog sketch;
+    for (int i = 0; i < 1000; ++i)
+        sketch.add("element" + std::to_string(i));
+
+    redis.pfmerge_sketch([&](auto &&reply) { merged = reply.result(); }, key, sketch);
+    redis.pfget_sketch([&](auto &&reply) { fetched = std::move(reply.result()); }, key);
+
+    redis.await();
+    EXPECT_TRUE(merged);
+    EXPECT_TRUE(fetched.has_value());
+    EXPECT_TRUE(*fetched == sketch);
+}
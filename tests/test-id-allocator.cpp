@@ -0,0 +1,199 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include <set>
+#include <thread>
+#include "../id_allocator.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using allocator_type = qb::redis::id_allocator<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::id-allocator-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return "{" + key_prefix() + "}::" + k;
+}
+
+// Builds the options of small blocks
+inline allocator_type::options
+small_blocks() {
+    allocator_type::options opts;
+    opts.block     = 10;
+    opts.min_block = 10;
+    opts.max_block = 1000;
+    return opts;
+}
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test handing out the IDs of consecutive blocks
+TEST_F(RedisTest, SYNC_ID_ALLOCATOR_BLOCKS) {
+    std::string    key = test_key("ids");
+    allocator_type first{redis, key, small_blocks()};
+
+    for (long long expected = 1; expected <= 25; ++expected)
+        EXPECT_EQ(first.next(), expected);
+    EXPECT_GE(first.blocks(), 3u);
+
+    // Blocks consumed that fast grow up to max_block
+    EXPECT_EQ(first.block_size(), 1000);
+
+    // Another allocator never hands out the same IDs
+    allocator_type second{redis, key, small_blocks()};
+    const auto     reserved = std::stoll(*redis.get(key));
+    EXPECT_EQ(second.next(), reserved + 1);
+}
+
+// Test reserving the next block when the prefetch ratio is used
+TEST_F(RedisTest, SYNC_ID_ALLOCATOR_PREFETCH) {
+    allocator_type allocator{redis, test_key("ids"), small_blocks()};
+
+    EXPECT_FALSE(allocator.try_next());
+    redis.await();
+    EXPECT_EQ(allocator.remaining(), 10);
+
+    for (long long expected = 1; expected <= 7; ++expected)
+        EXPECT_EQ(allocator.try_next(), expected);
+    EXPECT_EQ(allocator.blocks(), 1u);
+
+    // The 8th ID leaves 20% of the block
+    EXPECT_EQ(allocator.try_next(), 8);
+    redis.await();
+    EXPECT_EQ(allocator.blocks(), 2u);
+    EXPECT_EQ(allocator.remaining(), 12);
+}
+
+// Test the time ordered layout
+TEST_F(RedisTest, SYNC_ID_ALLOCATOR_SNOWFLAKE) {
+    const auto epoch = system_clock::now() - hours(1);
+    auto       opts  = small_blocks();
+    opts.layout      = allocator_type::snowflake{epoch, 20};
+    allocator_type allocator{redis, test_key("ids"), opts};
+
+    const long long first  = allocator.next();
+    const long long second = allocator.next();
+    EXPECT_EQ(second - first, 1); // Same block
+    EXPECT_LT(first & ((1 << 20) - 1), 10);
+
+    const long long elapsed = duration_cast<milliseconds>(system_clock::now() - epoch)
+                                  .count();
+    EXPECT_LE(first >> 20, elapsed + 1000);
+    EXPECT_GE(first >> 20, elapsed - 10000);
+
+    // The epoch bounds the timestamps, it can not be left to 1970
+    opts.layout = allocator_type::snowflake{{}, 20};
+    EXPECT_THROW(allocator_type(redis, test_key("ids"), opts), std::invalid_argument);
+}
+
+// Test IDs of blocks handed out late never collide with newer blocks
+TEST_F(RedisTest, SYNC_ID_ALLOCATOR_SNOWFLAKE_NO_COLLISION) {
+    const auto key  = test_key("ids");
+    auto       opts = small_blocks();
+    opts.layout     = allocator_type::snowflake{system_clock::now() - hours(1), 4};
+    allocator_type slow{redis, key, opts};
+    allocator_type fast{redis, key, opts};
+
+    // slow keeps its block while fast reserves many blocks in the next milliseconds
+    std::set<long long> ids;
+    ids.insert(slow.next());
+    for (int i = 0; i < 500; ++i)
+        EXPECT_TRUE(ids.insert(fast.next()).second);
+    std::this_thread::sleep_for(milliseconds(5));
+    for (int i = 0; i < 20; ++i)
+        EXPECT_TRUE(ids.insert(slow.next()).second);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(ids.insert(slow.next()).second);
+        EXPECT_TRUE(ids.insert(fast.next()).second);
+    }
+    EXPECT_EQ(ids.size(), 721u);
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the requests waiting for a block
+TEST_F(RedisTest, ASYNC_ID_ALLOCATOR_NEXT) {
+    allocator_type         allocator{redis, test_key("ids"), small_blocks()};
+    std::vector<long long> ids;
+
+    for (int i = 0; i < 30; ++i)
+        allocator.next([&](auto &&reply) {
+            EXPECT_TRUE(reply.ok());
+            ids.push_back(reply.result());
+        });
+    redis.await();
+
+    ASSERT_EQ(ids.size(), 30u);
+    for (std::size_t i = 0; i < ids.size(); ++i)
+        EXPECT_EQ(ids[i], static_cast<long long>(i) + 1);
+    EXPECT_EQ(std::set<long long>(ids.begin(), ids.end()).size(), 30u);
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -251,6 +251,38 @@ TEST_F(RedisTest, SYNC_KEY_COMMANDS_UNLINK) {
     EXPECT_FALSE(redis.exists(key3));
 }
 
+// Test COPY and EXPIRETIME/PEXPIRETIME commands
+TEST_F(RedisTest, SYNC_KEY_COMMANDS_COPY_EXPIRETIME) {
+    std::string src = test_key("copy_src");
+    std::string dst = test_key("copy_dst");
+
+    redis.set(src, "value");
+    EXPECT_TRUE(redis.copy(src, dst));
+    EXPECT_EQ(redis.get(dst), "value");
+
+    // Existing destination is kept unless REPLACE is given
+    redis.set(src, "other");
+    EXPECT_FALSE(redis.copy(src, dst));
+    EXPECT_EQ(redis.get(dst), "value");
+    EXPECT_TRUE(redis.copy(src, dst, true));
+    EXPECT_EQ(redis.get(dst), "other");
+    EXPECT_FALSE(redis.copy(test_key("copy_missing"), dst, true));
+
+    // Copy to another database
+    EXPECT_TRUE(redis.copy(src, dst, true, 1));
+
+    EXPECT_EQ(redis.expiretime(src), -1);
+    EXPECT_EQ(redis.expiretime(test_key("expiretime_missing")), -2);
+    redis.expireat(src, 4102444800); // 2100-01-01
+    EXPECT_EQ(redis.expiretime(src), 4102444800);
+    EXPECT_EQ(redis.pexpiretime(src), 4102444800000);
+
+    // Remove the copy left in database 1
+    ASSERT_TRUE(redis.select(1));
+    EXPECT_EQ(redis.del(dst), 1);
+    ASSERT_TRUE(redis.select(0));
+}
+
 /*
  * ASYNCHRONOUS TESTS
  */
@@ -461,4 +493,21 @@ TEST_F(RedisTest, ASYNC_KEY_COMMANDS_UNLINK) {
     EXPECT_FALSE(redis.exists(key1));
     EXPECT_FALSE(redis.exists(key2));
     EXPECT_FALSE(redis.exists(key3));
-}
\ No newline at end of file
+}
+
+// Test COPY and EXPIRETIME asynchronously
+TEST_F(RedisTest, ASYNC_KEY_COMMANDS_COPY_EXPIRETIME) {
+    std::string src        = test_key("async_copy_src");
+    std::string dst        = test_key("async_copy_dst");
+    bool        copied     = false;
+    long long   expiretime = 0;
+
+    redis.set(src, "value");
+    redis.expireat(src, 4102444800);
+    redis.copy([&](auto &&reply) { copied = reply.result(); }, src, dst);
+    redis.expiretime([&](auto &&reply) { expiretime = reply.result(); }, dst);
+
+    redis.await();
+    EXPECT_TRUE(copied);
+    EXPECT_EQ(expiretime, 4102444800);
+}
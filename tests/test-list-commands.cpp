@@ -484,6 +484,48 @@ TEST_F(RedisTest, SYNC_LIST_COMMANDS_MULTIPLE_PUSH) {
     redis.del(key);
 }
 
+// Test LMPOP/BLMPOP operations
+TEST_F(RedisTest, SYNC_LIST_COMMANDS_LMPOP) {
+    std::string empty = test_key("lmpop_empty");
+    std::string key   = test_key("lmpop");
+
+    EXPECT_FALSE(redis.lmpop({empty, key}, qb::redis::ListPosition::LEFT).has_value());
+
+    redis.rpush(key, "a", "b", "c", "d");
+    auto popped = redis.lmpop({empty, key}, qb::redis::ListPosition::LEFT, 3);
+    ASSERT_TRUE(popped.has_value());
+    EXPECT_EQ(popped->key, key);
+    EXPECT_EQ(popped->elements, (std::vector<std::string>{"a", "b", "c"}));
+
+    popped = redis.blmpop({empty, key}, qb::redis::ListPosition::RIGHT, 0.1, 10);
+    ASSERT_TRUE(popped.has_value());
+    EXPECT_EQ(popped->elements, (std::vector<std::string>{"d"}));
+
+    // Timeout on empty lists
+    EXPECT_FALSE(
+        redis.blmpop({empty, key}, qb::redis::ListPosition::RIGHT, 0.1).has_value());
+}
+
+// Test BLMOVE operation
+TEST_F(RedisTest, SYNC_LIST_COMMANDS_BLMOVE) {
+    std::string source      = test_key("blmove_src");
+    std::string destination = test_key("blmove_dst");
+
+    redis.rpush(source, "a", "b");
+    auto moved = redis.blmove(source, destination, qb::redis::ListPosition::RIGHT,
+                              qb::redis::ListPosition::LEFT, 0.1);
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_EQ(*moved, "b");
+    EXPECT_EQ(redis.lrange(destination, 0, -1), (std::vector<std::string>{"b"}));
+
+    redis.del(source);
+    // Timeout on an empty source
+    EXPECT_FALSE(redis
+                     .blmove(source, destination, qb::redis::ListPosition::RIGHT,
+                             qb::redis::ListPosition::LEFT, 0.1)
+                     .has_value());
+}
+
 /*
  * ASYNCHRONOUS TESTS
  */
@@ -673,6 +715,32 @@ TEST_F(RedisTest, ASYNC_LIST_COMMANDS_CHAINING) {
     redis.del(key);
 }
 
+// Test LMPOP asynchronously
+TEST_F(RedisTest, ASYNC_LIST_COMMANDS_LMPOP) {
+    std::string                               key = test_key("async_lmpop");
+    std::optional<qb::redis::list_pop_result> popped;
+
+    redis.rpush(key, "a", "b", "c");
+    redis.lmpop([&](auto &&reply) { popped = std::move(reply.result()); }, {key},
+                qb::redis::ListPosition::RIGHT, 2);
+
+    redis.await();
+    ASSERT_TRUE(popped.has_value());
+    EXPECT_EQ(popped->key, key);
+    EXPECT_EQ(popped->elements, (std::vector<std::string>{"c", "b"}));
+
+    // Without keys the callback is invoked at once, nothing is sent
+    bool empty_ok = false, blocking_ok = false;
+    redis.lmpop(
+        [&](auto &&reply) { empty_ok = reply.ok() && !reply.result().has_value(); }, {},
+        qb::redis::ListPosition::LEFT);
+    redis.blmpop(
+        [&](auto &&reply) { blocking_ok = reply.ok() && !reply.result().has_value(); },
+        {}, qb::redis::ListPosition::LEFT, 1);
+    EXPECT_TRUE(empty_ok);
+    EXPECT_TRUE(blocking_ok);
+}
+
 // Main function to run the tests
 int
 main(int argc, char **argv) {
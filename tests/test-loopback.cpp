@@ -0,0 +1,170 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include "../loopback.h"
+
+// Loopback Configuration, no server is involved
+#define REDIS_URI {"loopback://"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+// Encodes a bulk string reply
+inline std::string
+bulk(const std::string &value) {
+    return "$" + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+}
+
+class LoopbackTest : public ::testing::Test {
+protected:
+    qb::redis::loopback::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect())
+            throw std::runtime_error("Unable to connect the loopback client");
+    }
+
+    void
+    TearDown() override {
+        redis.disconnect();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test the echo responder
+TEST_F(LoopbackTest, SYNC_ECHO) {
+    EXPECT_EQ(redis.ping(), "PONG");
+    EXPECT_EQ(redis.echo("hello"), "hello");
+    EXPECT_EQ(redis.ping("message"), "message");
+    EXPECT_EQ(redis.get("key"), "key");
+}
+
+// Test the scripted responder
+TEST_F(LoopbackTest, SYNC_SCRIPTED) {
+    redis.transport().respond(responder::scripted(
+        {{"SET", "+OK\r\n"}, {"GET", bulk("value")}, {"INCR", ":7\r\n"}}));
+    EXPECT_TRUE(redis.set("key", "value"));
+    EXPECT_EQ(redis.get("key"), "value");
+    EXPECT_EQ(redis.incr("counter"), 7);
+    EXPECT_THROW(redis.decr("counter"), std::runtime_error);
+}
+
+// Test the replies of a traffic log are served in turn
+TEST_F(LoopbackTest, SYNC_TRAFFIC) {
+    const std::string path = "qbm-redis-test.qbrt";
+    {
+        traffic_recorder recorder(path);
+        recorder.record(traffic_direction::OUT, "*1\r\n$4\r\nPING\r\n", 14);
+        const std::string replies = "+OK\r\n" + bulk("first") + ":3\r\n";
+        recorder.record(traffic_direction::IN, replies.data(), 4);
+        recorder.record(traffic_direction::IN, replies.data() + 4, replies.size() - 4);
+    }
+    std::ostringstream log;
+    log << std::ifstream(path, std::ios::binary).rdbuf();
+    std::remove(path.c_str());
+
+    redis.transport().respond(responder::traffic(log.str()));
+    EXPECT_TRUE(redis.set("key", "value"));
+    EXPECT_EQ(redis.get("key"), "first");
+    EXPECT_EQ(redis.incr("counter"), 3);
+    EXPECT_TRUE(redis.set("key", "value"));
+
+    EXPECT_THROW(responder::traffic(log.str().substr(0, 13)), std::invalid_argument);
+}
+
+// Test a protocol error disconnects the client and fails the commands
+TEST_F(LoopbackTest, SYNC_PROTOCOL_ERROR) {
+    redis.transport().respond(responder::constant("?garbage\r\n"));
+    EXPECT_THROW(redis.ping(), std::runtime_error);
+    EXPECT_FALSE(redis.is_alive());
+    EXPECT_THROW(redis.ping(), std::runtime_error);
+
+    redis.transport().respond(responder::echo());
+    EXPECT_TRUE(redis.connect());
+    EXPECT_EQ(redis.ping(), "PONG");
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test pipelined commands with replies read byte by byte
+TEST_F(LoopbackTest, ASYNC_PIPELINE_CHUNKED) {
+    redis.transport().respond(responder::constant(":1\r\n")).chunk_size(1);
+    int replies = 0;
+    for (int i = 0; i < 1000; ++i)
+        redis.incr(
+            [&](auto &&reply) {
+                EXPECT_TRUE(reply.ok());
+                EXPECT_EQ(reply.result(), 1);
+                ++replies;
+            },
+            "counter");
+    EXPECT_EQ(replies, 0);
+    redis.process();
+    EXPECT_EQ(replies, 1000);
+}
+
+// Test random values read in random chunks are parsed exactly
+TEST_F(LoopbackTest, ASYNC_RANDOM_CHUNKS) {
+    std::mt19937                       random(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<std::string>           values(200);
+    for (auto &value : values) {
+        value.resize(random() % 2000);
+        for (auto &c : value)
+            c = static_cast<char>(byte(random));
+    }
+
+    std::size_t index = 0;
+    redis.transport().respond([&](const resp_command &, std::string &reply) {
+        reply += bulk(values[index++]);
+    });
+    for (std::size_t chunk : {1, 7, 512, 0}) {
+        index = 0;
+        redis.transport().chunk_size(chunk);
+        std::size_t matched = 0;
+        for (const auto &value : values)
+            redis.get(
+                [&](auto &&reply) {
+                    EXPECT_TRUE(reply.ok());
+                    matched += reply.result() == value;
+                },
+                "key");
+        redis.await();
+        EXPECT_EQ(matched, values.size()) << chunk;
+    }
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,211 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include <thread>
+#include "../rate_limiter.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using limiter_type = qb::redis::rate_limiter<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::rate-limiter-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return "{" + key_prefix() + "}::" + k;
+}
+
+// Builds the options of a limiter of 10 tokens per minute
+inline limiter_type::options
+ten_per_minute(RateAlgorithm algorithm) {
+    limiter_type::options opts;
+    opts.algorithm    = algorithm;
+    opts.limit        = 10;
+    opts.period       = minutes(1);
+    opts.lease_size   = 4;
+    opts.refill_below = 1;
+    opts.lease_ttl    = seconds(10);
+    return opts;
+}
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test the sliding window limit across leases
+TEST_F(RedisTest, SYNC_RATE_LIMITER_SLIDING_WINDOW) {
+    limiter_type limiter{redis, test_key("bucket"),
+                         ten_per_minute(RateAlgorithm::SLIDING_WINDOW)};
+
+    int granted = 0;
+    for (int i = 0; i < 15; ++i)
+        granted += limiter.acquire();
+    EXPECT_EQ(granted, 10);
+    EXPECT_GE(limiter.leases(), 3u);
+    EXPECT_LT(limiter.leases(), 10u);
+}
+
+// Test the GCRA burst limit
+TEST_F(RedisTest, SYNC_RATE_LIMITER_GCRA) {
+    limiter_type limiter{redis, test_key("bucket"), ten_per_minute(RateAlgorithm::GCRA)};
+
+    int granted = 0;
+    for (int i = 0; i < 15; ++i)
+        granted += limiter.acquire();
+    EXPECT_EQ(granted, 10);
+    EXPECT_FALSE(limiter.acquire(1));
+}
+
+// Test non-positive token counts are rejected
+TEST_F(RedisTest, SYNC_RATE_LIMITER_INVALID_TOKENS) {
+    limiter_type limiter{redis, test_key("bucket"), ten_per_minute(RateAlgorithm::GCRA)};
+
+    EXPECT_THROW(limiter.try_acquire(0), std::invalid_argument);
+    EXPECT_THROW(limiter.acquire(-1), std::invalid_argument);
+    EXPECT_THROW(limiter.acquire([](auto &&) {}, -5), std::invalid_argument);
+    EXPECT_EQ(limiter.available(), 0);
+}
+
+// Test giving the unused tokens back on shutdown
+TEST_F(RedisTest, SYNC_RATE_LIMITER_RELEASE) {
+    for (auto algorithm : {RateAlgorithm::SLIDING_WINDOW, RateAlgorithm::GCRA}) {
+        std::string key  = test_key("bucket");
+        auto        opts = ten_per_minute(algorithm);
+        opts.lease_size   = 5;
+        opts.refill_below = 0;
+
+        limiter_type first{redis, key, opts};
+        EXPECT_TRUE(first.acquire());
+        EXPECT_EQ(first.available(), 4);
+        EXPECT_EQ(first.release(), 4);
+        EXPECT_EQ(first.available(), 0);
+
+        limiter_type second{redis, key, opts};
+        int          granted = 0;
+        for (int i = 0; i < 12; ++i)
+            granted += second.acquire();
+        EXPECT_EQ(granted, 9);
+    }
+}
+
+// Test released tokens go back to the window they were leased in
+TEST_F(RedisTest, SYNC_RATE_LIMITER_RELEASE_WINDOW) {
+    const auto            key = test_key("bucket");
+    limiter_type::options opts;
+    opts.limit        = 100;
+    opts.period       = milliseconds(200);
+    opts.lease_size   = 5;
+    opts.refill_below = 0;
+    opts.lease_ttl    = seconds(10);
+
+    limiter_type first{redis, key, opts};
+    EXPECT_TRUE(first.acquire());
+    std::this_thread::sleep_for(milliseconds(250));
+    limiter_type second{redis, key, opts};
+    EXPECT_TRUE(second.acquire());
+
+    first.release();
+    // The window of the second lease still counts its 5 tokens
+    long long   last = -1;
+    std::string counted;
+    for (const auto &[window, tokens] : redis.hgetall(key)) {
+        if (std::stoll(window) > last) {
+            last    = std::stoll(window);
+            counted = tokens;
+        }
+    }
+    EXPECT_EQ(counted, "5");
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the local fast path and the requests waiting for a lease
+TEST_F(RedisTest, ASYNC_RATE_LIMITER_ACQUIRE) {
+    limiter_type limiter{redis, test_key("bucket"), ten_per_minute(RateAlgorithm::GCRA)};
+
+    // No local token yet, the lease is requested in the background
+    EXPECT_FALSE(limiter.try_acquire());
+    redis.await();
+    EXPECT_EQ(limiter.available(), 4);
+    EXPECT_TRUE(limiter.try_acquire());
+
+    int granted = 0;
+    int denied  = 0;
+    for (int i = 0; i < 12; ++i)
+        limiter.acquire([&](auto &&reply) {
+            EXPECT_TRUE(reply.ok());
+            if (reply.result())
+                ++granted;
+            else
+                ++denied;
+        });
+    redis.await();
+    EXPECT_EQ(granted, 9);
+    EXPECT_EQ(denied, 3);
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,445 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include "../rdb.h"
+#include "../replication.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::rdb-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return key_prefix() + ":" + k;
+}
+
+// Collects the content of a dump as text
+struct collector : rdb_visitor {
+    int                                             version = 0;
+    std::map<std::string, std::string>              aux;
+    std::map<std::string, std::vector<std::string>> values;
+    std::map<std::string, long long>                expires;
+    std::map<std::string, std::size_t>              sizes;
+    std::vector<std::string>                        skip;
+    bool                                            ended = false;
+
+    void
+    on_version(int v) override {
+        version = v;
+    }
+
+    void
+    on_aux(std::string_view field, std::string_view value) override {
+        aux[std::string(field)] = std::string(value);
+    }
+
+    bool
+    on_key(const rdb_key &key) override {
+        if (key.expire_ms >= 0)
+            expires[std::string(key.key)] = key.expire_ms;
+        return std::find(skip.begin(), skip.end(), key.key) == skip.end();
+    }
+
+    void
+    add(const rdb_key &key, std::string value) {
+        values[std::string(key.key)].push_back(std::move(value));
+    }
+
+    void
+    on_string(const rdb_key &key, std::string_view value) override {
+        add(key, std::string(value));
+    }
+
+    void
+    on_list_element(const rdb_key &key, std::string_view element) override {
+        add(key, std::string(element));
+    }
+
+    void
+    on_set_member(const rdb_key &key, std::string_view member) override {
+        add(key, std::string(member));
+    }
+
+    void
+    on_zset_member(const rdb_key &key, std::string_view member, double score) override {
+        const auto rounded = static_cast<long long>(score);
+        add(key, std::string(member) + "=" + std::to_string(rounded));
+    }
+
+    void
+    on_hash_field(const rdb_key &key, std::string_view field, std::string_view value,
+                  long long) override {
+        add(key, std::string(field) + "=" + std::string(value));
+    }
+
+    void
+    on_stream_entry(const rdb_key &key, const stream_entry &entry) override {
+        // Sorted, as the fields of an entry are not ordered
+        std::map<std::string, std::string> fields(entry.fields.begin(),
+                                                  entry.fields.end());
+        std::string                        text = entry.id.to_string();
+        for (const auto &[field, value] : fields)
+            text += " " + field + "=" + value;
+        add(key, text);
+    }
+
+    void
+    on_stream_group(const rdb_key &key, std::string_view name,
+                    const stream_id &last) override {
+        add(key, "group " + std::string(name) + " " + last.to_string());
+    }
+
+    void
+    on_key_end(const rdb_key &key, std::size_t size) override {
+        sizes[std::string(key.key)] = size;
+    }
+
+    void
+    on_end(std::uint64_t) override {
+        ended = true;
+    }
+};
+
+// Builds dumps byte by byte
+namespace craft {
+
+inline std::string
+length(std::size_t n) {
+    if (n < 64)
+        return std::string(1, static_cast<char>(n));
+    if (n < 16384)
+        return {static_cast<char>(0x40 | (n >> 8)), static_cast<char>(n & 0xFF)};
+    return {'\x80', static_cast<char>(n >> 24), static_cast<char>(n >> 16),
+            static_cast<char>(n >> 8), static_cast<char>(n)};
+}
+
+inline std::string
+string(const std::string &s) {
+    return length(s.size()) + s;
+}
+
+// Listpack of strings shorter than 64 bytes and integers from 0 to 127
+inline std::string
+listpack(const std::vector<std::string> &items) {
+    std::string body;
+    for (const auto &item : items) {
+        if (!item.empty() && item.size() < 3 &&
+            item.find_first_not_of("0123456789") == std::string::npos) {
+            body += static_cast<char>(std::stoi(item));
+            body += '\x01';
+        } else {
+            body += static_cast<char>(0x80 | item.size());
+            body += item;
+            body += static_cast<char>(item.size() + 1);
+        }
+    }
+    body += '\xFF';
+    const auto  total = body.size() + 6;
+    std::string header{static_cast<char>(total),       static_cast<char>(total >> 8),
+                       static_cast<char>(total >> 16), static_cast<char>(total >> 24),
+                       static_cast<char>(items.size()),
+                       static_cast<char>(items.size() >> 8)};
+    return header + body;
+}
+
+// Ziplist of strings shorter than 64 bytes and integers from 0 to 12
+inline std::string
+ziplist(const std::vector<std::string> &items) {
+    std::string body;
+    char        previous = 0;
+    for (const auto &item : items) {
+        std::string entry;
+        const bool number =
+            item.size() <= 2 && item.find_first_not_of("0123456789") == std::string::npos;
+        if (number && std::stoi(item) <= 12)
+            entry = std::string(1, static_cast<char>(0xF1 + std::stoi(item)));
+        else
+            entry = static_cast<char>(item.size()) + item;
+        body += previous;
+        body += entry;
+        previous = static_cast<char>(entry.size() + 1);
+    }
+    return std::string(8, '\0') + std::string{static_cast<char>(items.size()), 0} + body +
+           '\xFF';
+}
+
+inline std::string
+dump(const std::string &body) {
+    return "REDIS0011" + body + '\xFF' + std::string(8, '\0');
+}
+
+} // namespace craft
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+
+    // Gets a snapshot of the server with a full resynchronization
+    std::string
+    snapshot() {
+        std::string                                 rdb;
+        bool                                        loaded = false;
+        qb::redis::replica<qb::io::transport::tcp> replica{REDIS_URI};
+        replica.on_rdb([&](auto chunk) { rdb.append(chunk); })
+            .on_rdb_end([&]() { loaded = true; });
+        if (!replica.connect())
+            throw std::runtime_error("Unable to connect the replica");
+        const auto end = steady_clock::now() + seconds(5);
+        while (!loaded && steady_clock::now() < end)
+            async::run(EVRUN_ONCE);
+        replica.stop();
+        return rdb;
+    }
+};
+
+/*
+ * PARSER TESTS
+ */
+
+const std::string crafted = craft::dump(
+    "\xFA" + craft::string("redis-ver") + craft::string("7.2.0") + "\xFE\x02" +
+    "\xFB\x06\x01" +
+    // String with an expiration, then LZF and integer strings
+    "\xFC" + std::string("\xE8\x03\0\0\0\0\0\0", 8) + '\x00' + craft::string("plain") +
+    craft::string("value") + '\x00' + craft::string("lzf") +
+    "\xC3\x05\x0A" + std::string("\x00" "a\xE0\x00\x00", 5) + '\x00' +
+    craft::string("int") + "\xC1\x39\x30" +
+    // Listpack hash and sorted set, intset, ziplist and quicklist lists
+    '\x10' + craft::string("hash") +
+    craft::string(craft::listpack({"f1", "v1", "f2", "7"})) + '\x11' +
+    craft::string("zset") + craft::string(craft::listpack({"m1", "1", "m2", "2"})) +
+    '\x0B' + craft::string("intset") +
+    craft::string(std::string("\x02\0\0\0\x02\0\0\0\x05\0\xFF\xFF", 12)) + '\x0A' +
+    craft::string("ziplist") + craft::string(craft::ziplist({"a", "3", "bc"})) + '\x12' +
+    craft::string("quicklist") + "\x02\x02" + craft::string(craft::listpack({"x", "1"})) +
+    "\x01" + craft::string("plain node"));
+
+// Test every value encoding of a complete dump
+TEST(RdbParser, PARSE) {
+    collector  visitor;
+    rdb_parser parser(visitor);
+    parser.parse(crafted);
+
+    EXPECT_TRUE(parser.done());
+    EXPECT_TRUE(visitor.ended);
+    EXPECT_EQ(visitor.version, 11);
+    EXPECT_EQ(visitor.aux["redis-ver"], "7.2.0");
+    EXPECT_EQ(visitor.expires["plain"], 1000);
+    EXPECT_EQ(visitor.expires.count("lzf"), 0u);
+    using list = std::vector<std::string>;
+    EXPECT_EQ(visitor.values["plain"], list{"value"});
+    EXPECT_EQ(visitor.values["lzf"], list{"aaaaaaaaaa"});
+    EXPECT_EQ(visitor.values["int"], list{"12345"});
+    EXPECT_EQ(visitor.values["hash"], (list{"f1=v1", "f2=7"}));
+    EXPECT_EQ(visitor.values["zset"], (list{"m1=1", "m2=2"}));
+    EXPECT_EQ(visitor.values["intset"], (list{"5", "-1"}));
+    EXPECT_EQ(visitor.values["ziplist"], (list{"a", "3", "bc"}));
+    EXPECT_EQ(visitor.values["quicklist"], (list{"x", "1", "plain node"}));
+    EXPECT_EQ(visitor.sizes["plain"], 1 + 6 + 6u);
+}
+
+// Test the dump received in chunks of every size
+TEST(RdbParser, FEED) {
+    for (std::size_t size = 1; size < 40; ++size) {
+        collector  visitor;
+        rdb_parser parser(visitor);
+        for (std::size_t i = 0; i < crafted.size(); i += size)
+            parser.feed(std::string_view(crafted).substr(i, size));
+        parser.finish();
+        EXPECT_EQ(visitor.values.size(), 8u);
+        EXPECT_EQ(visitor.values["quicklist"].size(), 3u);
+    }
+}
+
+// Test a value of several megabytes received in small chunks
+TEST(RdbParser, FEED_LARGE_VALUE) {
+    std::string list;
+    for (int i = 0; i < 200000; ++i)
+        list += craft::string("element:" + std::to_string(i));
+    const auto dump =
+        craft::dump('\x01' + craft::string("list") + craft::length(200000) + list);
+
+    collector  visitor;
+    rdb_parser parser(visitor);
+    for (std::size_t i = 0; i < dump.size(); i += 64)
+        parser.feed(std::string_view(dump).substr(i, 64));
+    parser.finish();
+    const auto &elements = visitor.values["list"];
+    ASSERT_EQ(elements.size(), 200000u);
+    EXPECT_EQ(elements.front(), "element:0");
+    EXPECT_EQ(elements.back(), "element:199999");
+    EXPECT_EQ(visitor.sizes["list"], 1 + 5 + 5 + list.size());
+}
+
+// Test skipped values and invalid dumps
+TEST(RdbParser, SKIP_AND_ERRORS) {
+    collector  visitor;
+    rdb_parser parser(visitor);
+    visitor.skip = {"hash", "lzf"};
+    parser.parse(crafted);
+    EXPECT_EQ(visitor.values.count("hash"), 0u);
+    EXPECT_EQ(visitor.values.count("lzf"), 0u);
+    EXPECT_GT(visitor.sizes["hash"], 0u);
+
+    collector truncated;
+    EXPECT_THROW(rdb_parser(truncated).parse(crafted.substr(0, crafted.size() - 20)),
+                 std::invalid_argument);
+    collector bad;
+    EXPECT_THROW(rdb_parser(bad).parse("RDB" + crafted), std::invalid_argument);
+}
+
+// Test a stream with its consumer groups
+TEST(RdbParser, STREAM) {
+    const std::string id = std::string("\0\0\0\0\0\0\x03\xE8", 8) + std::string(8, '\0');
+    const std::string pel(16 + 8, '\0');
+    // Master entry, then entries with the same fields, their own fields, deleted
+    const std::string lp = craft::listpack({"2", "1", "1", "k", "0",
+                                            "2", "0", "0", "v1", "4",
+                                            "0", "5", "1", "1", "x", "y", "7",
+                                            "3", "6", "0", "v3", "4"});
+    // Entries, last ID, first ID, max deleted ID, entries added
+    std::string body = '\x15' + craft::string("xs") + "\x01" + craft::string(id) +
+                       craft::string(lp);
+    for (std::size_t n : {2, 1006, 0, 1000, 0, 1006, 0, 3})
+        body += craft::length(n);
+    // Group with its last ID, entries read and pending entry, then one consumer
+    body += "\x01" + craft::string("g") + craft::length(1000) + craft::length(0) +
+            craft::length(2) + "\x01" + pel + "\x01" + "\x01" + craft::string("c") +
+            std::string(16, '\0') + "\x01" + std::string(16, '\0');
+
+    collector  visitor;
+    rdb_parser parser(visitor);
+    parser.parse(craft::dump(body));
+    EXPECT_EQ(visitor.values["xs"],
+              (std::vector<std::string>{"1000-0 k=v1", "1005-1 x=y", "group g 1000-0"}));
+}
+
+// Test the LZF decompression of back references
+TEST(RdbParser, LZF) {
+    std::string out;
+    lzf_decompress(std::string("\x02" "abc\x20\x02", 6), 6, out);
+    EXPECT_EQ(out, "abcabc");
+    EXPECT_THROW(lzf_decompress(std::string("\x20\x05", 2), 3, out),
+                 std::invalid_argument);
+}
+
+// Test files parsed in parallel
+TEST(RdbParser, PARSE_FILES) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 4; ++i) {
+        paths.push_back("qbm-redis-test-" + std::to_string(i) + ".rdb");
+        std::ofstream(paths.back(), std::ios::binary) << crafted;
+    }
+    std::vector<collector>     visitors(paths.size());
+    std::vector<rdb_visitor *> pointers;
+    for (auto &visitor : visitors)
+        pointers.push_back(&visitor);
+
+    rdb_parser::parse_files(paths, pointers, 2);
+    for (const auto &visitor : visitors)
+        EXPECT_TRUE(visitor.ended);
+    for (const auto &path : paths)
+        std::remove(path.c_str());
+}
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test the snapshot of a server, streamed from a full resynchronization
+TEST_F(RedisTest, SYNC_RDB_SNAPSHOT) {
+    const auto text  = test_key("text");
+    const auto large = test_key("large");
+    const auto list  = test_key("list");
+    const auto hash  = test_key("hash");
+    const auto zset  = test_key("zset");
+    const auto set   = test_key("set");
+    const auto xs    = test_key("stream");
+    EXPECT_TRUE(redis.set(text, "hello"));
+    EXPECT_TRUE(redis.set(large, std::string(1000, 'z')));
+    EXPECT_TRUE(redis.pexpire(text, 60000));
+    EXPECT_EQ(redis.rpush(list, "a", "b", "1000"), 3);
+    EXPECT_EQ(redis.hset(hash, "f", "v"), 1);
+    EXPECT_EQ(redis.zadd(zset, std::vector<score_member>{{1, "one"}, {2, "two"}}), 2);
+    EXPECT_EQ(redis.sadd(set, "1", "2", "3"), 3);
+    const auto id = redis.xadd(xs, {{"k", "v"}});
+    EXPECT_TRUE(redis.xgroup_create(xs, "readers", "0"));
+
+    collector  visitor;
+    rdb_parser parser(visitor);
+    for (char c : snapshot())
+        parser.feed(std::string_view(&c, 1));
+    parser.finish();
+
+    using values = std::vector<std::string>;
+    EXPECT_EQ(visitor.values[text], values{"hello"});
+    EXPECT_GT(visitor.expires[text], 0);
+    EXPECT_EQ(visitor.values[large], values{std::string(1000, 'z')});
+    EXPECT_EQ(visitor.values[list], (values{"a", "b", "1000"}));
+    EXPECT_EQ(visitor.values[hash], values{"f=v"});
+    EXPECT_EQ(visitor.values[zset], (values{"one=1", "two=2"}));
+    EXPECT_EQ(visitor.values[set].size(), 3u);
+    EXPECT_EQ(visitor.values[xs], (values{id.to_string() + " k=v", "group readers 0-0"}));
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,254 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include "../redis.h"
+#include "../replay.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::replay-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return key_prefix() + ":" + k;
+}
+
+// Encodes a command as written in an AOF file
+inline std::string
+encode(const std::vector<std::string> &args) {
+    std::string out = "*" + std::to_string(args.size()) + "\r\n";
+    for (const auto &arg : args)
+        out += "$" + std::to_string(arg.size()) + "\r\n" + arg + "\r\n";
+    return out;
+}
+
+using replayer_type = qb::redis::replayer<qb::io::transport::tcp>;
+
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * RESP SCANNER TESTS
+ */
+
+// Test replies are delimited, whatever the number of bytes received
+TEST(RespScanner, REPLY_SIZE) {
+    const std::vector<std::string> replies = {
+        "+OK\r\n",
+        "-ERR wrong\r\n",
+        ":42\r\n",
+        "$5\r\nhello\r\n",
+        "$0\r\n\r\n",
+        "$-1\r\n",
+        "*-1\r\n",
+        "*0\r\n",
+        "*2\r\n$1\r\na\r\n*2\r\n:1\r\n$-1\r\n",
+        "%2\r\n+a\r\n:1\r\n+b\r\n*1\r\n_\r\n",
+        "~2\r\n,1.5\r\n#t\r\n",
+        "|1\r\n+ttl\r\n:3\r\n=8\r\ntxt:abcd\r\n",
+        ">2\r\n+message\r\n(12345678901234567890\r\n",
+        "!3\r\nERR\r\n",
+        "$4\r\n\r\n\r\n\r\n"};
+    for (const auto &reply : replies) {
+        EXPECT_EQ(resp_reply_size(reply + "+NEXT\r\n"), reply.size()) << reply;
+        for (std::size_t i = 0; i < reply.size(); ++i)
+            EXPECT_EQ(resp_reply_size(reply.substr(0, i)), 0u) << reply << " " << i;
+    }
+
+    EXPECT_THROW(resp_reply_size("?\r\n"), std::invalid_argument);
+    EXPECT_THROW(resp_reply_size("$x\r\n"), std::invalid_argument);
+    EXPECT_THROW(resp_reply_size("$1\r\nabc\r\n"), std::invalid_argument);
+    EXPECT_THROW(resp_reply_size("%-1\r\n"), std::invalid_argument);
+    EXPECT_THROW(resp_reply_size("|-2\r\n+OK\r\n"), std::invalid_argument);
+}
+
+// Test commands are located with their name and key
+TEST(RespScanner, COMMAND_SIZE) {
+    const auto   set  = encode({"SET", "key", "value"});
+    const auto   data = set + encode({"PING"});
+    resp_command cmd;
+    EXPECT_EQ(resp_command_size(data, cmd), set.size());
+    EXPECT_EQ(cmd.raw, set);
+    EXPECT_EQ(cmd.name, "SET");
+    EXPECT_EQ(cmd.key, "key");
+    EXPECT_EQ(cmd.argc, 3u);
+
+    const auto ping = encode({"PING"});
+    EXPECT_EQ(resp_command_size(ping, cmd), 14u);
+    EXPECT_EQ(cmd.name, "PING");
+    EXPECT_TRUE(cmd.key.empty());
+
+    for (std::size_t i = 0; i < set.size(); ++i)
+        EXPECT_EQ(resp_command_size(set.substr(0, i), cmd), 0u) << i;
+    EXPECT_THROW(resp_command_size("+OK\r\n", cmd), std::invalid_argument);
+    EXPECT_THROW(resp_command_size("*1\r\n:1\r\n", cmd), std::invalid_argument);
+    EXPECT_THROW(resp_command_size("*0\r\n", cmd), std::invalid_argument);
+}
+
+// Test the percentiles of the latency histogram
+TEST(LatencyHistogram, PERCENTILES) {
+    latency_histogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0u);
+    for (std::uint64_t us = 1; us <= 10000; ++us)
+        histogram.record(us);
+    EXPECT_EQ(histogram.count(), 10000u);
+    EXPECT_EQ(histogram.min(), 1u);
+    EXPECT_EQ(histogram.max(), 10000u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 5000.5);
+    for (const double p : {1., 10., 50., 90., 99., 99.9}) {
+        const auto expected = p * 100;
+        EXPECT_GE(histogram.percentile(p), expected) << p;
+        EXPECT_LE(histogram.percentile(p), expected * 1.125) << p;
+    }
+    EXPECT_EQ(histogram.percentile(100), 10000u);
+
+    latency_histogram other;
+    other.record(0);
+    other.record(std::uint64_t(1) << 40);
+    histogram.merge(other);
+    EXPECT_EQ(histogram.count(), 10002u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.max(), std::uint64_t(1) << 40);
+}
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test an AOF is replayed over several connections
+TEST_F(RedisTest, SYNC_REPLAY) {
+    const auto counter = test_key("counter");
+    const auto tx      = test_key("tx");
+    std::string aof    = encode({"SELECT", "0"});
+    for (int i = 0; i < 1000; ++i)
+        aof += encode({"INCR", counter});
+    aof += encode({"SUBSCRIBE", "channel"});
+    aof += encode({"MULTI"}) + encode({"SET", tx, "a"}) + encode({"APPEND", tx, "b"}) +
+           encode({"EXEC"});
+    aof += encode({"LPUSH", counter, "x"});
+    aof += "*2\r\n$3\r\nGET";
+
+    replayer_type replayer{REDIS_URI, {4, true, 0, 16}};
+    const auto    report = replayer.replay(aof);
+    ASSERT_TRUE(report.ok()) << report.error;
+    EXPECT_EQ(redis.get(counter), "1000");
+    EXPECT_EQ(redis.get(tx), "ab");
+
+    EXPECT_EQ(report.commands.at("SELECT").latency.count(), 4u);
+    EXPECT_EQ(report.commands.at("INCR").latency.count(), 1000u);
+    EXPECT_EQ(report.commands.at("INCR").errors, 0u);
+    EXPECT_EQ(report.commands.at("EXEC").latency.count(), 1u);
+    EXPECT_EQ(report.commands.at("LPUSH").errors, 1u);
+    EXPECT_EQ(report.commands.count("SUBSCRIBE"), 0u);
+    EXPECT_EQ(report.total.latency.count(), 1009u);
+    EXPECT_EQ(report.total.errors, 1u);
+    EXPECT_EQ(report.skipped, 1u);
+    EXPECT_EQ(report.truncated, 11u);
+    EXPECT_GT(report.throughput(), 0.);
+}
+
+// Test a file is replayed and errors are reported
+TEST_F(RedisTest, SYNC_REPLAY_FILE) {
+    const auto  key  = test_key("key");
+    const auto  path = std::string("qbm-redis-test.aof");
+    std::ofstream(path, std::ios::binary) << encode({"SET", key, "value"});
+    replayer_type replayer{REDIS_URI};
+    const auto    report = replayer.replay_file(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(report.ok()) << report.error;
+    EXPECT_EQ(redis.get(key), "value");
+
+    EXPECT_THROW(replayer.replay_file("qbm-redis-missing.aof"), std::runtime_error);
+    EXPECT_THROW(replayer.replay("REDIS0011"), std::invalid_argument);
+    EXPECT_FALSE(replayer.replay("+OK\r\n").ok());
+    EXPECT_FALSE(replayer_type("tcp://localhost:1").replay(encode({"PING"})).ok());
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the original timing is replayed at the requested speed
+TEST_F(RedisTest, ASYNC_REPLAY_TIMED) {
+    const auto key = test_key("key");
+    const auto aof = "#TS:1000\r\n" + encode({"SET", key, "a"}) + "#TS:1001\r\n" +
+                     encode({"APPEND", key, "b"});
+
+    bool          done = false;
+    replay_report result;
+    replayer_type replayer{REDIS_URI, {1, false, 4, 256}};
+    replayer.replay(aof, [&](replay_report &&report) {
+        result = std::move(report);
+        done   = true;
+    });
+    EXPECT_TRUE(replayer.running());
+    const auto end = steady_clock::now() + seconds(5);
+    while (!done && steady_clock::now() < end)
+        async::run(EVRUN_ONCE);
+    ASSERT_TRUE(done);
+    ASSERT_TRUE(result.ok()) << result.error;
+    EXPECT_GE(result.elapsed, milliseconds(240));
+    EXPECT_EQ(redis.get(key), "ab");
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,293 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include "../replication.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using replica_type = qb::redis::replica<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::replication-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return key_prefix() + ":" + k;
+}
+
+// Records what the parser reports
+struct recorder {
+    std::string                    replid;
+    long long                      offset    = -1;
+    bool                           continued = false;
+    bool                           loaded    = false;
+    std::string                    rdb;
+    std::size_t                    chunks = 0;
+    std::vector<replication_event> events;
+    std::string                    error;
+
+    void
+    on_fullresync(std::string_view id, long long off) {
+        replid = std::string(id);
+        offset = off;
+    }
+
+    void
+    on_continue(std::string_view id) {
+        replid    = std::string(id);
+        continued = true;
+    }
+
+    void
+    on_rdb(std::string_view chunk) {
+        rdb.append(chunk);
+        ++chunks;
+    }
+
+    void
+    on_rdb_end() {
+        loaded = true;
+    }
+
+    void
+    on_command(replication_event &&event) {
+        events.push_back(std::move(event));
+    }
+
+    void
+    on_error(std::string_view e) {
+        error = std::string(e);
+    }
+};
+
+// Feeds the stream one byte at a time
+inline void
+feed_bytes(replication_parser &parser, const std::string &stream, recorder &handler) {
+    for (char c : stream)
+        parser.feed(&c, 1, handler);
+}
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+
+    template <typename Predicate>
+    bool
+    run_until(Predicate &&done, milliseconds timeout = milliseconds(5000)) {
+        const auto end = steady_clock::now() + timeout;
+        while (!done() && steady_clock::now() < end)
+            async::run(EVRUN_ONCE);
+        return done();
+    }
+};
+
+/*
+ * PARSER TESTS
+ */
+
+const std::string replid(40, 'a');
+const std::string commands = "*2\r\n$6\r\nSELECT\r\n$1\r\n3\r\n"
+                             "*3\r\n$3\r\nSET\r\n$1\r\nk\r\n$2\r\nv1\r\n";
+
+// Test a full resynchronization with a sized payload
+TEST(ReplicationParser, FULLRESYNC_SIZED) {
+    replication_parser parser;
+    recorder           handler;
+    const std::string  stream =
+        "+OK\r\n+FULLRESYNC " + replid + " 100\r\n\n\n$5\r\nREDIS" + commands;
+    parser.feed(stream.data(), stream.size(), handler);
+
+    EXPECT_EQ(handler.replid, replid);
+    EXPECT_EQ(handler.offset, 100);
+    EXPECT_TRUE(handler.loaded);
+    EXPECT_EQ(handler.rdb, "REDIS");
+    ASSERT_EQ(handler.events.size(), 2u);
+    EXPECT_TRUE(handler.events[0].is("select"));
+    EXPECT_EQ(handler.events[1].name(), "SET");
+    EXPECT_EQ(handler.events[1].db, 3);
+    EXPECT_EQ(handler.events[1].args[2], "v1");
+    EXPECT_EQ(handler.events[1].offset, 100 + static_cast<long long>(commands.size()));
+    EXPECT_EQ(parser.offset(), handler.events[1].offset);
+    EXPECT_TRUE(parser.streaming());
+}
+
+// Test a diskless payload delimited by an EOF mark, received byte by byte
+TEST(ReplicationParser, FULLRESYNC_EOF_MARK) {
+    replication_parser parser;
+    recorder           handler;
+    const std::string  mark    = "0123456789abcdef0123456789abcdef01234567";
+    const std::string  payload = "REDIS0011" + std::string(100, 'x') + "01234z";
+    feed_bytes(parser,
+               "+FULLRESYNC " + replid + " 7\r\n$EOF:" + mark + "\r\n" + payload + mark +
+                   commands,
+               handler);
+
+    EXPECT_TRUE(handler.loaded);
+    EXPECT_EQ(handler.rdb, payload);
+    ASSERT_EQ(handler.events.size(), 2u);
+    EXPECT_EQ(parser.offset(), 7 + static_cast<long long>(commands.size()));
+}
+
+// Test the payload is passed as it arrives, not buffered
+TEST(ReplicationParser, RDB_STREAMED) {
+    replication_parser parser;
+    recorder           handler;
+    const std::string  header = "+FULLRESYNC " + replid + " 0\r\n$1000\r\n";
+    parser.feed(header.data(), header.size(), handler);
+    const std::string chunk(100, 'r');
+    for (int i = 0; i < 10; ++i) {
+        parser.feed(chunk.data(), chunk.size(), handler);
+        EXPECT_EQ(handler.rdb.size(), static_cast<std::size_t>(i + 1) * 100);
+    }
+    EXPECT_EQ(handler.chunks, 10u);
+    EXPECT_TRUE(handler.loaded);
+}
+
+// Test a partial resynchronization
+TEST(ReplicationParser, CONTINUE) {
+    replication_parser parser;
+    recorder           handler;
+    parser.reset(500);
+    feed_bytes(parser, "+CONTINUE " + replid + "\r\n" + commands, handler);
+
+    EXPECT_TRUE(handler.continued);
+    EXPECT_EQ(handler.replid, replid);
+    EXPECT_FALSE(handler.loaded);
+    ASSERT_EQ(handler.events.size(), 2u);
+    EXPECT_EQ(parser.offset(), 500 + static_cast<long long>(commands.size()));
+}
+
+// Test a refused synchronization
+TEST(ReplicationParser, ERROR) {
+    replication_parser parser;
+    recorder           handler;
+    const std::string  stream = "-NOMASTERLINK Can't SYNC while not connected\r\n";
+    parser.feed(stream.data(), stream.size(), handler);
+
+    EXPECT_TRUE(parser.failed());
+    EXPECT_EQ(handler.error.rfind("NOMASTERLINK", 0), 0u);
+}
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test the writes of a client are received after the snapshot
+TEST_F(RedisTest, SYNC_REPLICATION_EVENTS) {
+    std::string key = test_key("key");
+    EXPECT_TRUE(redis.set(key, "before"));
+
+    std::size_t                    rdb_size = 0;
+    bool                           loaded   = false;
+    std::vector<replication_event> events;
+    replica_type                   replica{REDIS_URI};
+    replica.on_rdb([&](auto chunk) { rdb_size += chunk.size(); })
+        .on_rdb_end([&]() { loaded = true; })
+        .on_event([&](auto &&event) { events.push_back(std::move(event)); });
+    ASSERT_TRUE(replica.connect());
+    ASSERT_TRUE(run_until([&]() { return loaded; }));
+    EXPECT_GT(rdb_size, 0u);
+    EXPECT_NE(replica.replication_id(), "?");
+
+    EXPECT_TRUE(redis.set(key, "after"));
+    ASSERT_TRUE(run_until([&]() { return !events.empty(); }));
+    EXPECT_TRUE(events.back().is("SET"));
+    EXPECT_EQ(events.back().args[1], key);
+    EXPECT_EQ(events.back().offset, replica.offset());
+    replica.stop();
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the replication resumes from the last offset
+TEST_F(RedisTest, ASYNC_REPLICATION_RESUME) {
+    std::string  key    = test_key("counter");
+    bool         loaded = false;
+    replica_type first{REDIS_URI};
+    first.on_rdb_end([&]() { loaded = true; });
+    first.connect([](bool connected) { EXPECT_TRUE(connected); });
+    ASSERT_TRUE(run_until([&]() { return loaded; }));
+
+    // The writes below happen while no replica is connected
+    const auto replid = first.replication_id();
+    const auto offset = first.offset();
+    first.stop();
+    EXPECT_EQ(redis.incr(key), 1);
+    EXPECT_EQ(redis.incr(key), 2);
+
+    bool                           continued = false;
+    std::vector<replication_event> events;
+    replica_type                   second{REDIS_URI};
+    second.resume_from(replid, offset)
+        .on_continue([&](auto, auto) { continued = true; })
+        .on_event([&](auto &&event) {
+            if (event.is("INCR"))
+                events.push_back(std::move(event));
+        });
+    second.connect([](bool connected) { EXPECT_TRUE(connected); });
+    ASSERT_TRUE(run_until([&]() { return events.size() == 2; }));
+    EXPECT_TRUE(continued);
+    EXPECT_EQ(events[1].args[1], key);
+    EXPECT_EQ(second.offset(), events[1].offset);
+    second.stop();
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -190,6 +190,72 @@ TEST_F(RedisTest, SYNC_SCRIPTING_COMMANDS_KILL) {
     // We don't assert the result as it depends on the Redis server state
 }
 
+// Test script object digest matches SCRIPT LOAD
+TEST_F(RedisTest, SYNC_SCRIPTING_COMMANDS_SCRIPT_SHA1) {
+    qb::redis::script script{"return redis.call('GET', KEYS[1])"};
+
+    EXPECT_EQ(script.sha1().size(), 40);
+    EXPECT_EQ(script.sha1(), redis.script_load(script.source()));
+}
+
+// Test EVALSHA with a script object falls back to EVAL on NOSCRIPT
+TEST_F(RedisTest, SYNC_SCRIPTING_COMMANDS_SCRIPT_NOSCRIPT_FALLBACK) {
+    std::string        key = test_key("script_fallback");
+    qb::redis::script script{"return redis.call('SET', KEYS[1], ARGV[1])"};
+
+    redis.script_flush();
+    auto exists = redis.script_exists(script.sha1());
+    EXPECT_FALSE(exists[0]);
+
+    // First call misses the cache and is retried with EVAL
+    auto result = redis.evalsha<std::string>(script, {key}, {"value"});
+    EXPECT_EQ(result, "OK");
+    EXPECT_EQ(*redis.get(key), "value");
+
+    // EVAL cached the script, the next call is served by EVALSHA
+    exists = redis.script_exists(script.sha1());
+    EXPECT_TRUE(exists[0]);
+    result = redis.evalsha<std::string>(script, {key}, {"value2"});
+    EXPECT_EQ(result, "OK");
+    EXPECT_EQ(*redis.get(key), "value2");
+}
+
+// Test registered scripts are loaded during the connection handshake
+TEST_F(RedisTest, SYNC_SCRIPTING_COMMANDS_REGISTER_SCRIPT) {
+    qb::redis::tcp::client client{REDIS_URI};
+    auto script = client.register_script("return tonumber(ARGV[1]) * 2");
+    EXPECT_EQ(client.registered_scripts().size(), 1);
+
+    // Registering the same source twice keeps a single entry
+    client.register_script(script.source());
+    EXPECT_EQ(client.registered_scripts().size(), 1);
+
+    redis.script_flush();
+    ASSERT_TRUE(client.connect());
+    client.await();
+
+    auto exists = client.script_exists(script.sha1());
+    EXPECT_TRUE(exists[0]);
+    EXPECT_EQ(client.evalsha<long long>(script, {}, {"21"}), 42);
+}
+
+// Test a script registered on a connected client is loaded at once
+TEST_F(RedisTest, SYNC_SCRIPTING_COMMANDS_REGISTER_SCRIPT_CONNECTED) {
+    redis.script_flush();
+    auto script = redis.register_script("return tonumber(ARGV[1]) + 1");
+
+    auto exists = redis.script_exists(script.sha1());
+    EXPECT_TRUE(exists[0]);
+    EXPECT_EQ(redis.evalsha<long long>(script, {}, {"41"}), 42);
+}
+
+// Test EVALSHA with a script object reports script errors
+TEST_F(RedisTest, SYNC_SCRIPTING_COMMANDS_SCRIPT_ERROR) {
+    qb::redis::script script{"error('This is a test error')"};
+
+    EXPECT_THROW(redis.evalsha<std::string>(script), std::runtime_error);
+}
+
 /*
  * ASYNCHRONOUS TESTS
  */
@@ -417,6 +483,29 @@ TEST_F(RedisTest, ASYNC_SCRIPTING_COMMANDS_LOAD) {
     EXPECT_TRUE(exists[0]);
 }
 
+// Test async EVALSHA with a script object and NOSCRIPT fallback
+TEST_F(RedisTest, ASYNC_SCRIPTING_COMMANDS_SCRIPT_NOSCRIPT_FALLBACK) {
+    std::string        key       = test_key("async_script_fallback");
+    qb::redis::script script{"return redis.call('INCR', KEYS[1])"};
+    int                completed = 0;
+
+    redis.script_flush();
+
+    // Both calls are pipelined, the first one misses the script cache
+    for (int i = 0; i < 2; ++i) {
+        redis.evalsha<long long>(
+            [&](auto &&reply) {
+                EXPECT_TRUE(reply.ok());
+                ++completed;
+            },
+            script, {key});
+    }
+
+    redis.await();
+    EXPECT_EQ(completed, 2);
+    EXPECT_EQ(*redis.get(key), "2");
+}
+
 // Test script with complex operations
 TEST_F(RedisTest, SYNC_SCRIPTING_COMMANDS_COMPLEX) {
     std::string key1   = test_key("complex1");
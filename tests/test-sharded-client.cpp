@@ -0,0 +1,250 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include "../sharded_client.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using sharded_type = qb::redis::sharded_client<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::sharded-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return key_prefix() + ":" + k;
+}
+
+// Checks connection and cleans environment before tests
+// The shards are logical databases of the same server
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+    qb::redis::tcp::client db1{REDIS_URI};
+    qb::redis::tcp::client db2{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+        if (!db1.connect() || !db1.select(1) || !db2.connect() || !db2.select(2))
+            throw std::runtime_error("Unable to select the shard databases");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test that each key lives on the node it maps to
+TEST_F(RedisTest, SYNC_SHARDED_CLIENT_ROUTING) {
+    sharded_type sharded{{{"db0", &redis}, {"db1", &db1}}};
+
+    std::size_t on_first = 0;
+    for (int i = 0; i < 100; ++i) {
+        const auto key = test_key(std::to_string(i));
+        sharded.set(key, std::to_string(i));
+        auto &owner = sharded.client_of(key);
+        auto &other = &owner == &redis ? db1 : redis;
+        EXPECT_EQ(owner.get(key), std::to_string(i));
+        EXPECT_FALSE(other.exists(key));
+        EXPECT_EQ(sharded.get(key), std::to_string(i));
+        on_first += &owner == &redis;
+    }
+    EXPECT_GT(on_first, 20u);
+    EXPECT_LT(on_first, 80u);
+}
+
+// Test that keys sharing a hash tag share a node
+TEST_F(RedisTest, SYNC_SHARDED_CLIENT_HASH_TAGS) {
+    sharded_type sharded{{{"db0", &redis}, {"db1", &db1}, {"db2", &db2}}};
+
+    for (int i = 0; i < 20; ++i) {
+        const auto tag = "{user:" + std::to_string(i) + "}";
+        EXPECT_EQ(sharded.name_of(tag + ":profile"), sharded.name_of(tag + ":orders"));
+    }
+
+    sharded.set("{user:1}:a", "v");
+    sharded.rename("{user:1}:a", "{user:1}:b");
+    EXPECT_EQ(sharded.get("{user:1}:b"), "v");
+}
+
+// Test the commands split over the nodes
+TEST_F(RedisTest, SYNC_SHARDED_CLIENT_MULTI_KEY) {
+    sharded_type sharded{{{"db0", &redis}, {"db1", &db1}, {"db2", &db2}}};
+
+    std::vector<std::string>                         keys;
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for (int i = 0; i < 30; ++i) {
+        keys.push_back(test_key(std::to_string(i)));
+        pairs.emplace_back(keys.back(), std::to_string(i));
+    }
+    EXPECT_TRUE(sharded.mset(pairs));
+
+    auto values = sharded.mget(keys);
+    ASSERT_EQ(values.size(), keys.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(values[i], std::to_string(i));
+
+    EXPECT_EQ(sharded.keys("*").size(), 30u);
+    EXPECT_EQ(sharded.exists(keys[0], keys[1], keys[2]), 3);
+    EXPECT_EQ(sharded.del(keys), 30);
+    EXPECT_EQ(sharded.exists(keys), 0);
+}
+
+// Test that commands on keys of several nodes are merged or refused
+TEST_F(RedisTest, SYNC_SHARDED_CLIENT_CROSS_NODE) {
+    sharded_type sharded{{{"db0", &redis}, {"db1", &db1}}};
+
+    const auto  a = test_key("a");
+    std::string b;
+    for (int i = 0; b.empty(); ++i) {
+        const auto key = test_key("b" + std::to_string(i));
+        if (sharded.name_of(key) != sharded.name_of(a))
+            b = key;
+    }
+    sharded.sadd(a, "1", "2", "3");
+    sharded.sadd(b, "2", "3", "4");
+
+    auto inter = sharded.sinter({a, b});
+    std::sort(inter.begin(), inter.end());
+    EXPECT_EQ(inter, (std::vector<std::string>{"2", "3"}));
+    auto all = sharded.sunion({a, b});
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(all, (std::vector<std::string>{"1", "2", "3", "4"}));
+
+    EXPECT_THROW(sharded.smove(a, b, "1"), std::runtime_error);
+    EXPECT_THROW(sharded.rename(a, b), std::runtime_error);
+    EXPECT_THROW(sharded.sinterstore(test_key("dest"), {a, b}), std::runtime_error);
+    EXPECT_TRUE(sharded.sismember(a, "1"));
+
+    sharded_type empty;
+    EXPECT_THROW(empty.command<std::optional<std::string>>("RANDOMKEY"),
+                 std::logic_error);
+}
+
+// Test that adding a node only moves keys to that node
+TEST_F(RedisTest, SYNC_SHARDED_CLIENT_REMAPPING) {
+    for (auto algorithm : {ShardingAlgorithm::KETAMA, ShardingAlgorithm::JUMP}) {
+        sharded_type::options opts;
+        opts.algorithm = algorithm;
+        sharded_type sharded{{{"db0", &redis}, {"db1", &db1}}, opts};
+
+        std::vector<std::string> before;
+        for (int i = 0; i < 1000; ++i)
+            before.push_back(sharded.name_of(std::to_string(i)));
+
+        sharded.add_node(db2, "db2");
+        std::size_t moved = 0;
+        for (int i = 0; i < 1000; ++i) {
+            const auto &after = sharded.name_of(std::to_string(i));
+            if (after != before[i]) {
+                EXPECT_EQ(after, "db2");
+                ++moved;
+            }
+        }
+        EXPECT_GT(moved, 200u);
+        EXPECT_LT(moved, 450u);
+
+        // Removing it maps the keys back
+        EXPECT_TRUE(sharded.remove_node("db2"));
+        for (int i = 0; i < 1000; ++i)
+            EXPECT_EQ(sharded.name_of(std::to_string(i)), before[i]);
+    }
+}
+
+// Test the share of keys of weighted nodes
+TEST_F(RedisTest, SYNC_SHARDED_CLIENT_WEIGHTS) {
+    for (auto algorithm : {ShardingAlgorithm::KETAMA, ShardingAlgorithm::JUMP}) {
+        sharded_type::options opts;
+        opts.algorithm = algorithm;
+        sharded_type sharded{opts};
+        sharded.add_node(redis, "db0", 3).add_node(db1, "db1", 1);
+
+        std::size_t heavy = 0;
+        for (int i = 0; i < 4000; ++i)
+            heavy += sharded.name_of(std::to_string(i)) == "db0";
+        EXPECT_GT(heavy, 2600u);
+        EXPECT_LT(heavy, 3400u);
+    }
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the asynchronous routed and split commands
+TEST_F(RedisTest, ASYNC_SHARDED_CLIENT_COMMANDS) {
+    sharded_type sharded{{{"db0", &redis}, {"db1", &db1}}};
+
+    const auto                              a       = test_key("a");
+    const auto                              b       = test_key("b");
+    long long                               counter = 0;
+    long long                               deleted = 0;
+    std::vector<std::optional<std::string>> values;
+
+    sharded.incr([&](auto &&reply) { counter = reply.result(); }, a)
+        .set([](auto &&reply) { EXPECT_TRUE(reply.ok()); }, b, "v")
+        .mget([&](auto &&reply) { values = std::move(reply.result()); },
+              std::vector<std::string>{a, b, test_key("missing")})
+        .del([&](auto &&reply) { deleted = reply.result(); }, a, b);
+    sharded.await();
+
+    EXPECT_EQ(counter, 1);
+    ASSERT_EQ(values.size(), 3u);
+    EXPECT_EQ(values[0], "1");
+    EXPECT_EQ(values[1], "v");
+    EXPECT_FALSE(values[2].has_value());
+    EXPECT_EQ(deleted, 2);
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
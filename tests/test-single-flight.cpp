@@ -0,0 +1,161 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include "../single_flight.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using flight_type = qb::redis::single_flight<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::single-flight-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return "{" + key_prefix() + "}::" + k;
+}
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test the synchronous reads
+TEST_F(RedisTest, SYNC_SINGLE_FLIGHT_READS) {
+    std::string key  = test_key("key");
+    std::string hash = test_key("hash");
+    flight_type flight{redis};
+
+    redis.set(key, "value");
+    redis.hset(hash, "field", "v");
+    EXPECT_EQ(flight.get(key), "value");
+    EXPECT_EQ(flight.hget(hash, "field"), "v");
+    EXPECT_EQ(flight.hgetall(hash).size(), 1u);
+    EXPECT_EQ(flight.command<long long>("STRLEN", key), 5);
+    EXPECT_EQ(flight.sent(), 4u);
+    EXPECT_EQ(flight.in_flight(), 0u);
+
+    EXPECT_THROW(flight.get(hash), std::runtime_error);
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test identical concurrent reads sharing one round trip
+TEST_F(RedisTest, ASYNC_SINGLE_FLIGHT_DEDUPLICATION) {
+    std::string key   = test_key("key");
+    std::string other = test_key("other");
+    flight_type flight{redis};
+    int         received = 0;
+
+    redis.set(key, "value");
+    redis.set(other, "other");
+    for (int i = 0; i < 100; ++i) {
+        flight.get(
+            [&](auto &&reply) {
+                EXPECT_TRUE(reply.ok());
+                EXPECT_EQ(reply.result(), "value");
+                ++received;
+            },
+            key);
+    }
+    // Different arguments or result types are not shared
+    flight.get([&](auto &&reply) { EXPECT_EQ(reply.result(), "other"); }, other);
+    flight.command<std::string>([&](auto &&reply) { EXPECT_EQ(reply.result(), "value"); },
+                                "GET", key);
+    EXPECT_EQ(flight.in_flight(), 3u);
+
+    redis.await();
+    EXPECT_EQ(received, 100);
+    EXPECT_EQ(flight.sent(), 3u);
+    EXPECT_EQ(flight.shared(), 99u);
+    EXPECT_EQ(flight.in_flight(), 0u);
+
+    // A landed flight is not reused
+    flight.get([&](auto &&) { ++received; }, key);
+    redis.await();
+    EXPECT_EQ(flight.sent(), 4u);
+}
+
+// Test errors shared by all the waiters
+TEST_F(RedisTest, ASYNC_SINGLE_FLIGHT_ERROR) {
+    std::string hash = test_key("hash");
+    flight_type flight{redis};
+    int         failed = 0;
+
+    redis.hset(hash, "field", "v");
+    for (int i = 0; i < 3; ++i) {
+        flight.get(
+            [&](auto &&reply) {
+                EXPECT_FALSE(reply.ok());
+                EXPECT_NE(reply.error().find("WRONGTYPE"), std::string_view::npos);
+                ++failed;
+            },
+            hash);
+    }
+    redis.await();
+    EXPECT_EQ(failed, 3);
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -640,6 +640,114 @@ TEST_F(RedisTest, SYNC_SORTED_SET_COMMANDS_ZLEXCOUNT) {
               3);
 }
 
+// Test ZADD from parallel arrays and structure-of-arrays results
+TEST_F(RedisTest, SYNC_SORTED_SET_COMMANDS_SOA) {
+    std::string key = test_key("soa");
+
+    std::vector<double>        scores  = {0.1, 2.5, 1e-9, 123456789.125, -3.75};
+    std::array<std::string, 5> members = {"a", "b", "c", "d", "e"};
+    EXPECT_EQ(redis.zadd(key, scores, members), 5);
+
+    // Scores keep their full precision
+    EXPECT_EQ(redis.zscore(key, "c"), 1e-9);
+    EXPECT_EQ(redis.zscore(key, "d"), 123456789.125);
+
+    // ZADD options apply to the whole batch
+    const double      update[] = {10.0, 20.0};
+    const char *const names[]  = {"a", "f"};
+    EXPECT_EQ(redis.zadd(key, update, names, qb::redis::UpdateType::EXIST, true), 1);
+    EXPECT_EQ(redis.zcard(key), 5);
+    EXPECT_THROW(redis.zadd(key, update, members), std::invalid_argument);
+
+    auto range = redis.zrange_list(key, 0, -1);
+    ASSERT_EQ(range.size(), 5);
+    EXPECT_EQ(range.members[0], "e");
+    EXPECT_EQ(range.scores[0], -3.75);
+    EXPECT_EQ(range.members[3], "a");
+    EXPECT_EQ(range.scores[3], 10.0);
+    EXPECT_EQ(range.members[4], "d");
+
+    // Copies keep valid member views
+    auto copy = range;
+    range     = {};
+    EXPECT_EQ(copy.members[1], "c");
+    EXPECT_EQ(copy.at(4).member, "d");
+
+    auto revrange = redis.zrevrange_list(key, 0, 1);
+    ASSERT_EQ(revrange.size(), 2);
+    EXPECT_EQ(revrange.members[0], "d");
+    EXPECT_EQ(revrange.members[1], "a");
+
+    auto byscore = redis.zrangebyscore_list(
+        key, qb::redis::BoundedInterval<double>(0.0, 3.0, qb::redis::BoundType::CLOSED));
+    ASSERT_EQ(byscore.size(), 2);
+    EXPECT_EQ(byscore.members[0], "c");
+    EXPECT_EQ(byscore.scores[1], 2.5);
+
+    auto revbyscore = redis.zrevrangebyscore_list(
+        key, qb::redis::BoundedInterval<double>(0.0, 3.0, qb::redis::BoundType::CLOSED));
+    ASSERT_EQ(revbyscore.size(), 2);
+    EXPECT_EQ(revbyscore.members[0], "b");
+
+    auto popmin = redis.zpopmin_list(key, 2);
+    ASSERT_EQ(popmin.size(), 2);
+    EXPECT_EQ(popmin.members[0], "e");
+    EXPECT_EQ(popmin.members[1], "c");
+
+    auto popmax = redis.zpopmax_list(key);
+    ASSERT_EQ(popmax.size(), 1);
+    EXPECT_EQ(popmax.members[0], "d");
+    EXPECT_EQ(popmax.scores[0], 123456789.125);
+    EXPECT_EQ(redis.zcard(key), 2);
+
+    EXPECT_TRUE(redis.zrange_list(test_key("soa_missing"), 0, -1).empty());
+}
+
+// Test ZMSCORE/ZMPOP/BZMPOP/ZRANGESTORE
+TEST_F(RedisTest, SYNC_SORTED_SET_COMMANDS_MULTI_ELEMENT) {
+    std::string key   = test_key("multi");
+    std::string empty = test_key("multi_empty");
+    std::string dest  = test_key("multi_dest");
+
+    redis.zadd(key, {{1.0, "a"}, {2.0, "b"}, {3.0, "c"}, {4.0, "d"}, {5.0, "e"}});
+
+    auto scores = redis.zmscore(key, "a", std::vector<std::string>{"x", "e"});
+    ASSERT_EQ(scores.size(), 3);
+    EXPECT_EQ(scores[0], 1.0);
+    EXPECT_FALSE(scores[1].has_value());
+    EXPECT_EQ(scores[2], 5.0);
+
+    EXPECT_EQ(redis.zrangestore(dest, key, 0, 1), 2);
+    EXPECT_EQ(redis.zrange(dest, 0, -1)[1].member, "b");
+    EXPECT_EQ(redis.zrangestore(dest, key, 0, 1, true), 2);
+    EXPECT_EQ(redis.zrange(dest, 0, -1)[1].member, "e");
+    EXPECT_EQ(redis.zrangestorebyscore(
+                  dest, key,
+                  qb::redis::BoundedInterval<double>(2.0, 4.0, qb::redis::BoundType::CLOSED)),
+              3);
+    EXPECT_EQ(redis.zrangestorebyscore(
+                  dest, key,
+                  qb::redis::BoundedInterval<double>(2.0, 4.0, qb::redis::BoundType::CLOSED),
+                  {0, 1}, true),
+              1);
+    EXPECT_EQ(redis.zrange(dest, 0, -1)[0].member, "d");
+
+    EXPECT_FALSE(redis.zmpop({empty}, qb::redis::SortedSetPosition::MIN).has_value());
+    auto popped = redis.zmpop({empty, key}, qb::redis::SortedSetPosition::MIN, 2);
+    ASSERT_TRUE(popped.has_value());
+    EXPECT_EQ(popped->key, key);
+    ASSERT_EQ(popped->elements.size(), 2);
+    EXPECT_EQ(popped->elements.members[1], "b");
+    EXPECT_EQ(popped->elements.scores[1], 2.0);
+
+    popped = redis.bzmpop({empty, key}, qb::redis::SortedSetPosition::MAX, 0.1, 10);
+    ASSERT_TRUE(popped.has_value());
+    ASSERT_EQ(popped->elements.size(), 3);
+    EXPECT_EQ(popped->elements.members[0], "e");
+    EXPECT_FALSE(
+        redis.bzmpop({empty, key}, qb::redis::SortedSetPosition::MAX, 0.1).has_value());
+}
+
 /*
  * TESTS ASYNCHRONES
  */
@@ -1215,4 +1323,48 @@ TEST_F(RedisTest, SYNC_SORTED_SET_COMMANDS_SCAN_AUTO) {
 
     redis.await();
     EXPECT_TRUE(scan_called);
-}
\ No newline at end of file
+}
+
+// Test asynchronous ZADD from parallel arrays and structure-of-arrays results
+TEST_F(RedisTest, ASYNC_SORTED_SET_COMMANDS_SOA) {
+    std::string                  key = test_key("async_soa");
+    std::vector<double>          scores(100);
+    std::vector<std::string>     members(100);
+    long long                    added = 0;
+    qb::redis::score_member_list range;
+
+    for (std::size_t i = 0; i < scores.size(); ++i) {
+        scores[i]  = static_cast<double>(i) / 3;
+        members[i] = "member" + std::to_string(i);
+    }
+
+    redis.zadd([&](auto &&reply) { added = reply.result(); }, key, scores, members);
+    redis.zrevrange_list([&](auto &&reply) { range = std::move(reply.result()); }, key,
+                         0, 9);
+
+    redis.await();
+    EXPECT_EQ(added, 100);
+    ASSERT_EQ(range.size(), 10);
+    EXPECT_EQ(range.members[0], "member99");
+    EXPECT_EQ(range.scores[0], 99.0 / 3);
+    EXPECT_EQ(range.scores[9], 90.0 / 3);
+}
+
+// Test asynchronous ZMSCORE/ZMPOP
+TEST_F(RedisTest, ASYNC_SORTED_SET_COMMANDS_MULTI_ELEMENT) {
+    std::string                                     key = test_key("async_multi");
+    std::vector<std::optional<double>>              scores;
+    std::optional<qb::redis::sorted_set_pop_result> popped;
+
+    redis.zadd(key, {{1.0, "a"}, {2.0, "b"}});
+    redis.zmscore([&](auto &&reply) { scores = reply.result(); }, key, "b", "z");
+    redis.zmpop([&](auto &&reply) { popped = std::move(reply.result()); }, {key},
+                qb::redis::SortedSetPosition::MAX);
+
+    redis.await();
+    ASSERT_EQ(scores.size(), 2);
+    EXPECT_EQ(scores[0], 2.0);
+    EXPECT_FALSE(scores[1].has_value());
+    ASSERT_TRUE(popped.has_value());
+    EXPECT_EQ(popped->elements.members[0], "b");
+}
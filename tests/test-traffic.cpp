@@ -0,0 +1,223 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include "../traffic_player.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::traffic-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return key_prefix() + ":" + k;
+}
+
+// Reads a whole file
+inline std::string
+read_file(const std::string &path) {
+    std::ostringstream out;
+    out << std::ifstream(path, std::ios::binary).rdbuf();
+    return out.str();
+}
+
+// Writes a log of the given reply chunks
+inline std::string
+reply_log(const std::vector<std::string> &chunks) {
+    const std::string path = "qbm-redis-test.qbrt";
+    {
+        traffic_recorder recorder(path);
+        recorder.record(traffic_direction::OUT, "*1\r\n$4\r\nPING\r\n", 14);
+        for (const auto &chunk : chunks)
+            recorder.record(traffic_direction::IN, chunk.data(), chunk.size());
+    }
+    auto log = read_file(path);
+    std::remove(path.c_str());
+    return log;
+}
+
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * TRAFFIC LOG TESTS
+ */
+
+// Test records are read back in order, across buffer flushes
+TEST(TrafficLog, RECORD_AND_READ) {
+    const std::string path   = "qbm-redis-test.qbrt";
+    const auto        before = duration_cast<microseconds>(
+                            system_clock::now().time_since_epoch()).count();
+    {
+        traffic_recorder recorder(path, 8);
+        recorder.record(traffic_direction::OUT, "*1\r\n$4\r\nPING\r\n", 14);
+        recorder.record(traffic_direction::IN, "", 0);
+        recorder.record(traffic_direction::IN, "+PONG\r\n", 7);
+        recorder.record(traffic_direction::IN, std::string(300, 'x').data(), 300);
+        EXPECT_EQ(recorder.records(), 3u);
+        EXPECT_EQ(recorder.bytes(), 321u);
+    }
+    const auto log = read_file(path);
+    std::remove(path.c_str());
+
+    traffic_reader reader(log);
+    EXPECT_GE(reader.start_time(), static_cast<std::uint64_t>(before));
+    traffic_record record;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.direction, traffic_direction::OUT);
+    EXPECT_EQ(record.data, "*1\r\n$4\r\nPING\r\n");
+    const auto first = record.time_us;
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.direction, traffic_direction::IN);
+    EXPECT_EQ(record.data, "+PONG\r\n");
+    EXPECT_GE(record.time_us, first);
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.data, std::string(300, 'x'));
+    EXPECT_FALSE(reader.next(record));
+
+    EXPECT_THROW(traffic_reader("QBRX"), std::invalid_argument);
+    traffic_reader truncated(std::string_view(log).substr(0, log.size() - 1));
+    ASSERT_TRUE(truncated.next(record));
+    ASSERT_TRUE(truncated.next(record));
+    EXPECT_THROW(truncated.next(record), std::invalid_argument);
+    EXPECT_THROW(traffic_recorder("/nonexistent/qbm.qbrt"), std::runtime_error);
+}
+
+// Test a failed write stops the recording without throwing
+TEST(TrafficLog, WRITE_FAILURE) {
+    traffic_recorder recorder("/dev/full", 8);
+    recorder.record(traffic_direction::OUT, "*1\r\n$4\r\nPING\r\n", 14);
+    EXPECT_TRUE(recorder.failed());
+    recorder.record(traffic_direction::IN, "+PONG\r\n", 7);
+    EXPECT_EQ(recorder.records(), 0u);
+    EXPECT_THROW(recorder.flush(), std::runtime_error);
+}
+
+// Test replies split across chunks are dispatched to their handlers
+TEST(TrafficPlayer, PLAY) {
+    const auto log =
+        reply_log({":4", "2\r\n$5\r\nhel", "lo\r\n+OK\r\n*2\r\n:1\r\n:2\r\n"});
+
+    traffic_player player(log);
+    long long      number = 0;
+    std::string    text;
+    player.expect<long long>([&](auto &&reply) { number = reply.result(); })
+        .expect<std::string>([&](auto &&reply) { text = reply.result(); });
+    EXPECT_EQ(player.play(), 4u);
+    EXPECT_EQ(number, 42);
+    EXPECT_EQ(text, "hello");
+
+    std::vector<long long> numbers;
+    player.expect<std::vector<long long>>([](auto &&) {})
+        .expect<std::string>([](auto &&) {})
+        .expect<std::string>([](auto &&) {})
+        .expect<std::vector<long long>>([&](auto &&reply) { numbers = reply.result(); });
+    EXPECT_EQ(player.play(), 4u);
+    EXPECT_EQ(numbers, (std::vector<long long>{1, 2}));
+
+    const auto invalid = reply_log({"?\r\n"});
+    EXPECT_THROW(traffic_player(invalid).play(), std::invalid_argument);
+}
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test the traffic of a client is recorded and played back
+TEST_F(RedisTest, SYNC_RECORD_AND_PLAY) {
+    const std::string path = "qbm-redis-test.qbrt";
+    const auto        key  = test_key("key");
+    {
+        traffic_recorder recorder(path);
+        redis.record_traffic(&recorder);
+        EXPECT_TRUE(redis.set(key, "value"));
+        EXPECT_EQ(redis.get(key), "value");
+        EXPECT_EQ(redis.incr(test_key("counter")), 1);
+        redis.record_traffic(nullptr);
+        EXPECT_TRUE(redis.set(key, "other"));
+        EXPECT_GE(recorder.records(), 6u);
+    }
+
+    const mapped_file log(path);
+    std::string       sent;
+    traffic_reader    reader(log.data());
+    traffic_record    record;
+    while (reader.next(record))
+        if (record.direction == traffic_direction::OUT)
+            sent += record.data;
+    EXPECT_NE(sent.find(key), std::string::npos);
+    EXPECT_EQ(sent.find("other"), std::string::npos);
+
+    std::optional<std::string> value;
+    long long                  counter = 0;
+    traffic_player             player(log.data());
+    player.expect<bool>([](auto &&reply) { EXPECT_TRUE(reply.ok()); })
+        .expect<std::optional<std::string>>([&](auto &&reply) { value = reply.result(); })
+        .expect<long long>([&](auto &&reply) { counter = reply.result(); });
+    EXPECT_EQ(player.play(), 3u);
+    EXPECT_EQ(value, "value");
+    EXPECT_EQ(counter, 1);
+    std::remove(path.c_str());
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
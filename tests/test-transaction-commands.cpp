@@ -196,6 +196,77 @@ TEST_F(RedisTest, SYNC_TRANSACTION_COMMANDS_WATCH_MULTIPLE) {
     EXPECT_EQ(*value2, "initial2");
 }
 
+// Test typed pipelined transaction
+TEST_F(RedisTest, SYNC_TRANSACTION_COMMANDS_BUILDER) {
+    std::string key1 = test_key("builder1");
+    std::string key2 = test_key("builder2");
+
+    redis.set(key2, "value2");
+
+    auto results = redis.transaction()
+                       .command<long long>("INCRBY", key1, 5)
+                       .command<std::optional<std::string>>("GET", key2)
+                       .command<std::optional<std::string>>("GET", test_key("missing"))
+                       .exec();
+    EXPECT_TRUE(results.has_value());
+    auto [counter, value, missing] = *results;
+    EXPECT_EQ(counter, 5);
+    EXPECT_EQ(value, "value2");
+    EXPECT_FALSE(missing.has_value());
+    EXPECT_FALSE(redis.is_in_multi());
+}
+
+// Test typed pipelined transaction aborted by WATCH
+TEST_F(RedisTest, SYNC_TRANSACTION_COMMANDS_BUILDER_WATCH) {
+    std::string key = test_key("builder_watch");
+
+    redis.set(key, "initial");
+    EXPECT_TRUE(redis.watch(key));
+
+    qb::redis::tcp::client other_client{REDIS_URI};
+    other_client.connect();
+    other_client.set(key, "modified");
+    other_client.await();
+
+    auto results = redis.transaction().command<qb::redis::status>("SET", key, "new_value").exec();
+    EXPECT_FALSE(results.has_value());
+    EXPECT_EQ(*redis.get(key), "modified");
+}
+
+// Test optimistic transaction helper with a conflict
+TEST_F(RedisTest, SYNC_TRANSACTION_COMMANDS_OPTIMISTIC) {
+    std::string key = test_key("optimistic");
+
+    redis.set(key, "10");
+
+    qb::redis::tcp::client other_client{REDIS_URI};
+    other_client.connect();
+
+    std::optional<std::string> value;
+    int                        writes = 0;
+    auto                       res    = redis.transaction(
+        {key}, [&](auto &r) { r.get([&](auto &&reply) { value = reply.result(); }, key); },
+        [&](auto tx) {
+            // Modify the watched key between the read and write phases once
+            if (!writes++) {
+                other_client.set(key, "20");
+                other_client.await();
+            }
+            auto doubled = std::to_string(std::stoll(*value) * 2);
+            return std::move(tx).template command<qb::redis::status>("SET", key, doubled);
+        });
+
+    EXPECT_TRUE(res.has_value());
+    EXPECT_EQ(writes, 2);
+    EXPECT_EQ(*redis.get(key), "40");
+
+    const auto &stats = redis.transaction_statistics();
+    EXPECT_EQ(stats.attempts, 2);
+    EXPECT_EQ(stats.commits, 1);
+    EXPECT_EQ(stats.conflicts, 1);
+    EXPECT_DOUBLE_EQ(stats.conflict_rate(), 0.5);
+}
+
 /*
  * TESTS ASYNCHRONES
  */
@@ -370,4 +441,29 @@ TEST_F(RedisTest, ASYNC_TRANSACTION_COMMANDS_WATCH_MULTIPLE) {
     EXPECT_TRUE(value2.has_value());
     EXPECT_EQ(*value1, "modified1");
     EXPECT_EQ(*value2, "initial2");
-}
\ No newline at end of file
+}
+
+// Test asynchrone de la transaction typée
+TEST_F(RedisTest, ASYNC_TRANSACTION_COMMANDS_BUILDER) {
+    std::string key1 = test_key("async_builder1");
+    std::string key2 = test_key("async_builder2");
+    bool        done = false;
+
+    redis.transaction()
+        .command<qb::redis::status>("SET", key1, "value1")
+        .command<long long>("INCR", key2)
+        .command<long long>("INCR", key2)
+        .exec([&](auto &&reply) {
+            EXPECT_TRUE(reply.ok());
+            EXPECT_TRUE(reply.result().has_value());
+            auto &[set, first, second] = *reply.result();
+            EXPECT_TRUE(set);
+            EXPECT_EQ(first, 1);
+            EXPECT_EQ(second, 2);
+            done = true;
+        });
+
+    redis.await();
+    EXPECT_TRUE(done);
+    EXPECT_EQ(*redis.get(key1), "value1");
+}
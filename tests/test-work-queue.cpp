@@ -0,0 +1,186 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include <thread>
+#include "../work_queue.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using queue_type = qb::redis::work_queue<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::work-queue-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return "{" + key_prefix() + "}::" + k;
+}
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test fetching in batches and acknowledging
+TEST_F(RedisTest, SYNC_WORK_QUEUE_FETCH_ACK) {
+    queue_type::options opts;
+    opts.batch_size = 3;
+    opts.ack_batch  = 100;
+    queue_type queue{redis, test_key("jobs"), "worker-1", opts};
+    ASSERT_TRUE(queue.connect());
+
+    EXPECT_EQ(queue.push(std::vector<std::string>{"j1", "j2", "j3", "j4"}), 4);
+
+    auto jobs = queue.fetch();
+    EXPECT_EQ(jobs, (std::vector<std::string>{"j1", "j2", "j3"}));
+    EXPECT_EQ(redis.llen(queue.processing()), 3);
+
+    jobs = queue.fetch();
+    EXPECT_EQ(jobs, (std::vector<std::string>{"j4"}));
+
+    queue.ack("j1").ack("j2").ack("j4");
+    EXPECT_EQ(queue.pending_acks(), 3u);
+    EXPECT_EQ(queue.flush(), 3);
+    EXPECT_EQ(queue.pending_acks(), 0u);
+    EXPECT_EQ(redis.lrange(queue.processing(), 0, -1), (std::vector<std::string>{"j3"}));
+}
+
+// Test waiting on the blocking connection
+TEST_F(RedisTest, SYNC_WORK_QUEUE_BLOCKING_FETCH) {
+    queue_type::options opts;
+    opts.block_timeout = 0.1;
+    queue_type queue{redis, test_key("jobs"), "worker-1", opts};
+    ASSERT_TRUE(queue.connect());
+
+    // Timeout on an empty queue
+    EXPECT_TRUE(queue.fetch().empty());
+
+    // The main client stays usable while the blocking connection waits
+    bool set_called = false;
+    bool fetched    = false;
+    queue.fetch([&](auto &&reply) {
+        EXPECT_TRUE(reply.ok());
+        EXPECT_TRUE(reply.result().empty());
+        fetched = true;
+    });
+    redis.set([&](auto &&reply) { set_called = reply.ok(); }, test_key("other"), "v");
+    redis.await();
+    EXPECT_TRUE(set_called);
+    while (!fetched)
+        async::run(EVRUN_NOWAIT);
+}
+
+// Test recovering the jobs of an expired worker
+TEST_F(RedisTest, SYNC_WORK_QUEUE_SWEEP) {
+    std::string         name = test_key("jobs");
+    queue_type::options opts;
+    opts.lease = milliseconds(100);
+    queue_type crashed{redis, name, "worker-1", opts};
+    queue_type alive{redis, name, "worker-2"};
+
+    crashed.push(std::string("j1"), std::string("j2"));
+    crashed.heartbeat();
+    alive.heartbeat();
+    EXPECT_EQ(crashed.fetch().size(), 2u);
+
+    // Lease still valid
+    EXPECT_EQ(alive.sweep(), 0);
+
+    std::this_thread::sleep_for(milliseconds(200));
+    EXPECT_EQ(alive.sweep(), 2);
+    EXPECT_EQ(redis.llen(name), 2);
+    EXPECT_EQ(redis.llen(crashed.processing()), 0);
+    EXPECT_FALSE(redis.sismember(name + ":workers", "worker-1"));
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the asynchronous fetch, ack and flush
+TEST_F(RedisTest, ASYNC_WORK_QUEUE_FETCH_ACK) {
+    queue_type::options opts;
+    opts.ack_batch = 2;
+    queue_type queue{redis, test_key("jobs"), "worker-1", opts};
+
+    std::vector<std::string> jobs;
+    long long                removed = -1;
+    queue.push([](auto &&reply) { EXPECT_EQ(reply.result(), 2); }, std::string("j1"),
+               std::string("j2"));
+    queue.fetch([&](auto &&reply) {
+        EXPECT_TRUE(reply.ok());
+        jobs = std::move(reply.result());
+    });
+    redis.await();
+    ASSERT_EQ(jobs.size(), 2u);
+
+    // The second ack reaches ack_batch and flushes
+    queue.ack(jobs[0]).ack(jobs[1]);
+    EXPECT_EQ(queue.pending_acks(), 0u);
+    queue.flush([&](auto &&reply) { removed = reply.result(); });
+    redis.await();
+    EXPECT_EQ(removed, 0);
+    EXPECT_EQ(redis.llen(queue.processing()), 0);
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
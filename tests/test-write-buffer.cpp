@@ -0,0 +1,208 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <qb/io/async.h>
+#include <thread>
+#include "../write_buffer.h"
+
+// Redis Configuration
+#define REDIS_URI {"tcp://localhost:6379"}
+
+using namespace qb::io;
+using namespace std::chrono;
+using namespace qb::redis;
+
+using buffer_type = qb::redis::write_buffer<qb::io::transport::tcp>;
+
+// Generates unique key prefixes to avoid collisions between tests
+inline std::string
+key_prefix(const std::string &key = "") {
+    static int  counter = 0;
+    std::string prefix  = "qb::redis::write-buffer-test:" + std::to_string(++counter);
+
+    if (key.empty()) {
+        return prefix;
+    }
+
+    return prefix + ":" + key;
+}
+
+// Generates a test key
+inline std::string
+test_key(const std::string &k) {
+    return "{" + key_prefix() + "}::" + k;
+}
+
+// Checks connection and cleans environment before tests
+class RedisTest : public ::testing::Test {
+protected:
+    qb::redis::tcp::client redis{REDIS_URI};
+
+    void
+    SetUp() override {
+        async::init();
+        if (!redis.connect() || !redis.flushall())
+            throw std::runtime_error("Unable to connect to Redis");
+
+        // Wait for connection to be established
+        redis.await();
+        TearDown();
+    }
+
+    void
+    TearDown() override {
+        // Cleanup after tests
+        redis.flushall();
+        redis.await();
+    }
+};
+
+/*
+ * SYNCHRONOUS TESTS
+ */
+
+// Test coalescing overwrites of the same keys
+TEST_F(RedisTest, SYNC_WRITE_BUFFER_COALESCE) {
+    std::string key  = test_key("key");
+    std::string hash = test_key("hash");
+    buffer_type buffer{redis};
+
+    for (int i = 0; i < 100; ++i) {
+        buffer.set(key, std::to_string(i));
+        buffer.hset(hash, "a", std::to_string(i));
+        buffer.hset(hash, "b", "x");
+    }
+    buffer.set(test_key("other"), "v");
+
+    // Pending values are read locally
+    EXPECT_EQ(buffer.get(key), "99");
+    EXPECT_EQ(buffer.hget(hash, "a"), "99");
+    EXPECT_FALSE(redis.exists(key));
+
+    // One MSET for both keys, one HSET for the hash
+    EXPECT_EQ(buffer.flush(), 2);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(redis.get(key), "99");
+    EXPECT_EQ(redis.hget(hash, "a"), "99");
+    EXPECT_EQ(redis.hget(hash, "b"), "x");
+
+    // Reads go through the client once flushed
+    EXPECT_EQ(buffer.get(key), "99");
+    EXPECT_EQ(buffer.hget(hash, "b"), "x");
+    EXPECT_FALSE(buffer.get(test_key("missing")).has_value());
+}
+
+// Test expirations merged in SET or sent as PEXPIRE
+TEST_F(RedisTest, SYNC_WRITE_BUFFER_EXPIRE) {
+    std::string key  = test_key("key");
+    std::string hash = test_key("hash");
+    buffer_type buffer{redis};
+
+    buffer.set(key, "v").expire(key, seconds(100));
+    buffer.hset(hash, "f", "v").expire(hash, seconds(100));
+    EXPECT_EQ(buffer.flush(), 3);
+    EXPECT_GT(redis.pttl(key), 0);
+    EXPECT_GT(redis.pttl(hash), 0);
+
+    // A later SET clears the time to live
+    buffer.expire(key, seconds(100)).set(key, "w");
+    EXPECT_EQ(buffer.flush(), 1);
+    EXPECT_EQ(redis.pttl(key), -1);
+
+    // An expiration of a missing key does not apply to the hash written after
+    const std::string created = test_key("created");
+    buffer.expire(created, seconds(100)).hset(created, "f", "v");
+    EXPECT_EQ(buffer.flush(), 2);
+    EXPECT_EQ(redis.pttl(created), -1);
+}
+
+// Test zero and negative expirations delete the key, as PEXPIRE does
+TEST_F(RedisTest, SYNC_WRITE_BUFFER_EXPIRE_DELETE) {
+    std::string key    = test_key("key");
+    std::string hash   = test_key("hash");
+    std::string stored = test_key("stored");
+    buffer_type buffer{redis};
+
+    redis.set(stored, "v");
+    buffer.set(key, "v").expire(key, milliseconds(0));
+    buffer.hset(hash, "f", "v").expire(hash, milliseconds(-1000));
+    buffer.expire(stored, milliseconds(0));
+    EXPECT_FALSE(buffer.get(key).has_value());
+    EXPECT_FALSE(buffer.hget(hash, "f").has_value());
+    EXPECT_FALSE(buffer.get(stored).has_value());
+
+    EXPECT_EQ(buffer.flush(), 3);
+    EXPECT_FALSE(redis.exists(key));
+    EXPECT_FALSE(redis.exists(hash));
+    EXPECT_FALSE(redis.exists(stored));
+
+    // A hash written after the deletion is kept
+    buffer.expire(hash, milliseconds(0)).hset(hash, "f", "w");
+    EXPECT_EQ(buffer.flush(), 2);
+    EXPECT_EQ(redis.hget(hash, "f"), "w");
+}
+
+// Test the memory budget forcing a flush
+TEST_F(RedisTest, SYNC_WRITE_BUFFER_BUDGET) {
+    std::string          small = test_key("small");
+    std::string          large = test_key("large");
+    buffer_type::options opts;
+    opts.max_bytes = 64;
+    buffer_type buffer{redis, opts};
+
+    buffer.set(small, "v");
+    EXPECT_FALSE(buffer.empty());
+    buffer.set(large, std::string(100, 'x'));
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.bytes(), 0u);
+    redis.await();
+    EXPECT_EQ(redis.strlen(large), 100);
+}
+
+/*
+ * ASYNCHRONOUS TESTS
+ */
+
+// Test the asynchronous reads and flush
+TEST_F(RedisTest, ASYNC_WRITE_BUFFER_FLUSH) {
+    std::string                key = test_key("key");
+    buffer_type                buffer{redis};
+    std::optional<std::string> value;
+    long long                  sent = -1;
+
+    buffer.set(key, "v");
+    buffer.get([&](auto &&reply) { value = reply.result(); }, key);
+    EXPECT_EQ(value, "v");
+
+    buffer.flush([&](auto &&reply) {
+        EXPECT_TRUE(reply.ok());
+        sent = reply.result();
+    });
+    value.reset();
+    buffer.get([&](auto &&reply) { value = reply.result(); }, key);
+    redis.await();
+    EXPECT_EQ(sent, 1);
+    EXPECT_EQ(value, "v");
+}
+
+// Main function to run the tests
+int
+main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
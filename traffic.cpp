@@ -0,0 +1,146 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#include <stdexcept>
+#include "traffic.h"
+
+namespace {
+
+constexpr std::string_view magic   = "QBRT";
+constexpr char             version = 1;
+constexpr std::size_t      header  = 4 + 1 + 8;
+
+void
+put_varint(std::string &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+std::uint64_t
+get_varint(std::string_view data, std::size_t &pos) {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos == data.size())
+            throw std::invalid_argument("truncated traffic record");
+        const auto byte = static_cast<unsigned char>(data[pos++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw std::invalid_argument("invalid traffic record");
+}
+
+} // namespace
+
+namespace qb::redis {
+
+traffic_recorder::traffic_recorder(const std::string &path, std::size_t buffer_size)
+    : _file(path, std::ios::binary | std::ios::trunc)
+    , _capacity(buffer_size)
+    , _last(std::chrono::steady_clock::now()) {
+    if (!_file)
+        throw std::runtime_error("unable to create " + path);
+    const auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    _buffer.reserve(_capacity + header);
+    _buffer.append(magic);
+    _buffer += version;
+    for (int i = 0; i < 8; ++i)
+        _buffer += static_cast<char>(static_cast<std::uint64_t>(now) >> (8 * i));
+}
+
+traffic_recorder::~traffic_recorder() {
+    try {
+        flush();
+    } catch (const std::exception &) {
+    }
+}
+
+void
+traffic_recorder::record(traffic_direction direction, const char *data,
+                         std::size_t size) noexcept {
+    if (!size || _failed)
+        return;
+    using namespace std::chrono;
+    const auto now     = steady_clock::now();
+    const auto elapsed = duration_cast<microseconds>(now - _last);
+    try {
+        _buffer += static_cast<char>(direction);
+        put_varint(_buffer, elapsed.count());
+        put_varint(_buffer, size);
+        _buffer.append(data, size);
+        if (_buffer.size() >= _capacity && !write())
+            _failed = true;
+    } catch (const std::exception &) {
+        _failed = true;
+    }
+    if (_failed)
+        return;
+    _last = now;
+    ++_records;
+    _bytes += size;
+}
+
+void
+traffic_recorder::flush() {
+    if (!_failed && !write())
+        _failed = true;
+    if (_failed)
+        throw std::runtime_error("unable to write the traffic log");
+}
+
+bool
+traffic_recorder::write() {
+    if (_buffer.empty())
+        return true;
+    _file.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _file.flush();
+    _buffer.clear();
+    return static_cast<bool>(_file);
+}
+
+traffic_reader::traffic_reader(std::string_view log)
+    : _log(log)
+    , _pos(header) {
+    if (log.size() < header || log.substr(0, 4) != magic || log[4] != version)
+        throw std::invalid_argument("invalid traffic log header");
+    for (int i = 0; i < 8; ++i)
+        _start |= static_cast<std::uint64_t>(static_cast<unsigned char>(log[5 + i]))
+                  << (8 * i);
+}
+
+bool
+traffic_reader::next(traffic_record &record) {
+    if (_pos == _log.size())
+        return false;
+    const auto direction = static_cast<unsigned char>(_log[_pos++]);
+    if (direction > 1)
+        throw std::invalid_argument("invalid traffic record");
+    _time += get_varint(_log, _pos);
+    const auto size = get_varint(_log, _pos);
+    if (size > _log.size() - _pos)
+        throw std::invalid_argument("truncated traffic record");
+    record = {static_cast<traffic_direction>(direction), _time, _log.substr(_pos, size)};
+    _pos += size;
+    return true;
+}
+
+} // namespace qb::redis
@@ -0,0 +1,165 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_TRAFFIC_H
+#define QBM_REDIS_TRAFFIC_H
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace qb::redis {
+
+/**
+ * @enum traffic_direction
+ * @brief Direction of recorded bytes
+ */
+enum class traffic_direction : std::uint8_t {
+    OUT = 0, ///< Command bytes sent to the server
+    IN  = 1  ///< Reply bytes received from the server
+};
+
+/**
+ * @struct traffic_record
+ * @brief Bytes read from a traffic log
+ */
+struct traffic_record {
+    traffic_direction direction = traffic_direction::OUT;
+    std::uint64_t     time_us   = 0; ///< Microseconds since the start of the recording
+    std::string_view  data;          ///< View on the log
+};
+
+/**
+ * @class traffic_recorder
+ * @brief Appends the traffic of a client to a binary log
+ *
+ * The log starts with the magic "QBRT", a version byte and the unix time of
+ * the recording in microseconds on 8 little endian bytes. Each record is
+ * then a direction byte, the microseconds elapsed since the previous record
+ * and the size of the bytes as varints, and the bytes themselves. Records are
+ * buffered and written when the buffer is full, on flush() and on
+ * destruction. A failed write stops the recording, see failed().
+ *
+ * Pass the recorder to record_traffic() of a client, see traffic_player to
+ * replay the log. A recorder is not thread safe: it must not be shared by
+ * clients running on different threads.
+ */
+class traffic_recorder {
+public:
+    /**
+     * @brief Creates a log
+     * @param path Path of the log, truncated if it exists
+     * @param buffer_size Bytes buffered before writing
+     * @throws std::runtime_error if the file can not be created
+     */
+    explicit traffic_recorder(const std::string &path, std::size_t buffer_size = 1 << 20);
+    ~traffic_recorder();
+
+    traffic_recorder(const traffic_recorder &)            = delete;
+    traffic_recorder &operator=(const traffic_recorder &) = delete;
+
+    /**
+     * @brief Appends bytes to the log
+     *
+     * Called while reading replies, it never throws: a failure stops the
+     * recording and is reported by failed().
+     */
+    void record(traffic_direction direction, const char *data, std::size_t size) noexcept;
+
+    /**
+     * @brief Writes the buffered records to the file
+     * @throws std::runtime_error if this or an earlier write failed
+     */
+    void flush();
+
+    /**
+     * @brief Checks if the recording stopped on a failed write
+     */
+    [[nodiscard]] bool
+    failed() const {
+        return _failed;
+    }
+
+    /**
+     * @brief Gets the number of records
+     */
+    [[nodiscard]] std::uint64_t
+    records() const {
+        return _records;
+    }
+
+    /**
+     * @brief Gets the number of recorded bytes, headers excluded
+     */
+    [[nodiscard]] std::uint64_t
+    bytes() const {
+        return _bytes;
+    }
+
+private:
+    std::ofstream                         _file;
+    std::string                           _buffer;
+    std::size_t                           _capacity;
+    std::chrono::steady_clock::time_point _last;
+    std::uint64_t                         _records = 0;
+    std::uint64_t                         _bytes   = 0;
+    bool                                  _failed  = false;
+
+    bool write();
+};
+
+/**
+ * @class traffic_reader
+ * @brief Reads the records of a traffic log in place
+ */
+class traffic_reader {
+public:
+    /**
+     * @brief Starts reading a log
+     * @param log Whole log, e.g. a mapped_file, must outlive the reader
+     * @throws std::invalid_argument if the header is invalid
+     */
+    explicit traffic_reader(std::string_view log);
+
+    /**
+     * @brief Reads the next record
+     * @param record Set to the record
+     * @return false at the end of the log
+     * @throws std::invalid_argument if the record is truncated
+     */
+    bool next(traffic_record &record);
+
+    /**
+     * @brief Gets the unix time of the recording in microseconds
+     */
+    [[nodiscard]] std::uint64_t
+    start_time() const {
+        return _start;
+    }
+
+private:
+    std::string_view _log;
+    std::size_t      _pos   = 0;
+    std::uint64_t    _start = 0;
+    std::uint64_t    _time  = 0;
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_TRAFFIC_H
@@ -0,0 +1,146 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_TRAFFIC_PLAYER_H
+#define QBM_REDIS_TRAFFIC_PLAYER_H
+#include <queue>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "mapped_file.h"
+#include "redis.h"
+
+namespace qb::redis {
+
+/**
+ * @class traffic_player
+ * @brief Replay transport feeding the replies of a traffic log to
+ * qb::protocol::redis, without a server
+ *
+ * The inbound records are passed to the protocol in the chunks they were
+ * received in, so the parser sees the exact production traffic. Each reply
+ * is dispatched to the next handler registered with expect(), parsed into its
+ * type as by a client, or released if no handler is left. Outbound records
+ * are ignored: the player measures the receiving side of the client, as fast
+ * as it runs.
+ *
+ * @code
+ * const qb::redis::mapped_file log("traffic.qbrt");
+ * qb::redis::traffic_player    player(log.data());
+ * for (int i = 0; i < 1000; ++i)
+ *     player.expect<std::optional<std::string>>([](auto &&) {});
+ * const auto start   = std::chrono::steady_clock::now();
+ * const auto replies = player.play();
+ * @endcode
+ */
+class traffic_player {
+    friend class qb::protocol::redis<traffic_player>;
+
+public:
+    using redis_protocol = qb::protocol::redis<traffic_player>;
+
+private:
+    std::string_view          _log;
+    qb::allocator::pipe<char> _in;
+    std::queue<IReply *>      _handlers;
+    std::size_t               _replies = 0;
+
+    qb::allocator::pipe<char> &
+    in() {
+        return _in;
+    }
+
+    void
+    on(redis_protocol::message msg) {
+        ++_replies;
+        if (_handlers.empty()) {
+            freeReplyObject(msg.reply);
+            return;
+        }
+        auto &handler = *_handlers.front();
+        handler(msg.reply);
+        delete &handler;
+        _handlers.pop();
+    }
+
+    void
+    on_traffic(traffic_direction, const char *, std::size_t) {}
+
+public:
+    /**
+     * @brief Constructs a player
+     * @param log Traffic log, e.g. a mapped_file, must outlive the player
+     */
+    explicit traffic_player(std::string_view log)
+        : _log(log) {}
+
+    ~traffic_player() {
+        while (!_handlers.empty()) {
+            delete _handlers.front();
+            _handlers.pop();
+        }
+    }
+
+    traffic_player(const traffic_player &)            = delete;
+    traffic_player &operator=(const traffic_player &) = delete;
+
+    /**
+     * @brief Registers the handler of the next reply
+     * @tparam Ret Type the reply is parsed into
+     * @param func Callback receiving the reply
+     * @return Reference to the player for chaining
+     */
+    template <typename Ret, typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<Ret> &&>, traffic_player &>
+    expect(Func &&func) {
+        _handlers.push(new TReply<Func, Ret>(std::forward<Func>(func)));
+        return *this;
+    }
+
+    /**
+     * @brief Passes every reply of the log to the protocol
+     *
+     * Can be called again to replay the log, with new handlers.
+     *
+     * @return Number of replies
+     * @throws std::invalid_argument if the log or a reply is invalid
+     */
+    std::size_t
+    play() {
+        traffic_reader reader(_log);
+        traffic_record record;
+        redis_protocol protocol(*this);
+        _replies = 0;
+        while (reader.next(record)) {
+            if (record.direction != traffic_direction::IN)
+                continue;
+            _in.write(record.data.data(), record.data.size());
+            const auto size = protocol.getMessageSize();
+            if (size)
+                protocol.onMessage(size);
+            if (!protocol.ok())
+                throw std::invalid_argument("invalid reply in the traffic log");
+            _in.reset();
+        }
+        return _replies;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_TRAFFIC_PLAYER_H
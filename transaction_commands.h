@@ -18,10 +18,160 @@
 #ifndef QBM_REDIS_TRANSACTION_COMMANDS_H
 #define QBM_REDIS_TRANSACTION_COMMANDS_H
 
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <tuple>
+#include <qb/io/async.h>
 #include "reply.h"
 
 namespace qb::redis {
 
+/**
+ * @class transaction_builder
+ * @brief Typed MULTI/EXEC transaction sent as a single pipelined frame
+ *
+ * Commands are encoded in the builder and only written to the client on
+ * exec(), wrapped in MULTI ... EXEC. The MULTI and QUEUED replies are
+ * swallowed, the EXEC array is decoded into a tuple holding the result of
+ * each queued command. The result is empty if the transaction was aborted
+ * because a watched key changed.
+ *
+ * @code
+ * auto res = redis.transaction()
+ *                .command<long long>("INCR", "counter")
+ *                .command<std::optional<std::string>>("GET", "name")
+ *                .exec();
+ * if (res) { auto [counter, name] = *res; }
+ * @endcode
+ *
+ * @tparam Derived The Redis client type
+ * @tparam Results Result types of the queued commands
+ */
+template <typename Derived, typename... Results>
+class transaction_builder {
+    template <typename, typename...>
+    friend class transaction_builder;
+
+    using queued_command = std::pair<std::string, encoded_args>;
+
+    Derived                    *_client;
+    std::vector<queued_command> _commands;
+
+    /**
+     * @brief Writes MULTI and the queued commands, swallowing their replies
+     */
+    void
+    send_queued() {
+        _client->template command<status>([](auto &&) {}, "MULTI");
+        for (const auto &cmd : _commands)
+            _client->template command<status>([](auto &&) {}, cmd.first, cmd.second);
+        _commands.clear();
+    }
+
+public:
+    /**
+     * @brief Result of the transaction, nullopt if it was aborted by WATCH
+     */
+    using result_type = std::optional<std::tuple<Results...>>;
+
+    /**
+     * @brief Constructs a transaction builder
+     * @param client Redis client which executes the transaction
+     * @param commands Commands already queued
+     */
+    explicit transaction_builder(Derived &client, std::vector<queued_command> commands = {})
+        : _client(&client)
+        , _commands(std::move(commands)) {}
+
+    /**
+     * @brief Queues a command in the transaction
+     *
+     * @tparam Ret Result type of the command
+     * @tparam Args Command argument types
+     * @param name Command name
+     * @param args Command arguments
+     * @return A builder with Ret appended to the result types
+     */
+    template <typename Ret, typename... Args>
+    transaction_builder<Derived, Results..., Ret>
+    command(std::string name, Args &&...args) && {
+        _commands.emplace_back(std::move(name), encode_args(args...));
+        return transaction_builder<Derived, Results..., Ret>{*_client,
+                                                             std::move(_commands)};
+    }
+
+    /**
+     * @brief Gets the number of queued commands
+     * @return Number of commands in the transaction
+     */
+    [[nodiscard]] std::size_t
+    size() const {
+        return _commands.size();
+    }
+
+    /**
+     * @brief Executes the transaction
+     *
+     * @return Tuple of the command results, nullopt if a watched key changed
+     * @throws std::runtime_error if the transaction or one of its commands fails
+     */
+    result_type
+    exec() && {
+        static_assert(sizeof...(Results) > 0, "Transaction has no command");
+        send_queued();
+        return _client->template command<result_type>("EXEC").result();
+    }
+
+    /**
+     * @brief Asynchronous version of exec
+     *
+     * @tparam Func Callback function type
+     * @param func Callback function
+     * @return Reference to the Redis handler for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<result_type> &&>, Derived &>
+    exec(Func &&func) && {
+        static_assert(sizeof...(Results) > 0, "Transaction has no command");
+        send_queued();
+        return _client->template command<result_type>(std::forward<Func>(func), "EXEC");
+    }
+};
+
+/**
+ * @struct transaction_options
+ * @brief Retry policy of optimistic transactions
+ */
+struct transaction_options {
+    /// Attempts before giving up
+    std::size_t max_attempts = 8;
+    /// Backoff after the first conflict
+    std::chrono::microseconds base_backoff = std::chrono::microseconds(500);
+    /// Backoff upper bound
+    std::chrono::microseconds max_backoff = std::chrono::milliseconds(50);
+};
+
+/**
+ * @struct transaction_stats
+ * @brief Counters of optimistic transactions run on a client
+ */
+struct transaction_stats {
+    std::size_t attempts  = 0; ///< EXEC sent
+    std::size_t commits   = 0; ///< EXEC applied
+    std::size_t conflicts = 0; ///< EXEC aborted because a watched key changed
+    std::size_t exhausted = 0; ///< Transactions which ran out of attempts
+
+    /**
+     * @brief Gets the ratio of conflicting attempts
+     * @return conflicts / attempts, 0 if no attempt was made
+     */
+    [[nodiscard]] double
+    conflict_rate() const {
+        return attempts ? static_cast<double>(conflicts) / attempts : 0.;
+    }
+};
+
 /**
  * @class transaction_commands
  * @brief Provides Redis transaction command implementations.
@@ -44,7 +194,37 @@ private:
     derived() {
         return static_cast<Derived &>(*this);
     }
-    bool exec_flag_ = false;
+    bool              exec_flag_ = false;
+    transaction_stats tx_stats_;
+
+    /**
+     * @brief Waits a random duration before retrying a conflicting transaction
+     *
+     * Full jitter: the delay is uniform in [0, min(max, base * 2^attempt)] so
+     * that clients conflicting on the same keys do not retry in lockstep. The
+     * event loop keeps running meanwhile, so the other pending replies and
+     * timers are not delayed.
+     *
+     * @param options Retry policy
+     * @param attempt Number of the attempt which conflicted, starting at 0
+     */
+    static void
+    backoff(const transaction_options &options, std::size_t attempt) {
+        thread_local std::minstd_rand rng{std::random_device{}()};
+
+        auto ceiling = options.base_backoff.count() << std::min<std::size_t>(attempt, 20);
+        ceiling      = std::min<long long>(ceiling, options.max_backoff.count());
+        if (ceiling <= 0)
+            return;
+        std::uniform_int_distribution<long long> delay(0, ceiling);
+        bool                                     waiting = true;
+        qb::io::async::callback([&waiting]() { waiting = false; },
+                                std::chrono::duration<double>(
+                                    std::chrono::microseconds(delay(rng)))
+                                    .count());
+        while (waiting)
+            qb::io::async::run(EVRUN_ONCE);
+    }
 
 public:
     /**
@@ -250,6 +430,107 @@ public:
         return derived().template command<status>(std::forward<Func>(func), "UNWATCH");
     }
 
+    /**
+     * @brief Starts a typed pipelined transaction.
+     *
+     * MULTI, the queued commands and EXEC are written in a single frame, so
+     * the transaction costs one round trip.
+     *
+     * @return An empty transaction builder
+     * @see transaction_builder
+     */
+    transaction_builder<Derived>
+    transaction() {
+        return transaction_builder<Derived>{derived()};
+    }
+
+    /**
+     * @brief Runs an optimistic check-and-set transaction with retries.
+     *
+     * Each attempt costs two round trips:
+     * 1. WATCH on the keys and the reads queued by read_fn are pipelined
+     * 2. the transaction built by write_fn is sent as a pipelined MULTI/EXEC
+     *
+     * read_fn should queue its reads with the asynchronous commands, storing the
+     * results in captured state, so they share the WATCH frame. If EXEC returns
+     * nil because a watched key changed, the attempt is retried after a jittered
+     * backoff. The whole transaction runs on this client connection.
+     *
+     * @code
+     * std::optional<std::string> balance;
+     * auto res = redis.transaction(
+     *     {"balance"},
+     *     [&](auto &r) {
+     *         r.get([&](auto &&reply) { balance = reply.result(); }, "balance");
+     *     },
+     *     [&](auto tx) {
+     *         auto value = balance ? std::stoll(*balance) : 0;
+     *         return std::move(tx).template command<long long>("INCRBY", "balance",
+     *                                                          value);
+     *     });
+     * @endcode
+     *
+     * @tparam ReadFn Callable invoked as read_fn(Derived &)
+     * @tparam WriteFn Callable invoked as write_fn(transaction_builder<Derived>),
+     *                 returning the filled builder
+     * @param keys Keys to watch
+     * @param read_fn Read phase
+     * @param write_fn Write phase
+     * @param options Retry policy
+     * @return Result of the committed transaction, nullopt if every attempt conflicted
+     * @throws std::runtime_error if a command fails, the keys are then unwatched
+     */
+    template <typename ReadFn, typename WriteFn>
+    auto
+    transaction(const std::vector<std::string> &keys, ReadFn &&read_fn,
+                WriteFn &&write_fn, const transaction_options &options = {}) {
+        using builder_type =
+            std::invoke_result_t<WriteFn &, transaction_builder<Derived>>;
+        using result_type = typename builder_type::result_type;
+
+        for (std::size_t attempt = 0; attempt < options.max_attempts; ++attempt) {
+            if (attempt)
+                backoff(options, attempt - 1);
+
+            result_type result;
+            try {
+                bool watched = true;
+                if (!keys.empty())
+                    derived().template command<status>(
+                        [&watched](auto &&reply) { watched = reply.ok(); }, "WATCH",
+                        keys);
+                read_fn(derived());
+                derived().await();
+                if (!watched)
+                    throw std::runtime_error("WATCH failed");
+
+                ++tx_stats_.attempts;
+                result = write_fn(transaction()).exec();
+            } catch (...) {
+                derived().template command<status>([](auto &&) {}, "UNWATCH");
+                derived().await();
+                throw;
+            }
+
+            if (result) {
+                ++tx_stats_.commits;
+                return result;
+            }
+            ++tx_stats_.conflicts;
+        }
+        ++tx_stats_.exhausted;
+        return result_type{};
+    }
+
+    /**
+     * @brief Gets the counters of optimistic transactions run on this client
+     * @return Transaction counters
+     */
+    const transaction_stats &
+    transaction_statistics() const {
+        return tx_stats_;
+    }
+
     /**
      * @brief Checks if currently in a transaction.
      *
@@ -17,6 +17,7 @@
 
 #ifndef QBM_REDIS_TYPES_H
 #define QBM_REDIS_TYPES_H
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -26,6 +27,7 @@
 #include <unordered_map>
 #include <optional>
 #include <variant>
+#include <iterator>
 #include <hiredis/hiredis.h>
 
 namespace qb::redis {
@@ -75,6 +77,14 @@ enum class InsertPosition { BEFORE, AFTER };
  */
 enum class ListPosition { LEFT, RIGHT };
 
+/**
+ * @enum SortedSetPosition
+ * @brief Specifies which end of a sorted set to pop from
+ *
+ * Used with ZMPOP and BZMPOP.
+ */
+enum class SortedSetPosition { MIN, MAX };
+
 /**
  * @enum BoundType
  * @brief Specifies boundary type for interval operations
@@ -352,6 +362,205 @@ enum class BitOp { AND, OR, XOR, NOT };
  */
 enum class GeoUnit { M, KM, MI, FT };
 
+/**
+ * @enum BitfieldOverflow
+ * @brief Overflow policies of BITFIELD SET and INCRBY operations
+ */
+enum class BitfieldOverflow { WRAP, SAT, FAIL };
+
+/**
+ * @struct bitfield_type
+ * @brief Integer type of a BITFIELD operation (u1..u63, i1..i64)
+ */
+struct bitfield_type {
+    bool     is_signed{};
+    unsigned bits{};
+
+    /**
+     * @brief Creates an unsigned type
+     * @param bits Width in bits, 1 to 63
+     * @throws std::invalid_argument if the width is out of range
+     */
+    static bitfield_type
+    u(unsigned bits) {
+        if (!bits || bits > 63)
+            throw std::invalid_argument("unsigned bitfield width must be in [1, 63]");
+        return {false, bits};
+    }
+
+    /**
+     * @brief Creates a signed type
+     * @param bits Width in bits, 1 to 64
+     * @throws std::invalid_argument if the width is out of range
+     */
+    static bitfield_type
+    i(unsigned bits) {
+        if (!bits || bits > 64)
+            throw std::invalid_argument("signed bitfield width must be in [1, 64]");
+        return {true, bits};
+    }
+};
+
+namespace bitfield {
+constexpr bitfield_type u1{false, 1};
+constexpr bitfield_type u2{false, 2};
+constexpr bitfield_type u4{false, 4};
+constexpr bitfield_type u8{false, 8};
+constexpr bitfield_type u16{false, 16};
+constexpr bitfield_type u32{false, 32};
+constexpr bitfield_type i8{true, 8};
+constexpr bitfield_type i16{true, 16};
+constexpr bitfield_type i32{true, 32};
+constexpr bitfield_type i64{true, 64};
+} // namespace bitfield
+
+/**
+ * @struct bitfield_offset
+ * @brief Offset of a BITFIELD operation, in bits or in type widths (#N)
+ */
+struct bitfield_offset {
+    long long value{};
+    bool      indexed{};
+
+    bitfield_offset(long long bit)
+        : value(bit) {}
+
+    /**
+     * @brief Creates a #N offset, N times the width of the operation type
+     * @param n Index of the field
+     */
+    static bitfield_offset
+    index(long long n) {
+        bitfield_offset offset{n};
+        offset.indexed = true;
+        return offset;
+    }
+};
+
+/**
+ * @class bitfield_ops
+ * @brief Typed list of BITFIELD operations
+ *
+ * Operations are kept as plain values and encoded directly into the command
+ * pipe, so building thousands of counter updates does not allocate a string
+ * per token. Lists which only contain GET operations are sent as BITFIELD_RO.
+ *
+ * @code
+ * qb::redis::bitfield_ops ops;
+ * ops.overflow(BitfieldOverflow::SAT)
+ *    .incrby(bitfield::u8, bitfield_offset::index(3), 1)
+ *    .get(bitfield::u8, bitfield_offset::index(4));
+ * @endcode
+ */
+class bitfield_ops {
+public:
+    enum class Kind { GET, SET, INCRBY, OVERFLOW_POLICY };
+
+    struct operation {
+        Kind             kind{};
+        bitfield_type    type{};
+        bitfield_offset  offset{0};
+        long long        value{};
+        BitfieldOverflow overflow{};
+    };
+
+    /**
+     * @brief Reads a field
+     * @param type Field type
+     * @param offset Field offset
+     * @return Reference to the builder for chaining
+     */
+    bitfield_ops &
+    get(bitfield_type type, bitfield_offset offset) {
+        _ops.push_back({Kind::GET, type, offset, 0, {}});
+        ++_results;
+        return *this;
+    }
+
+    /**
+     * @brief Writes a field, its previous value is returned
+     * @param type Field type
+     * @param offset Field offset
+     * @param value New value
+     * @return Reference to the builder for chaining
+     */
+    bitfield_ops &
+    set(bitfield_type type, bitfield_offset offset, long long value) {
+        _ops.push_back({Kind::SET, type, offset, value, {}});
+        _read_only = false;
+        ++_results;
+        return *this;
+    }
+
+    /**
+     * @brief Increments a field, its new value is returned
+     * @param type Field type
+     * @param offset Field offset
+     * @param increment Value to add, may be negative
+     * @return Reference to the builder for chaining
+     */
+    bitfield_ops &
+    incrby(bitfield_type type, bitfield_offset offset, long long increment) {
+        _ops.push_back({Kind::INCRBY, type, offset, increment, {}});
+        _read_only = false;
+        ++_results;
+        return *this;
+    }
+
+    /**
+     * @brief Sets the overflow policy of the following SET and INCRBY
+     * @param policy Overflow policy
+     * @return Reference to the builder for chaining
+     */
+    bitfield_ops &
+    overflow(BitfieldOverflow policy) {
+        _ops.push_back({Kind::OVERFLOW_POLICY, {}, 0, 0, policy});
+        // BITFIELD_RO only accepts GET
+        _read_only = false;
+        return *this;
+    }
+
+    [[nodiscard]] const std::vector<operation> &
+    operations() const {
+        return _ops;
+    }
+
+    /**
+     * @brief Checks if the list only reads fields
+     * @return true if the list can be sent as BITFIELD_RO
+     */
+    [[nodiscard]] bool
+    read_only() const {
+        return _read_only;
+    }
+
+    /**
+     * @brief Gets the number of results the command will return
+     * @return Number of GET, SET and INCRBY operations
+     */
+    [[nodiscard]] std::size_t
+    size() const {
+        return _results;
+    }
+
+    [[nodiscard]] bool
+    empty() const {
+        return _ops.empty();
+    }
+
+    void
+    clear() {
+        _ops.clear();
+        _read_only = true;
+        _results   = 0;
+    }
+
+private:
+    std::vector<operation> _ops;
+    bool                   _read_only = true;
+    std::size_t            _results   = 0;
+};
+
 /**
  * @enum XtrimStrategy
  * @brief Trimming strategies for stream commands
@@ -386,6 +595,234 @@ struct geo_distance {
     double      distance{};
 };
 
+/**
+ * @struct geo_points
+ * @brief Non-owning view on parallel arrays of positions and member names
+ *
+ * Used to encode batched GEOADD commands straight from the caller buffers.
+ */
+template <typename Member>
+struct geo_points {
+    const double *longitudes{};
+    const double *latitudes{};
+    const Member *members{};
+    std::size_t   size{};
+};
+
+/**
+ * @enum GeoSort
+ * @brief Result ordering of geospatial searches
+ */
+enum class GeoSort { NONE, ASC, DESC };
+
+/**
+ * @struct geo_origin
+ * @brief Center of a geospatial search (FROMMEMBER or FROMLONLAT)
+ */
+struct geo_origin {
+    std::string member;   ///< Center member, empty to use position
+    geo_pos     position; ///< Center position when member is empty
+
+    static geo_origin
+    from_member(std::string member) {
+        return {std::move(member), {}};
+    }
+
+    static geo_origin
+    from_lonlat(double longitude, double latitude) {
+        return {{}, {longitude, latitude}};
+    }
+};
+
+/**
+ * @struct geo_shape
+ * @brief Area of a geospatial search (BYRADIUS or BYBOX)
+ */
+struct geo_shape {
+    double  width{};  ///< Radius, or box width
+    double  height{}; ///< Box height, 0 for a radius
+    GeoUnit unit = GeoUnit::M;
+
+    static geo_shape
+    radius(double radius, GeoUnit unit = GeoUnit::M) {
+        return {radius, 0, unit};
+    }
+
+    static geo_shape
+    box(double width, double height, GeoUnit unit = GeoUnit::M) {
+        return {width, height, unit};
+    }
+
+    [[nodiscard]] bool
+    is_box() const {
+        return height > 0;
+    }
+};
+
+/**
+ * @struct geo_search_options
+ * @brief Optional arguments of GEOSEARCH and GEOSEARCHSTORE
+ */
+struct geo_search_options {
+    GeoSort   sort       = GeoSort::NONE;
+    long long count      = 0;     ///< Maximum number of results (0 for unlimited)
+    bool      any        = false; ///< Return as soon as count matches are found
+    bool      with_dist  = false; ///< GEOSEARCH only
+    bool      with_coord = false; ///< GEOSEARCH only
+    bool      with_hash  = false; ///< GEOSEARCH only
+};
+
+/**
+ * @class string_table
+ * @brief Strings stored back to back in a single buffer owned by the table
+ *
+ * Entries are kept as offsets in the buffer and read as std::string_view, so
+ * the table is copied and moved as plain data. A view stays valid until the
+ * table is modified or destroyed.
+ */
+class string_table {
+    std::string                                      _storage;
+    std::vector<std::pair<std::size_t, std::size_t>> _entries; ///< Offset, size
+
+public:
+    class const_iterator {
+        const string_table *_table{};
+        std::size_t         _index{};
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = std::string_view;
+
+        const_iterator() = default;
+        const_iterator(const string_table *table, std::size_t index)
+            : _table(table)
+            , _index(index) {}
+
+        std::string_view
+        operator*() const {
+            return (*_table)[_index];
+        }
+
+        const_iterator &
+        operator++() {
+            ++_index;
+            return *this;
+        }
+
+        const_iterator
+        operator++(int) {
+            auto it = *this;
+            ++_index;
+            return it;
+        }
+
+        bool
+        operator==(const const_iterator &other) const {
+            return _index == other._index;
+        }
+
+        bool
+        operator!=(const const_iterator &other) const {
+            return _index != other._index;
+        }
+    };
+
+    /**
+     * @brief Reserves room for the entries
+     * @param count Number of entries
+     * @param bytes Total size of the entries
+     */
+    void
+    reserve(std::size_t count, std::size_t bytes) {
+        _entries.reserve(count);
+        _storage.reserve(bytes);
+    }
+
+    /**
+     * @brief Appends a copy of a string
+     * @param value String to append
+     */
+    void
+    push_back(std::string_view value) {
+        _entries.emplace_back(_storage.size(), value.size());
+        _storage.append(value);
+    }
+
+    [[nodiscard]] std::size_t
+    size() const {
+        return _entries.size();
+    }
+
+    [[nodiscard]] bool
+    empty() const {
+        return _entries.empty();
+    }
+
+    std::string_view
+    operator[](std::size_t i) const {
+        return {_storage.data() + _entries[i].first, _entries[i].second};
+    }
+
+    /**
+     * @brief Gets an entry with bounds checking
+     * @throws std::out_of_range if i is not a valid index
+     */
+    [[nodiscard]] std::string_view
+    at(std::size_t i) const {
+        const auto &entry = _entries.at(i);
+        return {_storage.data() + entry.first, entry.second};
+    }
+
+    [[nodiscard]] const_iterator
+    begin() const {
+        return {this, 0};
+    }
+
+    [[nodiscard]] const_iterator
+    end() const {
+        return {this, _entries.size()};
+    }
+};
+
+/**
+ * @struct geo_search_result
+ * @brief Structure-of-arrays result of a geospatial search
+ *
+ * Member names are stored in a single string table. The other arrays are
+ * either empty, when the matching WITH* option was not requested, or have
+ * one entry per member.
+ */
+struct geo_search_result {
+    string_table           members;
+    std::vector<double>    distances;  ///< WITHDIST
+    std::vector<long long> hashes;     ///< WITHHASH
+    std::vector<double>    longitudes; ///< WITHCOORD
+    std::vector<double>    latitudes;  ///< WITHCOORD
+
+    [[nodiscard]] std::size_t
+    size() const {
+        return members.size();
+    }
+
+    [[nodiscard]] bool
+    empty() const {
+        return members.empty();
+    }
+
+    /**
+     * @brief Gets the position of a result
+     * @param i Result index, requires WITHCOORD
+     * @return Position of the i-th member
+     */
+    [[nodiscard]] geo_pos
+    position(std::size_t i) const {
+        return {longitudes[i], latitudes[i]};
+    }
+};
+
 /**
  * @struct stream_id
  * @brief Container for Redis Stream ID
@@ -460,6 +897,91 @@ struct score_member {
     }
 };
 
+/**
+ * @struct score_member_list
+ * @brief Structure-of-arrays sorted set reply
+ *
+ * Scores are stored contiguously and member names in a single string table,
+ * instead of one std::string per entry.
+ */
+struct score_member_list {
+    string_table        members;
+    std::vector<double> scores;
+
+    [[nodiscard]] std::size_t
+    size() const {
+        return members.size();
+    }
+
+    [[nodiscard]] bool
+    empty() const {
+        return members.empty();
+    }
+
+    /**
+     * @brief Copies an entry out of the list
+     * @param i Entry index
+     * @return The i-th score and member
+     */
+    [[nodiscard]] score_member
+    at(std::size_t i) const {
+        return {scores.at(i), std::string(members.at(i))};
+    }
+};
+
+/**
+ * @struct score_members
+ * @brief Non-owning view on parallel arrays of scores and member names
+ *
+ * Used to encode ZADD commands straight from the caller buffers.
+ */
+template <typename Member>
+struct score_members {
+    const double *scores{};
+    const Member *members{};
+    std::size_t   size{};
+};
+
+/**
+ * @struct sorted_set_pop_result
+ * @brief Result of ZMPOP and BZMPOP
+ */
+struct sorted_set_pop_result {
+    std::string       key;      ///< Sorted set the members were popped from
+    score_member_list elements; ///< Popped members and scores
+};
+
+/**
+ * @struct list_pop_result
+ * @brief Result of LMPOP and BLMPOP
+ */
+struct list_pop_result {
+    std::string              key;      ///< List the elements were popped from
+    std::vector<std::string> elements; ///< Popped elements
+};
+
+/**
+ * @struct field_value_list
+ * @brief Structure-of-arrays list of hash fields and values
+ *
+ * Fields and values are stored in two string tables, entry i of each
+ * forming a pair.
+ */
+struct field_value_list {
+    string_table fields;
+    string_table values;
+
+    [[nodiscard]] std::size_t
+    size() const {
+        return fields.size();
+    }
+
+    [[nodiscard]] bool
+    empty() const {
+        return fields.empty();
+    }
+};
+
 /**
  * @struct search_result
  * @brief Container for Redis search results
@@ -851,6 +1373,13 @@ std::string to_string(qb::redis::Aggregation op);
  */
 std::string to_string(qb::redis::GeoUnit op);
 
+/**
+ * @brief Converts a GeoSort enum to string
+ * @param op The GeoSort value to convert
+ * @return String representation of the GeoSort value, empty for NONE
+ */
+std::string to_string(qb::redis::GeoSort op);
+
 /**
  * @brief Converts an InsertPosition enum to string
  * @param pos The InsertPosition value to convert
@@ -864,6 +1393,13 @@ std::string to_string(qb::redis::InsertPosition pos);
  * @return String representation of the ListPosition value
  */
 std::string to_string(qb::redis::ListPosition pos);
+
+/**
+ * @brief Converts a SortedSetPosition enum to string
+ * @param pos The SortedSetPosition value to convert
+ * @return String representation of the SortedSetPosition value
+ */
+std::string to_string(qb::redis::SortedSetPosition pos);
 } // namespace std
 
 #endif // QBM_REDIS_TYPES_H
@@ -0,0 +1,503 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_WORK_QUEUE_H
+#define QBM_REDIS_WORK_QUEUE_H
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "redis.h"
+
+namespace qb::redis {
+
+/**
+ * @class work_queue
+ * @brief Reliable work queue on Redis lists
+ *
+ * Producers push jobs to the `name` list. A worker moves them to its own
+ * processing list, `name:processing:<worker>`, and removes them from it once
+ * done, so the jobs of a crashed worker are never lost:
+ *
+ * - fetch() reads the length of the queue, then moves up to batch_size jobs
+ *   with pipelined LMOVE, so a short queue costs no useless LMOVE. When the
+ *   queue is empty it waits with BLMOVE on a dedicated connection, so the
+ *   main client keeps serving other commands.
+ * - ack() buffers completed jobs and flushes them as pipelined LREM.
+ * - heartbeat() refreshes the worker lease `name:alive:<worker>`, and sweep()
+ *   pushes back the jobs of the workers whose lease expired.
+ *
+ * Delivery is at least once: a worker that misses its lease while still
+ * running may see its jobs processed again by another worker. The queue must
+ * outlive its pending asynchronous operations.
+ *
+ * @tparam QB_IO_ The QB I/O type of the clients
+ */
+template <typename QB_IO_>
+class work_queue {
+public:
+    using client_type = detail::Redis<QB_IO_>;
+
+    /**
+     * @struct options
+     * @brief Tuning of a work queue
+     */
+    struct options {
+        std::size_t               batch_size    = 128;   ///< Max jobs per fetch
+        std::size_t               ack_batch     = 256;   ///< Acks buffered before a flush
+        double                    block_timeout = 1;     ///< BLMOVE timeout in seconds
+        std::chrono::milliseconds lease{30000};          ///< Worker lease duration
+    };
+
+private:
+    client_type             &_redis;
+    client_type              _blocking;
+    options                  _opts;
+    std::string              _name;
+    std::string              _worker;
+    std::string              _processing;
+    std::string              _workers;
+    std::vector<std::string> _acks;
+
+    std::string
+    processing_key(const std::string &worker) const {
+        return _name + ":processing:" + worker;
+    }
+
+    std::string
+    alive_key(const std::string &worker) const {
+        return _name + ":alive:" + worker;
+    }
+
+    /**
+     * @brief Moves up to count jobs to the processing list with pipelined LMOVE
+     * @param count Number of LMOVE commands to send
+     * @param jobs Jobs already fetched, the moved ones are appended
+     * @param func Callback receiving all the jobs
+     */
+    template <typename Func>
+    void
+    move_batch(std::size_t count, std::vector<std::string> jobs, Func &&func) {
+        if (!count) {
+            std::forward<Func>(func)(
+                Reply<std::vector<std::string>>{true, std::move(jobs), {}, {}});
+            return;
+        }
+        jobs.reserve(jobs.size() + count);
+        auto state = make_fan_in<std::vector<std::string>>(std::forward<Func>(func),
+                                                           std::move(jobs));
+        state->hold(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            _redis.lmove(
+                [state](auto &&reply) {
+                    if (!state->failed(reply) && reply.result())
+                        state->reply.result().push_back(std::move(*reply.result()));
+                    state->done();
+                },
+                _name, _processing, ListPosition::RIGHT, ListPosition::LEFT);
+        }
+        state->done();
+    }
+
+    /**
+     * @brief Moves as many jobs as the queue holds, up to batch_size in total
+     * @param jobs Jobs already fetched, the moved ones are appended
+     * @param func Callback receiving all the jobs
+     */
+    template <typename Func>
+    void
+    sized_batch(std::vector<std::string> jobs, Func &&func) {
+        _redis.llen(
+            [this, jobs = std::move(jobs),
+             func = std::forward<Func>(func)](auto &&length) mutable {
+                if (!length.ok()) {
+                    std::move(func)(Reply<std::vector<std::string>>{
+                        false, std::move(jobs), std::move(length.raw()),
+                        length.error()});
+                    return;
+                }
+                const auto queued =
+                    static_cast<std::size_t>(std::max(length.result(), 0LL));
+                const auto count = std::min(queued, _opts.batch_size - jobs.size());
+                move_batch(count, std::move(jobs), std::move(func));
+            },
+            _name);
+    }
+
+    /**
+     * @brief Workers found by sweep() with their lease and pending jobs
+     */
+    struct survey {
+        std::vector<std::string> workers;
+        std::vector<long long>   alive;
+        std::vector<long long>   sizes;
+    };
+
+    /**
+     * @brief Requeues the jobs of the expired workers and unregisters them
+     */
+    template <typename Func>
+    void
+    recover(Reply<survey> &&found, Func &&func) {
+        if (!found.ok()) {
+            std::forward<Func>(func)(
+                Reply<long long>{false, 0, std::move(found.raw()), found.error()});
+            return;
+        }
+
+        const auto &workers = found.result();
+        auto        state   = make_fan_in<long long>(std::forward<Func>(func));
+        for (std::size_t i = 0; i < workers.workers.size(); ++i) {
+            if (workers.alive[i])
+                continue;
+            const auto source = processing_key(workers.workers[i]);
+            for (long long k = 0; k < workers.sizes[i]; ++k) {
+                state->hold();
+                _redis.lmove(
+                    [state](auto &&reply) {
+                        if (!state->failed(reply) && reply.result())
+                            ++state->reply.result();
+                        state->done();
+                    },
+                    source, _name, ListPosition::RIGHT, ListPosition::RIGHT);
+            }
+            state->hold();
+            _redis.srem(
+                [state](auto &&reply) {
+                    state->failed(reply);
+                    state->done();
+                },
+                _workers, workers.workers[i]);
+        }
+        state->done();
+    }
+
+public:
+    /**
+     * @brief Constructs a work queue
+     *
+     * @param redis Client used for the non-blocking commands
+     * @param name Key of the pending jobs list
+     * @param worker Unique identifier of this worker
+     * @param opts Tuning options
+     */
+    work_queue(client_type &redis, std::string name, std::string worker,
+               options opts = {})
+        : _redis(redis)
+        , _opts(opts)
+        , _name(std::move(name))
+        , _worker(std::move(worker))
+        , _processing(processing_key(_worker))
+        , _workers(_name + ":workers") {
+        if (!_opts.batch_size)
+            throw std::invalid_argument("work_queue: batch_size must be positive");
+    }
+
+    /**
+     * @brief Gets the key of the pending jobs list
+     */
+    [[nodiscard]] const std::string &
+    name() const {
+        return _name;
+    }
+
+    /**
+     * @brief Gets the key of the processing list of this worker
+     */
+    [[nodiscard]] const std::string &
+    processing() const {
+        return _processing;
+    }
+
+    /**
+     * @brief Gets the number of acknowledgements not flushed yet
+     */
+    [[nodiscard]] std::size_t
+    pending_acks() const {
+        return _acks.size();
+    }
+
+    /**
+     * @brief Opens the blocking connection, on the URI of the main client
+     * @return true on success, false on failure
+     */
+    bool
+    connect() {
+        return _blocking.connect(_redis.uri());
+    }
+
+    /**
+     * @brief Opens the blocking connection asynchronously
+     * @param func Callback receiving the connection result
+     * @param timeout Connection timeout in seconds
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, bool>, void>
+    connect(Func &&func, double timeout = 3) {
+        _blocking.connect(std::forward<Func>(func), _redis.uri(), timeout);
+    }
+
+    /**
+     * @brief Pushes jobs to the queue
+     * @param jobs Jobs, or containers of jobs
+     * @return Length of the queue after the push
+     */
+    template <typename... Jobs>
+    long long
+    push(Jobs &&...jobs) {
+        return _redis.lpush(_name, std::forward<Jobs>(jobs)...);
+    }
+
+    /**
+     * @brief Pushes jobs to the queue asynchronously
+     * @param func Callback receiving the length of the queue after the push
+     * @param jobs Jobs, or containers of jobs
+     * @return Reference to the queue for chaining
+     */
+    template <typename Func, typename... Jobs>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, work_queue &>
+    push(Func &&func, Jobs &&...jobs) {
+        _redis.lpush(std::forward<Func>(func), _name, std::forward<Jobs>(jobs)...);
+        return *this;
+    }
+
+    /**
+     * @brief Fetches a batch of jobs
+     *
+     * Moves up to batch_size jobs, oldest first. If the queue is empty, waits
+     * up to block_timeout seconds on the blocking connection.
+     *
+     * @return The fetched jobs, empty on timeout
+     */
+    std::vector<std::string>
+    fetch() {
+        return sync_result<std::vector<std::string>>(
+            [this](auto &&func) { fetch(func); });
+    }
+
+    /**
+     * @brief Fetches a batch of jobs asynchronously
+     *
+     * On error, result() still holds the jobs moved before the failure.
+     *
+     * @param func Callback receiving the fetched jobs
+     * @return Reference to the queue for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::vector<std::string>> &&>,
+                     work_queue &>
+    fetch(Func &&func) {
+        sized_batch({},
+                    [this, func = std::forward<Func>(func)](auto &&reply) mutable {
+                        if (!reply.ok() || !reply.result().empty()) {
+                            std::move(func)(std::move(reply));
+                            return;
+                        }
+                        _blocking.blmove(
+                            [this, func = std::move(func)](auto &&first) mutable {
+                                if (!first.ok() || !first.result()) {
+                                    std::move(func)(Reply<std::vector<std::string>>{
+                                        first.ok(), {}, std::move(first.raw()),
+                                        first.error()});
+                                    return;
+                                }
+                                std::vector<std::string> jobs;
+                                jobs.push_back(std::move(*first.result()));
+                                sized_batch(std::move(jobs), std::move(func));
+                            },
+                            _name, _processing, ListPosition::RIGHT, ListPosition::LEFT,
+                            _opts.block_timeout);
+                    });
+        return *this;
+    }
+
+    /**
+     * @brief Acknowledges a completed job
+     *
+     * The job is removed from the processing list by the next flush, sent
+     * automatically once ack_batch jobs are buffered.
+     *
+     * @param job Job returned by fetch
+     * @return Reference to the queue for chaining
+     */
+    work_queue &
+    ack(std::string job) {
+        _acks.push_back(std::move(job));
+        if (_acks.size() >= _opts.ack_batch)
+            flush(no_check);
+        return *this;
+    }
+
+    /**
+     * @brief Removes the acknowledged jobs from the processing list
+     * @return Number of jobs removed
+     */
+    long long
+    flush() {
+        return sync_result<long long>([this](auto &&func) { flush(func); });
+    }
+
+    /**
+     * @brief Removes the acknowledged jobs from the processing list asynchronously
+     *
+     * Sends one pipelined LREM per job. Jobs are removed from the tail, where
+     * the oldest ones are, so each LREM only scans the jobs fetched before.
+     *
+     * @param func Callback receiving the number of jobs removed
+     * @return Reference to the queue for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, work_queue &>
+    flush(Func &&func) {
+        if (_acks.empty()) {
+            std::forward<Func>(func)(Reply<long long>{true, 0, {}, {}});
+            return *this;
+        }
+        auto acks  = std::move(_acks);
+        _acks      = {};
+        auto state = make_fan_in<long long>(std::forward<Func>(func));
+        state->hold(acks.size());
+        for (const auto &job : acks) {
+            _redis.lrem(
+                [state](auto &&reply) {
+                    if (!state->failed(reply))
+                        state->reply.result() += reply.result();
+                    state->done();
+                },
+                _processing, -1, job);
+        }
+        state->done();
+        return *this;
+    }
+
+    /**
+     * @brief Registers the worker and refreshes its lease
+     *
+     * Must be called more often than the lease duration, or sweep() from
+     * another worker requeues the jobs being processed.
+     *
+     * @return status of the lease update
+     */
+    status
+    heartbeat() {
+        return sync_result<status>([this](auto &&func) { heartbeat(func); });
+    }
+
+    /**
+     * @brief Registers the worker and refreshes its lease asynchronously
+     * @param func Callback receiving the status of the lease update
+     * @return Reference to the queue for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<status> &&>, work_queue &>
+    heartbeat(Func &&func) {
+        auto state = make_fan_in<status>(std::forward<Func>(func));
+        state->hold(2);
+        _redis.sadd(
+            [state](auto &&reply) {
+                state->failed(reply);
+                state->done();
+            },
+            _workers, _worker);
+        _redis.set(
+            [state](auto &&reply) {
+                if (!state->failed(reply))
+                    state->reply.result() = std::move(reply.result());
+                state->done();
+            },
+            alive_key(_worker), "1", static_cast<long long>(_opts.lease.count()));
+        state->done();
+        return *this;
+    }
+
+    /**
+     * @brief Requeues the jobs of the workers whose lease expired
+     * @return Number of jobs requeued
+     */
+    long long
+    sweep() {
+        return sync_result<long long>([this](auto &&func) { sweep(func); });
+    }
+
+    /**
+     * @brief Requeues the jobs of the workers whose lease expired asynchronously
+     *
+     * Takes three round trips: the registered workers, their lease and the
+     * length of their processing list, then the pipelined LMOVE moving their
+     * jobs back to the queue. Expired workers are unregistered.
+     *
+     * @param func Callback receiving the number of jobs requeued
+     * @return Reference to the queue for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, work_queue &>
+    sweep(Func &&func) {
+        _redis.smembers(
+            [this, func = std::forward<Func>(func)](auto &&reply) mutable {
+                if (!reply.ok()) {
+                    std::move(func)(Reply<long long>{false, 0, std::move(reply.raw()),
+                                                     reply.error()});
+                    return;
+                }
+                survey found;
+                for (const auto &worker : reply.result()) {
+                    if (worker != _worker)
+                        found.workers.push_back(worker);
+                }
+                const auto count = found.workers.size();
+                if (!count) {
+                    std::move(func)(Reply<long long>{true, 0, {}, {}});
+                    return;
+                }
+                found.alive.resize(count, 1);
+                found.sizes.resize(count, 0);
+
+                auto state = make_fan_in<survey>(
+                    [this, func = std::move(func)](auto &&result) mutable {
+                        recover(std::move(result), std::move(func));
+                    },
+                    std::move(found));
+                state->hold(2 * count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto &worker = state->reply.result().workers[i];
+                    _redis.exists(
+                        [state, i](auto &&alive) {
+                            if (!state->failed(alive))
+                                state->reply.result().alive[i] = alive.result();
+                            state->done();
+                        },
+                        alive_key(worker));
+                    _redis.llen(
+                        [state, i](auto &&size) {
+                            if (!state->failed(size))
+                                state->reply.result().sizes[i] = size.result();
+                            state->done();
+                        },
+                        processing_key(worker));
+                }
+                state->done();
+            },
+            _workers);
+        return *this;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_WORK_QUEUE_H
@@ -0,0 +1,443 @@
+/*
+ * qb - C++ Actor Framework
+ * Copyright (C) 2011-2025 isndev (cpp.actor). All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ *         limitations under the License.
+ */
+
+#ifndef QBM_REDIS_WRITE_BUFFER_H
+#define QBM_REDIS_WRITE_BUFFER_H
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "redis.h"
+
+namespace qb::redis {
+
+/**
+ * @class write_buffer
+ * @brief Last-write-wins buffer coalescing SET, HSET and EXPIRE
+ *
+ * Writes only keep the latest value of a key or hash field locally. flush()
+ * sends what is left as pipelined commands: one MSET per batch_size keys,
+ * SET PX for the keys written with a time to live, one HSET per hash, and
+ * PEXPIRE for the expirations not merged in a SET. An expiration is sent
+ * before the HSETs, unless it was buffered after an HSET of its key, so that
+ * it applies to the same key as it would have unbuffered. A key overwritten
+ * ten times between two flushes is written once.
+ *
+ * get() and hget() return the pending values without a round trip, and read
+ * through the client otherwise. A key is expected to be either a string or a
+ * hash: set() drops the pending fields of a hash with the same key.
+ *
+ * The buffer is not thread safe and must be used on the event loop thread of
+ * its client. Pending writes are lost if the process dies before a flush.
+ *
+ * @tparam QB_IO_ The QB I/O type of the client
+ */
+template <typename QB_IO_>
+class write_buffer {
+public:
+    using client_type = detail::Redis<QB_IO_>;
+    using clock       = std::chrono::steady_clock;
+
+    /**
+     * @struct options
+     * @brief Flush policy of a write buffer
+     */
+    struct options {
+        std::chrono::milliseconds interval{50};         ///< Max delay of a write
+        std::size_t               max_bytes  = 1 << 20; ///< Budget forcing a flush
+        std::size_t               batch_size = 1000;    ///< Keys per MSET
+    };
+
+private:
+    using field_map = qb::unordered_map<std::string, std::string>;
+
+    struct entry {
+        std::optional<std::string> value;
+        std::optional<long long>   ttl;                ///< Milliseconds, if any
+        bool                       after_hash = false; ///< Expires a pending hash
+    };
+
+    client_type                              &_redis;
+    options                                   _opts;
+    qb::unordered_map<std::string, entry>     _strings;
+    qb::unordered_map<std::string, field_map> _hashes;
+    std::size_t                               _bytes      = 0;
+    clock::time_point                         _last_flush = clock::now();
+    std::shared_ptr<bool>                     _timer;
+
+    void
+    replace(std::string &slot, std::string value) {
+        _bytes = _bytes - slot.size() + value.size();
+        slot   = std::move(value);
+    }
+
+    entry &
+    string_entry(const std::string &key) {
+        auto [it, inserted] = _strings.try_emplace(key);
+        if (inserted)
+            _bytes += key.size();
+        return it->second;
+    }
+
+    void
+    drop_hash(const std::string &key) {
+        auto it = _hashes.find(key);
+        if (it == _hashes.end())
+            return;
+        _bytes -= key.size();
+        for (const auto &[field, value] : it->second)
+            _bytes -= field.size() + value.size();
+        _hashes.erase(it);
+    }
+
+    /**
+     * @brief Checks whether a pending expiration deletes the key
+     */
+    [[nodiscard]] bool
+    deleted(const std::string &key) const {
+        auto it = _strings.find(key);
+        return it != _strings.end() && !it->second.value && *it->second.ttl <= 0 &&
+               _hashes.find(key) == _hashes.end();
+    }
+
+    void
+    store(const std::string &key, std::string value, std::optional<long long> ttl) {
+        drop_hash(key);
+        auto &e = string_entry(key);
+        if (!e.value)
+            e.value.emplace();
+        replace(*e.value, std::move(value));
+        e.ttl = ttl;
+        written();
+    }
+
+    void
+    written() {
+        if (_bytes >= _opts.max_bytes)
+            flush(no_check);
+    }
+
+public:
+    /**
+     * @brief Constructs a write buffer
+     * @param redis Client used to send the writes and the reads through
+     * @param opts Flush policy
+     */
+    explicit write_buffer(client_type &redis, options opts = {})
+        : _redis(redis)
+        , _opts(opts) {
+        if (!_opts.batch_size)
+            throw std::invalid_argument("write_buffer: batch_size must be positive");
+    }
+
+    write_buffer(const write_buffer &) = delete;
+    write_buffer &operator=(const write_buffer &) = delete;
+
+    ~write_buffer() {
+        stop();
+    }
+
+    /**
+     * @brief Buffers a SET
+     * @param key Key to set
+     * @param value Value of the key
+     * @return Reference to the buffer for chaining
+     */
+    write_buffer &
+    set(const std::string &key, std::string value) {
+        store(key, std::move(value), std::nullopt);
+        return *this;
+    }
+
+    /**
+     * @brief Buffers a SET with a time to live
+     * @param key Key to set
+     * @param value Value of the key
+     * @param ttl Time to live
+     * @return Reference to the buffer for chaining
+     */
+    write_buffer &
+    set(const std::string &key, std::string value, std::chrono::milliseconds ttl) {
+        store(key, std::move(value), ttl.count());
+        return *this;
+    }
+
+    /**
+     * @brief Buffers an HSET of one field
+     * @param key Key of the hash
+     * @param field Field to set
+     * @param value Value of the field
+     * @return Reference to the buffer for chaining
+     */
+    write_buffer &
+    hset(const std::string &key, const std::string &field, std::string value) {
+        auto [hash, new_hash] = _hashes.try_emplace(key);
+        if (new_hash)
+            _bytes += key.size();
+        auto [it, inserted] = hash->second.try_emplace(field);
+        if (inserted)
+            _bytes += field.size();
+        replace(it->second, std::move(value));
+        written();
+        return *this;
+    }
+
+    /**
+     * @brief Buffers an expiration
+     *
+     * Merged in the SET of the key if one is pending, sent as PEXPIRE
+     * otherwise: after the HSET of the key if one is pending, before it if the
+     * key is written by a later hset(). A zero or negative time to live deletes
+     * the key: its pending writes are dropped and PEXPIRE removes the stored one.
+     *
+     * @param key Key to expire
+     * @param ttl Time to live
+     * @return Reference to the buffer for chaining
+     */
+    write_buffer &
+    expire(const std::string &key, std::chrono::milliseconds ttl) {
+        auto &e = string_entry(key);
+        e.ttl   = ttl.count();
+        if (*e.ttl <= 0) {
+            drop_hash(key);
+            if (e.value) {
+                _bytes -= e.value->size();
+                e.value.reset();
+            }
+        }
+        e.after_hash = _hashes.find(key) != _hashes.end();
+        written();
+        return *this;
+    }
+
+    /**
+     * @brief Gets a value, from the pending writes or from the server
+     * @param key Key to get
+     * @return The value, nullopt if the key does not exist
+     */
+    std::optional<std::string>
+    get(const std::string &key) {
+        auto it = _strings.find(key);
+        if (it != _strings.end() && it->second.value)
+            return it->second.value;
+        if (deleted(key))
+            return std::nullopt;
+        return _redis.get(key);
+    }
+
+    /**
+     * @brief Gets a value asynchronously, from the pending writes or from the server
+     *
+     * A pending value is passed to the callback before returning.
+     *
+     * @param func Callback receiving the value
+     * @param key Key to get
+     * @return Reference to the buffer for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<std::string>> &&>,
+                     write_buffer &>
+    get(Func &&func, const std::string &key) {
+        auto it = _strings.find(key);
+        if (it != _strings.end() && it->second.value)
+            std::forward<Func>(func)(
+                Reply<std::optional<std::string>>{true, it->second.value, {}, {}});
+        else if (deleted(key))
+            std::forward<Func>(func)(
+                Reply<std::optional<std::string>>{true, std::nullopt, {}, {}});
+        else
+            _redis.get(std::forward<Func>(func), key);
+        return *this;
+    }
+
+    /**
+     * @brief Gets a hash field, from the pending writes or from the server
+     * @param key Key of the hash
+     * @param field Field to get
+     * @return The value, nullopt if the field does not exist
+     */
+    std::optional<std::string>
+    hget(const std::string &key, const std::string &field) {
+        if (auto value = pending_field(key, field))
+            return *value;
+        if (deleted(key))
+            return std::nullopt;
+        return _redis.hget(key, field);
+    }
+
+    /**
+     * @brief Gets a hash field asynchronously, from the pending writes or from the
+     * server
+     * @param func Callback receiving the value
+     * @param key Key of the hash
+     * @param field Field to get
+     * @return Reference to the buffer for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<std::optional<std::string>> &&>,
+                     write_buffer &>
+    hget(Func &&func, const std::string &key, const std::string &field) {
+        if (auto value = pending_field(key, field))
+            std::forward<Func>(func)(
+                Reply<std::optional<std::string>>{true, *value, {}, {}});
+        else if (deleted(key))
+            std::forward<Func>(func)(
+                Reply<std::optional<std::string>>{true, std::nullopt, {}, {}});
+        else
+            _redis.hget(std::forward<Func>(func), key, field);
+        return *this;
+    }
+
+    /**
+     * @brief Gets the pending value of a hash field
+     * @return Pointer to the value, nullptr if none is pending
+     */
+    [[nodiscard]] const std::string *
+    pending_field(const std::string &key, const std::string &field) const {
+        auto hash = _hashes.find(key);
+        if (hash == _hashes.end())
+            return nullptr;
+        auto it = hash->second.find(field);
+        return it == hash->second.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Gets the approximate memory held by the pending writes, in bytes
+     */
+    [[nodiscard]] std::size_t
+    bytes() const {
+        return _bytes;
+    }
+
+    /**
+     * @brief Checks whether writes are pending
+     */
+    [[nodiscard]] bool
+    empty() const {
+        return _strings.empty() && _hashes.empty();
+    }
+
+    /**
+     * @brief Flushes the pending writes if the interval elapsed
+     * @return true if a flush was started
+     */
+    bool
+    poll() {
+        if (empty() || clock::now() - _last_flush < _opts.interval)
+            return false;
+        flush(no_check);
+        return true;
+    }
+
+    /**
+     * @brief Starts a timer calling poll() every interval
+     */
+    void
+    start() {
+        stop();
+        _timer = std::make_shared<bool>(true);
+        call_every(_timer, std::chrono::duration<double>(_opts.interval).count(),
+                   [this]() { poll(); });
+    }
+
+    /**
+     * @brief Stops the timer started by start()
+     */
+    void
+    stop() {
+        if (_timer) {
+            *_timer = false;
+            _timer.reset();
+        }
+    }
+
+    /**
+     * @brief Flushes the pending writes and waits for the replies
+     * @return Number of commands sent
+     */
+    long long
+    flush() {
+        return sync_result<long long>([this](auto &&func) { flush(func); });
+    }
+
+    /**
+     * @brief Flushes the pending writes as pipelined commands
+     * @param func Callback receiving the number of commands sent
+     * @return Reference to the buffer for chaining
+     */
+    template <typename Func>
+    std::enable_if_t<std::is_invocable_v<Func, Reply<long long> &&>, write_buffer &>
+    flush(Func &&func) {
+        auto strings = std::move(_strings);
+        auto hashes  = std::move(_hashes);
+        _strings     = {};
+        _hashes      = {};
+        _bytes       = 0;
+        _last_flush  = clock::now();
+
+        auto state    = make_fan_in<long long>(std::forward<Func>(func));
+        auto on_reply = [state]() {
+            state->hold();
+            ++state->reply.result();
+            return [state](auto &&reply) {
+                state->failed(reply);
+                state->done();
+            };
+        };
+
+        std::vector<std::pair<std::string, std::string>> values;
+        std::vector<std::pair<std::string, long long>>   expirations;
+        for (auto &[key, e] : strings) {
+            if (!e.value) {
+                if (e.after_hash)
+                    expirations.emplace_back(key, *e.ttl);
+                else
+                    _redis.pexpire(on_reply(), key, *e.ttl);
+            } else if (e.ttl) {
+                _redis.set(on_reply(), key, *e.value, *e.ttl);
+            } else {
+                values.emplace_back(key, std::move(*e.value));
+                if (values.size() == _opts.batch_size) {
+                    _redis.mset(on_reply(), values);
+                    values.clear();
+                }
+            }
+        }
+        if (!values.empty())
+            _redis.mset(on_reply(), values);
+
+        std::vector<std::pair<std::string, std::string>> fields;
+        for (auto &[key, hash] : hashes) {
+            fields.clear();
+            for (auto &[field, value] : hash)
+                fields.emplace_back(field, std::move(value));
+            _redis.template command<long long>(on_reply(), "HSET", key, fields);
+        }
+        for (const auto &[key, ttl] : expirations)
+            _redis.pexpire(on_reply(), key, ttl);
+
+        state->done();
+        return *this;
+    }
+};
+
+} // namespace qb::redis
+
+#endif // QBM_REDIS_WRITE_BUFFER_H